@@ -0,0 +1,74 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace avz::benchmarks
+{
+
+/**
+ * @brief FFT sizes produced by the example programs
+ *
+ * Computed exactly like the examples do (window duration * sample rate) for the
+ * default 0.25s window, including the shorter windows of each BassNationSpectrumLayer,
+ * at the two most common sample rates.
+ */
+inline std::vector<int> example_fft_sizes()
+{
+	std::vector<int> sizes;
+	for (const int sample_rate_hz : {44100, 48000})
+	{
+		const auto audio_duration_sec = 0.25f;
+		const auto delta_duration = 0.015f;
+		const auto max_duration_diff = 8 * delta_duration;
+		for (int i = 0; i < 9; ++i)
+		{
+			const auto new_duration_sec = audio_duration_sec - (max_duration_diff - i * delta_duration);
+			sizes.emplace_back(new_duration_sec * sample_rate_hz);
+		}
+	}
+	std::ranges::sort(sizes);
+	const auto [first, last] = std::ranges::unique(sizes);
+	sizes.erase(first, last);
+	return sizes;
+}
+
+/**
+ * @brief Average wall-clock time of one call to `fn`, in microseconds
+ */
+template <typename F>
+double time_us(const int iterations, F &&fn)
+{
+	// warm up caches and lazily-initialized state
+	fn();
+	const auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; ++i)
+		fn();
+	const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count() / iterations;
+}
+
+/**
+ * @brief Fill `out` with deterministic white noise in [-1, 1]
+ */
+inline void fill_noise(std::span<float> out, const unsigned seed = 1)
+{
+	std::mt19937 rng{seed};
+	std::uniform_real_distribution<float> dist{-1, 1};
+	std::ranges::generate(out, [&] { return dist(rng); });
+}
+
+/**
+ * @brief Parse the optional iteration count passed as the first argument
+ */
+inline int parse_iterations(const int argc, const char *const *argv, const int default_iterations)
+{
+	return argc > 1 ? std::max(1, std::atoi(argv[1])) : default_iterations;
+}
+
+} // namespace avz::benchmarks
@@ -0,0 +1,212 @@
+// Compares the bass-nation example's spectrum layers declared on a shared AnalysisGraph against each layer
+// running its own decimator and analyzers, and verifies that the graph merges the shared nodes and produces
+// the same spectra, single-threaded and multi-threaded, and that a decimator reads the start of a channel window
+// extended by a longer consumer. Exits with failure if it doesn't.
+// usage: analysis-graph [iterations]
+#include "BenchmarkFramework.hpp"
+#include <avz/analysis.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <print>
+
+using namespace avz::benchmarks;
+
+namespace
+{
+
+constexpr int bars = 960, frame_rate = 60, frames = 32;
+constexpr float start_freq = 20, end_freq = 135;
+
+// what every layer computed for itself before the graph
+struct Layer
+{
+	int channel;
+	avz::Decimator dec;
+	avz::FrequencyAnalyzer fa;
+	avz::AudioAnalyzer aa;
+	avz::SpectrumResamplePlan rp;
+	std::vector<float> s = std::vector<float>(bars);
+
+	Layer(const int fft_size, const int sample_rate_hz, const int channel)
+		: channel{channel},
+		  dec{avz::Decimator::factor_for(sample_rate_hz, 2000),
+			  fft_size / avz::Decimator::factor_for(sample_rate_hz, 2000)},
+		  fa{dec.get_window_size(), avz::FrequencyAnalyzer::SizePolicy::Smooth}
+	{
+		fa.set_window_func(avz::FrequencyAnalyzer::WindowFunction::Blackman);
+	}
+
+	void compute(const std::span<const float> audio, const int hop, const int sample_rate_hz)
+	{
+		dec.update(audio, hop, 2, channel);
+		aa.execute_fft(fa, dec.window());
+		aa.compute_amplitudes(fa);
+		avz::util::resample_spectrum(
+			s,
+			aa.get_amplitudes(),
+			dec.output_sample_rate(sample_rate_hz),
+			fa.get_transform_size(),
+			start_freq,
+			end_freq,
+			rp);
+	}
+};
+
+// the example's layer sizes: 9 window durations, each analyzed on both channels
+std::vector<int> layer_fft_sizes(const int sample_rate_hz)
+{
+	std::vector<int> sizes;
+	for (int i = 0; i < 9; ++i)
+		sizes.emplace_back((0.25f - (8 - i) * 0.015f) * sample_rate_hz);
+	return sizes;
+}
+
+std::vector<avz::AnalysisGraph::Handle<avz::AnalysisGraph::Resampled>>
+declare_layers(avz::AnalysisGraph &graph, const int sample_rate_hz)
+{
+	const auto factor = avz::Decimator::factor_for(sample_rate_hz, 2000);
+	std::vector<avz::AnalysisGraph::Handle<avz::AnalysisGraph::Resampled>> outputs;
+	for (const auto fft_size : layer_fft_sizes(sample_rate_hz))
+		for (const int channel : {0, 1})
+		{
+			const auto decimated = graph.decimate(graph.channel(channel), factor);
+			const auto spectrum = graph.fft(
+				decimated,
+				fft_size / factor,
+				avz::FrequencyAnalyzer::WindowFunction::Blackman,
+				avz::FrequencyAnalyzer::SizePolicy::Smooth);
+			outputs.emplace_back(graph.resample(graph.amplitudes(spectrum), bars, start_freq, end_freq));
+		}
+	return outputs;
+}
+
+} // namespace
+
+int main(const int argc, const char *const *const argv)
+{
+	const auto iterations = parse_iterations(argc, argv, 200);
+	constexpr auto tolerance = 1e-5f;
+	bool ok{true};
+
+	// exercise the workers even on machines with few cores
+	avz::JobSystem jobs{std::max(4, avz::JobSystem::instance().get_thread_count())};
+
+	std::println(
+		"{:>8}{:>8}{:>8}{:>12}{:>14}{:>14}{:>12}",
+		"rate",
+		"layers",
+		"nodes",
+		"layers_us",
+		"graph_1t_us",
+		"graph_mt_us",
+		"rel_error");
+
+	for (const int sample_rate_hz : {44100, 48000})
+	{
+		const auto hop = sample_rate_hz / frame_rate;
+		const auto sizes = layer_fft_sizes(sample_rate_hz);
+		const auto window = std::ranges::max(sizes);
+
+		// stereo audio long enough to slide the window forward `frames` times
+		std::vector<float> audio(2 * (window + frames * hop));
+		fill_noise(audio);
+		const auto frame_audio = [&](const int frame) { return std::span{audio}.subspan(2 * (frame % frames) * hop); };
+
+		std::vector<Layer> layers;
+		for (const auto fft_size : sizes)
+			for (const int channel : {0, 1})
+				layers.emplace_back(fft_size, sample_rate_hz, channel);
+
+		avz::AnalysisGraph single{(float)sample_rate_hz, 2}, multi{(float)sample_rate_hz, 2};
+		single.set_job_system(nullptr);
+		multi.set_job_system(&jobs);
+		const auto single_outputs = declare_layers(single, sample_rate_hz);
+		const auto multi_outputs = declare_layers(multi, sample_rate_hz);
+
+		// 2 channels and 2 decimators are shared; every layer keeps its own fft, amplitudes, and resample
+		const auto expected_nodes = 2 + 2 + 3 * (int)layers.size();
+		ok &= single.get_node_count() == expected_nodes;
+		single.compile();
+		ok &= single.get_input_frames() <= window;
+
+		float max_error{}, max_amp{};
+		for (int frame = 0; frame < frames; ++frame)
+		{
+			for (auto &layer : layers)
+				layer.compute(frame_audio(frame), hop, sample_rate_hz);
+			single.run(frame_audio(frame), hop);
+			multi.run(frame_audio(frame), hop);
+
+			for (size_t i = 0; i < layers.size(); ++i)
+			{
+				const auto a = single.get(single_outputs[i]);
+				const auto b = multi.get(multi_outputs[i]);
+				for (int k = 0; k < bars; ++k)
+				{
+					const auto expected = layers[i].s[k];
+					max_error = std::max({max_error, std::abs(a[k] - expected), std::abs(b[k] - expected)});
+					max_amp = std::max(max_amp, std::abs(expected));
+				}
+			}
+		}
+		const auto error = max_error / max_amp;
+		ok &= error <= tolerance;
+
+		int frame{};
+		const auto layers_us = time_us(
+			iterations,
+			[&]
+			{
+				for (auto &layer : layers)
+					layer.compute(frame_audio(frame), hop, sample_rate_hz);
+				++frame;
+			});
+		const auto single_us = time_us(iterations, [&] { single.run(frame_audio(frame++), hop); });
+		const auto multi_us = time_us(iterations, [&] { multi.run(frame_audio(frame++), hop); });
+
+		std::println(
+			"{:>8}{:>8}{:>8}{:>12.2f}{:>14.2f}{:>14.2f}{:>12.2e}{}",
+			sample_rate_hz,
+			layers.size(),
+			single.get_node_count(),
+			layers_us,
+			single_us,
+			multi_us,
+			error,
+			error <= tolerance && single.get_node_count() == expected_nodes ? "" : "  MISMATCH");
+	}
+
+	// a decimator reads the start of its channel's window, even when a longer fft of the same channel extends it
+	{
+		constexpr int sample_rate_hz = 48000, hop = sample_rate_hz / frame_rate;
+		const auto factor = avz::Decimator::factor_for(sample_rate_hz, 2000);
+		constexpr int dec_window = 100, fft_size = 12000;
+
+		std::vector<float> audio(2 * (fft_size + frames * hop));
+		fill_noise(audio);
+
+		avz::AnalysisGraph graph{(float)sample_rate_hz, 2};
+		graph.set_job_system(nullptr);
+		const auto channel = graph.channel(0);
+		const auto decimated = graph.decimate(channel, factor, dec_window);
+		graph.fft(channel, fft_size);
+		avz::Decimator dec{factor, dec_window};
+
+		float max_error{};
+		for (int frame = 0; frame < frames; ++frame)
+		{
+			const auto frame_audio = std::span{audio}.subspan(2 * frame * hop);
+			graph.run(frame_audio, hop);
+			dec.update(frame_audio, hop, 2, 0);
+			const auto a = graph.get(decimated), b = dec.window();
+			for (int i = 0; i < dec_window; ++i)
+				max_error = std::max(max_error, std::abs(a[i] - b[i]));
+		}
+		const auto aligned = graph.get_input_frames() == fft_size && max_error <= tolerance;
+		ok &= aligned;
+		std::println("decimator under a longer channel window: {}", aligned ? "ok" : "MISMATCH");
+	}
+
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,192 @@
+// Times one frame of BandEnvelopeAnalyzer (filtering a 60 fps hop through the particle examples' bass bands) for a
+// few filter orders, and verifies the filters and envelope followers: tones swept across the spectrum must find
+// every band's -3 dB edges where the band says and unit gain inside, and steps must rise and fall with the
+// configured attack and release times. Exits with failure if any is off.
+// usage: band-envelope [iterations]
+#include "BenchmarkFramework.hpp"
+#include <avz/analysis.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <print>
+
+using namespace avz::benchmarks;
+using Band = avz::BandEnvelopeAnalyzer::Band;
+
+namespace
+{
+
+// not a multiple of the band edges, so sampled tones don't keep missing their peaks
+constexpr float sample_rate_hz = 44100;
+constexpr int hop = sample_rate_hz / 60;
+
+// the particle examples' bass bands, and two wider ones
+constexpr Band bands[]{{0, 83}, {83, 166}, {166, 250}, {250, 2000}, {2000, 8000}};
+constexpr int num_bands = std::size(bands);
+
+// a few octaves either side of the bands, 48 tones per octave
+constexpr float sweep_from_hz = 20, sweep_to_hz = 16000, tones_per_octave = 48;
+
+constexpr auto half_power_db = -3.0103f;
+
+float to_db(const float gain)
+{
+	return 20 * log10f(gain);
+}
+
+// steady-state gain of every band for a unit tone, read from the envelopes: attack is instant and release is
+// (practically) never once the filters have settled, so each envelope holds its band's peak output
+std::vector<float> tone_gains(const int sections, const float freq_hz)
+{
+	avz::BandEnvelopeAnalyzer bea{sample_rate_hz, bands, sections};
+	std::vector<float> tone(sample_rate_hz * 0.4f);
+	for (size_t i = 0; i < tone.size(); ++i)
+		tone[i] = sinf(2 * M_PI * freq_hz * i / sample_rate_hz);
+
+	const auto settled = std::span{tone}.first(sample_rate_hz * 0.3f);
+	const auto measured = std::span{tone}.subspan(settled.size());
+	bea.push(settled);
+	// forget the peaks of the filters' transients
+	bea.set_attack_release(0, 0);
+	bea.push(measured.first(1));
+	bea.set_attack_release(0, 1e4f);
+	bea.push(measured.subspan(1));
+
+	const auto envelopes = bea.get_envelopes();
+	return {envelopes.begin(), envelopes.end()};
+}
+
+// where the response crosses `half_power_db`, interpolated linearly in dB over log frequency
+float crossing_hz(const float from_hz, const float from_db, const float to_hz, const float to_db)
+{
+	const auto t = (half_power_db - from_db) / (to_db - from_db);
+	return from_hz * powf(to_hz / from_hz, t);
+}
+
+// seconds for a unit step to take the envelope `fraction` of the way from where it was to where it's going
+float step_time(avz::BandEnvelopeAnalyzer &bea, const float level, const float fraction)
+{
+	const auto from = bea.get_envelopes()[0];
+	const auto target = from + fraction * (level - from);
+	const float sample[]{level};
+	for (int n = 1; n < sample_rate_hz * 10; ++n)
+	{
+		bea.push(sample);
+		const auto env = bea.get_envelopes()[0];
+		if (level > from ? env >= target : env <= target)
+			return n / sample_rate_hz;
+	}
+	return INFINITY;
+}
+
+} // namespace
+
+int main(const int argc, const char *const *const argv)
+{
+	const auto iterations = parse_iterations(argc, argv, 10000);
+	bool ok{true};
+
+	std::vector<float> audio(hop * (iterations + 1));
+	fill_noise(audio);
+
+	std::println("{:>10}{:>8}{:>10}", "sections", "hop", "push_us");
+	for (const int sections : {1, 2, 3})
+	{
+		avz::BandEnvelopeAnalyzer bea{sample_rate_hz, std::span{bands}.first(3), sections};
+		int frame{};
+		const auto push_us = time_us(iterations, [&] { bea.push(std::span{audio}.subspan(frame++ * hop, hop)); });
+		std::println("{:>10}{:>8}{:>10.2f}", sections, hop, push_us);
+	}
+
+	// the edges are prewarped, so they hold to float precision: the bound is mostly the sweep's interpolation
+	constexpr auto edge_tolerance = 0.005f, peak_tolerance_db = 0.05f;
+
+	const int num_tones = tones_per_octave * log2f(sweep_to_hz / sweep_from_hz) + 1;
+	std::vector<float> sweep_hz(num_tones);
+	for (int t = 0; t < num_tones; ++t)
+		sweep_hz[t] = sweep_from_hz * exp2f(t / tones_per_octave);
+
+	std::println(
+		"{:>10}{:>12}{:>12}{:>12}{:>12}{:>12}{:>10}",
+		"sections",
+		"band_from",
+		"band_to",
+		"from_hz",
+		"to_hz",
+		"peak_db",
+		"status");
+	for (const int sections : {1, 2, 3})
+	{
+		// gains_db[t * num_bands + j]: band j's response to tone t
+		std::vector<float> gains_db(num_tones * num_bands);
+		for (int t = 0; t < num_tones; ++t)
+			std::ranges::transform(tone_gains(sections, sweep_hz[t]), gains_db.begin() + t * num_bands, to_db);
+
+		for (int j = 0; j < num_bands; ++j)
+		{
+			const auto db = [&](const int t) { return gains_db[t * num_bands + j]; };
+
+			// the first tone to rise above half power and the last to fall below it, measured from the band's peak
+			// so the filter's own crossings are used rather than stray ones in the stopband
+			int peak{};
+			for (int t = 1; t < num_tones; ++t)
+				if (db(t) > db(peak))
+					peak = t;
+			auto lo = peak, hi = peak;
+			while (lo > 0 && db(lo - 1) >= half_power_db)
+				--lo;
+			while (hi + 1 < num_tones && db(hi + 1) >= half_power_db)
+				++hi;
+
+			// a lowpass band has no lower edge, and passes everything down to the sweep's first tone
+			const auto from_hz = lo ? crossing_hz(sweep_hz[lo - 1], db(lo - 1), sweep_hz[lo], db(lo)) : 0;
+			const auto to_hz = hi + 1 < num_tones ? crossing_hz(sweep_hz[hi], db(hi), sweep_hz[hi + 1], db(hi + 1)) : 0;
+
+			const auto [expected_from_hz, expected_to_hz] = bands[j];
+			const auto near = [&](const float hz, const float expected_hz)
+			{ return expected_hz ? std::abs(hz / expected_hz - 1) <= edge_tolerance : !hz; };
+			const auto matches = near(from_hz, expected_from_hz) && near(to_hz, expected_to_hz) &&
+								 std::abs(db(peak)) <= peak_tolerance_db;
+			ok &= matches;
+			std::println(
+				"{:>10}{:>12}{:>12}{:>12.2f}{:>12.2f}{:>12.3f}{:>10}",
+				sections,
+				expected_from_hz,
+				expected_to_hz,
+				from_hz,
+				to_hz,
+				db(peak),
+				matches ? "ok" : "MISMATCH");
+		}
+	}
+
+	// steps through a lowpass wide enough to pass them almost untouched, so the follower sees a clean edge: after
+	// one time constant it must be ~63% of the way there
+	std::println("{:>10}{:>10}{:>12}{:>12}{:>10}", "attack_s", "release_s", "rise_s", "fall_s", "status");
+	constexpr auto time_constant = 1 - 1 / (float)M_E, time_tolerance = 0.01f;
+	const std::pair<float, float> times[]{{0.005f, 0.15f}, {0.02f, 0.5f}, {0.1f, 0.05f}};
+	for (const auto &[attack_sec, release_sec] : times)
+	{
+		const Band wide[]{{0, 20000}};
+		avz::BandEnvelopeAnalyzer bea{sample_rate_hz, wide};
+		bea.set_attack_release(attack_sec, release_sec);
+
+		const auto rise_sec = step_time(bea, 1, time_constant);
+		// let it reach the top before releasing
+		bea.push(std::vector<float>(sample_rate_hz * attack_sec * 20, 1));
+		const auto fall_sec = step_time(bea, 0, time_constant);
+
+		const auto matches = std::abs(rise_sec / attack_sec - 1) <= time_tolerance &&
+							 std::abs(fall_sec / release_sec - 1) <= time_tolerance;
+		ok &= matches;
+		std::println(
+			"{:>10.3f}{:>10.3f}{:>12.4f}{:>12.4f}{:>10}",
+			attack_sec,
+			release_sec,
+			rise_sec,
+			fall_sec,
+			matches ? "ok" : "MISMATCH");
+	}
+
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,213 @@
+// Times BinPacker's shared BinPlans against packing the way BinPacker used to, building the mapping from the
+// scale every frame, and verifies that both give the same output for every scale and accumulation method, the
+// example programs' spectrum sizes and a few output sizes, with one BinPacker following every size change.
+// Exits with failure if they don't.
+// usage: bin-pack [iterations]
+#include "BenchmarkFramework.hpp"
+#include <avz/analysis.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <print>
+
+using namespace avz::benchmarks;
+using Scale = avz::BinPacker::Scale;
+using AccumulationMethod = avz::BinPacker::AccumulationMethod;
+
+namespace
+{
+
+constexpr float sample_rate_hz = 48000;
+
+struct Settings
+{
+	Scale scale;
+	int nth_root;
+	AccumulationMethod am;
+};
+
+float hz_to_mel(const float hz)
+{
+	return 2595 * log10f(1 + hz / 700);
+}
+
+float hz_to_bark(const float hz)
+{
+	return 26.81f * hz / (1960 + hz) - 0.53f;
+}
+
+// the pre-BinPlan BinPacker: every input bin's output index from the scale, then a scan over each output bin's
+// run of input bins. the mapping is rebuilt on every call, so it can't go stale. the index is computed like
+// BinPlan does, in double and nudged up: in float, bins exactly on an output bin's edge went either way depending
+// on how -ffast-math rounded the division.
+void pack_index_scale(const Settings &s, const std::span<float> out, const std::span<const float> in)
+{
+	const auto out_size = out.size(), in_size = in.size();
+	const auto ratio = [&](const double i) -> double
+	{
+		switch (s.scale)
+		{
+		case Scale::LOG:
+			return std::log(i ? i : 1) / std::log(in_size);
+		case Scale::NTH_ROOT:
+			switch (s.nth_root)
+			{
+			case 1:
+				return i / in_size;
+			case 2:
+				return std::sqrt(i) / std::sqrt(in_size);
+			case 3:
+				return std::cbrt(i) / std::cbrt(in_size);
+			default:
+				return std::pow(i, 1. / s.nth_root) / std::pow(in_size, 1. / s.nth_root);
+			}
+		default:
+			return i / in_size;
+		}
+	};
+
+	std::vector<std::pair<int, int>> mapping(out_size, {-1, -1});
+	for (size_t i = 0; i < in_size; ++i)
+	{
+		const auto out_index = std::clamp((size_t)(ratio(i) * out_size + 1e-9), (size_t)0, out_size - 1);
+		if (mapping[out_index].first == -1)
+			mapping[out_index].first = i;
+		mapping[out_index].second = i + 1;
+	}
+
+	std::ranges::fill(out, 0);
+	for (size_t i = 0; i < out_size; ++i)
+	{
+		const auto [start, end] = mapping[i];
+		if (start == -1)
+			continue;
+		float a{};
+		for (int j = start; j < end; ++j)
+			a = s.am == AccumulationMethod::SUM ? a + in[j] : std::max(a, in[j]);
+		out[i] = a;
+	}
+}
+
+// MEL and BARK had no per-frame version: weigh the bins inside each filter by its triangle, falling back to the
+// nearest bin for filters that no bin falls inside
+void pack_filterbank(const Settings &s, const std::span<float> out, const std::span<const float> in)
+{
+	const int out_size = out.size(), in_size = in.size();
+	const auto to_scale = s.scale == Scale::MEL ? hz_to_mel : hz_to_bark;
+	const auto nyquist = sample_rate_hz / 2;
+	const auto lo = to_scale(0), spacing = (to_scale(nyquist) - lo) / (out_size + 1);
+
+	std::vector<float> bin_pos(in_size);
+	for (int j = 0; j < in_size; ++j)
+		bin_pos[j] = to_scale(nyquist * j / (in_size - 1));
+
+	// filters move up monotonically, so the first bin past each filter's left edge only moves up too
+	int first{};
+	for (int i = 0; i < out_size; ++i)
+	{
+		const auto left = lo + i * spacing, center = left + spacing, right = center + spacing;
+		while (first < in_size && bin_pos[first] <= left)
+			++first;
+
+		float a{};
+		int j = first;
+		for (; j < in_size && bin_pos[j] < right; ++j)
+		{
+			const auto v = (1 - std::abs(bin_pos[j] - center) / spacing) * in[j];
+			a = s.am == AccumulationMethod::SUM ? a + v : std::max(a, v);
+		}
+
+		if (j == first)
+		{
+			// no bin inside: the nearest is one of the bins either side of the filter, ties going to the higher
+			auto nearest = std::min(first, in_size - 1);
+			if (nearest && (first == in_size || center - bin_pos[first - 1] < bin_pos[first] - center))
+				nearest = first - 1;
+			a = s.am == AccumulationMethod::SUM ? in[nearest] : std::max(0.f, in[nearest]);
+		}
+
+		out[i] = a;
+	}
+}
+
+void pack_per_frame(const Settings &s, const std::span<float> out, const std::span<const float> in)
+{
+	if (s.scale == Scale::MEL || s.scale == Scale::BARK)
+		pack_filterbank(s, out, in);
+	else
+		pack_index_scale(s, out, in);
+}
+
+} // namespace
+
+int main(const int argc, const char *const *const argv)
+{
+	const auto iterations = parse_iterations(argc, argv, 10000);
+	bool ok{true};
+
+	// whole-number amplitudes, so unweighted sums are exact in any order
+	const auto fft_sizes = example_fft_sizes();
+	std::vector<float> in(fft_sizes.back() / 2 + 1);
+	fill_noise(in);
+	for (auto &v : in)
+		v = std::round(std::abs(v) * 1000);
+
+	const std::pair<Settings, const char *> settings[]{
+		{{Scale::LINEAR, 0, AccumulationMethod::SUM}, "linear/sum"},
+		{{Scale::LINEAR, 0, AccumulationMethod::MAX}, "linear/max"},
+		{{Scale::LOG, 0, AccumulationMethod::SUM}, "log/sum"},
+		{{Scale::LOG, 0, AccumulationMethod::MAX}, "log/max"},
+		{{Scale::NTH_ROOT, 2, AccumulationMethod::SUM}, "sqrt/sum"},
+		{{Scale::NTH_ROOT, 3, AccumulationMethod::MAX}, "cbrt/max"},
+		{{Scale::NTH_ROOT, 5, AccumulationMethod::MAX}, "root5/max"},
+		{{Scale::MEL, 0, AccumulationMethod::SUM}, "mel/sum"},
+		{{Scale::MEL, 0, AccumulationMethod::MAX}, "mel/max"},
+		{{Scale::BARK, 0, AccumulationMethod::SUM}, "bark/sum"},
+		{{Scale::BARK, 0, AccumulationMethod::MAX}, "bark/max"}};
+
+	std::println("{:>12}{:>16}{:>10}{:>12}{:>10}", "settings", "per_frame_us", "plan_us", "rel_error", "status");
+	for (const auto &[s, name] : settings)
+	{
+		// filterbank sums are weighted, so only they depend on the order of the additions
+		const auto weighted_sum = (s.scale == Scale::MEL || s.scale == Scale::BARK) && s.am == AccumulationMethod::SUM;
+		const auto tolerance = weighted_sum ? 1e-6f : 0.f;
+
+		float error{};
+		double per_frame_us{}, plan_us{};
+		for (const int out_size : {1, 24, 200, 1000, 4000})
+		{
+			// one packer through every spectrum size, like an example whose window size changes
+			avz::BinPacker bp;
+			bp.set_scale(s.scale);
+			if (s.nth_root)
+				bp.set_nth_root(s.nth_root);
+			bp.set_accum_method(s.am);
+			bp.set_sample_rate(sample_rate_hz);
+
+			std::vector<float> expected(out_size), out(out_size);
+			for (const auto fft_size : fft_sizes)
+			{
+				const auto frame = std::span{in}.first(fft_size / 2 + 1);
+				pack_per_frame(s, expected, frame);
+				bp.bin_pack(out, frame);
+				for (int i = 0; i < out_size; ++i)
+					error = std::max(error, std::abs(out[i] - expected[i]) / std::max(1.f, expected[i]));
+			}
+
+			// the largest example spectrum onto a typical bar count
+			if (out_size == 200)
+			{
+				const auto frame = std::span{in}.first(fft_sizes.back() / 2 + 1);
+				per_frame_us = time_us(iterations, [&] { pack_per_frame(s, expected, frame); });
+				plan_us = time_us(iterations, [&] { bp.bin_pack(out, frame); });
+			}
+		}
+
+		const auto matches = error <= tolerance;
+		ok &= matches;
+		std::println(
+			"{:>12}{:>16.2f}{:>10.2f}{:>12.2e}{:>10}", name, per_frame_us, plan_us, error, matches ? "ok" : "MISMATCH");
+	}
+
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,92 @@
+// Times one frame of ConstantQAnalyzer (pushing a hop of new audio through the octave pyramid and computing
+// every bin) at the constant-q-spectrum example's settings, and verifies that a tone at any bin's center
+// frequency peaks at that bin with amplitude A / 2, both from a whole window and streamed a hop at a time.
+// Exits with failure if it doesn't.
+// usage: constant-q [iterations]
+#include "BenchmarkFramework.hpp"
+#include <avz/analysis.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <print>
+
+using namespace avz::benchmarks;
+
+namespace
+{
+
+constexpr float sample_rate_hz = 48000, amplitude = 0.5f;
+
+// 60 fps
+constexpr int hop = sample_rate_hz / 60;
+
+// whether the loudest bin is `bin`, at A / 2 give or take 1%
+bool peaks_at(const avz::ConstantQAnalyzer &cq, const int bin)
+{
+	const auto amps = cq.get_amplitudes();
+	return std::ranges::max_element(amps) - amps.begin() == bin && std::abs(amps[bin] / (amplitude / 2) - 1) < 0.01f;
+}
+
+} // namespace
+
+int main(const int argc, const char *const *const argv)
+{
+	const auto iterations = parse_iterations(argc, argv, 1000);
+	bool ok{true};
+
+	// 8 octaves of 24 bins from A0, like constant-q-spectrum
+	avz::ConstantQAnalyzer cq{sample_rate_hz, 27.5f, 8, 24};
+	const auto window = cq.get_input_window_size();
+
+	const auto tone = [&](const float freq_hz, const int length)
+	{
+		std::vector<float> out(length);
+		for (int i = 0; i < length; ++i)
+			out[i] = amplitude * sinf(2 * M_PI * freq_hz * i / sample_rate_hz + 0.3f);
+		return out;
+	};
+
+	std::println("{:>8}{:>8}{:>10}{:>12}", "bins", "fft", "window", "frame_us");
+	{
+		std::vector<float> audio(window + iterations * hop);
+		fill_noise(audio);
+		cq.update(std::span{audio}.first(window), window);
+		int frame{};
+		const auto frame_us = time_us(
+			iterations,
+			[&]
+			{
+				cq.update(std::span{audio}.subspan(++frame * hop, window), hop);
+				cq.compute_amplitudes();
+			});
+		std::println("{:>8}{:>8}{:>10}{:>12.2f}", cq.get_bin_count(), cq.get_fft_size(), window, frame_us);
+	}
+
+	// every bin, from a whole window
+	int misses{};
+	for (int bin = 0; bin < cq.get_bin_count(); ++bin)
+	{
+		cq.reset();
+		cq.update(tone(cq.get_bin_frequency(bin), window), window);
+		cq.compute_amplitudes();
+		misses += !peaks_at(cq, bin);
+	}
+	ok &= !misses;
+	std::println("tones from whole windows: {}", misses ? "FAILED" : "ok");
+
+	// the middle bin of every octave, streamed: the pyramid only sees a hop of new audio per frame
+	misses = 0;
+	for (int bin = 12; bin < cq.get_bin_count(); bin += 24)
+	{
+		const auto audio = tone(cq.get_bin_frequency(bin), window + 60 * hop);
+		cq.reset();
+		for (int frame = 0; frame <= 60; ++frame)
+			cq.update(std::span{audio}.subspan(frame * hop, window), hop);
+		cq.compute_amplitudes();
+		misses += !peaks_at(cq, bin);
+	}
+	ok &= !misses;
+	std::println("streamed tones: {}", misses ? "FAILED" : "ok");
+
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,120 @@
+// Times a real FFT on every compiled-in backend, for the FFT sizes the examples produce and the sizes
+// each FrequencyAnalyzer::SizePolicy pads them to, and reports the fastest backend per size.
+// Also verifies that every backend matches the first one, and that FrequencyAnalyzer rejects sizes that aren't
+// positive under every policy. Exits with failure if any doesn't.
+// usage: fft-backends [iterations]
+#include "BenchmarkFramework.hpp"
+#include <avz/analysis.hpp>
+
+#include <cmath>
+#include <print>
+#include <stdexcept>
+
+using namespace avz::benchmarks;
+using avz::fft::Backend;
+
+int main(const int argc, const char *const *const argv)
+{
+	const auto iterations = parse_iterations(argc, argv, 1000);
+	bool ok{true};
+
+	std::vector<Backend> backends;
+	for (const auto backend : {Backend::Fftw, Backend::PocketFft, Backend::Pffft})
+		if (avz::fft::is_available(backend))
+			backends.emplace_back(backend);
+
+	std::print("{:>8}{:>12}{:>12}", "size", "policy", "transform");
+	for (const auto backend : backends)
+		std::print("{:>14}", std::string{avz::fft::backend_name(backend)} + "_us");
+	std::println("{:>12}{:>10}", "fastest", "status");
+
+	using SizePolicy = avz::FrequencyAnalyzer::SizePolicy;
+	const std::pair<SizePolicy, const char *> policies[]{
+		{SizePolicy::Exact, "exact"}, {SizePolicy::Smooth, "smooth"}, {SizePolicy::PowerOfTwo, "pow2"}};
+
+	for (const auto size : example_fft_sizes())
+		for (const auto &[policy, policy_name] : policies)
+		{
+			const auto n = avz::FrequencyAnalyzer::compute_transform_size(size, policy);
+			std::print("{:>8}{:>12}{:>12}", size, policy_name, n);
+
+			std::vector<float> noise(n);
+			fill_noise(noise);
+
+			// the first backend's output is the reference
+			std::vector<std::complex<float>> reference;
+			double fastest_us{INFINITY};
+			const char *fastest{"-"};
+			bool matches{true};
+
+			for (const auto backend : backends)
+			{
+				// only time backends that can run this size themselves, rather than their fallback
+				if (!avz::fft::supports(backend, avz::fft::Kind::R2C, n))
+				{
+					std::print("{:>14}", "-");
+					continue;
+				}
+
+				avz::fft::dft_r2c_1d fft;
+				fft.set_n(n, backend);
+				std::ranges::copy(noise, fft.input().begin());
+				const auto us = time_us(iterations, [&] { fft.execute(); });
+				std::print("{:>14.2f}", us);
+
+				if (us < fastest_us)
+				{
+					fastest_us = us;
+					fastest = avz::fft::backend_name(backend);
+				}
+
+				const auto output = fft.output();
+				if (reference.empty())
+				{
+					reference.assign(output.begin(), output.end());
+					continue;
+				}
+
+				// single precision error grows with log2(n), relative to the spectrum's magnitude
+				float max_ref{}, max_diff{};
+				for (size_t k = 0; k < output.size(); ++k)
+				{
+					max_ref = std::max(max_ref, std::abs(reference[k]));
+					max_diff = std::max(max_diff, std::abs(output[k] - reference[k]));
+				}
+				matches &= max_diff <= 1e-5f * max_ref;
+			}
+
+			ok &= matches;
+			std::println("{:>12}{:>10}", fastest, matches ? "ok" : "MISMATCH");
+		}
+
+	// sizes that aren't positive used to spin forever in the smooth size search
+	bool rejected{true};
+	for (const auto size : {0, -1, -2})
+		for (const auto &[policy, policy_name] : policies)
+		{
+			const auto throws = [](auto &&fn)
+			{
+				try
+				{
+					fn();
+				}
+				catch (const std::invalid_argument &)
+				{
+					return true;
+				}
+				return false;
+			};
+			avz::FrequencyAnalyzer fa{64, policy};
+			rejected &= throws([&] { avz::FrequencyAnalyzer{size, policy}; });
+			rejected &= throws([&] { fa.set_fft_size(size); });
+			rejected &= throws([&] { avz::FrequencyAnalyzer::compute_transform_size(size, policy); });
+			// a rejected size leaves the analyzer as it was
+			rejected &= fa.get_fft_size() == 64;
+		}
+	ok &= rejected;
+	std::println("sizes that aren't positive: {}", rejected ? "rejected" : "FAILED");
+
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
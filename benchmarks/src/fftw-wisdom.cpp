@@ -0,0 +1,83 @@
+// Compares per-frame FFT time of FFTW_ESTIMATE plans against wisdom-backed FFTW_MEASURE plans.
+// usage: fftw-wisdom [iterations] [wisdom-file]
+// run it twice: the first run measures and saves wisdom, the second run plans almost instantly.
+#include "BenchmarkFramework.hpp"
+#include <avz/analysis.hpp>
+
+#include <chrono>
+#include <complex>
+#include <fftw3.h>
+#include <print>
+
+using namespace avz::benchmarks;
+
+namespace
+{
+
+// one real-to-complex transform on a plan shared through FftwPlanCache
+class R2cTransform
+{
+	avz::aligned_vector<float> in;
+	avz::aligned_vector<std::complex<float>> out;
+	avz::FftwPlanCache::Plan plan;
+
+public:
+	void set_n(const int n, const unsigned flags)
+	{
+		in.resize(n);
+		out.resize(n / 2 + 1);
+		plan = avz::FftwPlanCache::instance().get_r2c(
+			n, fftwf_alignment_of(in.data()), fftwf_alignment_of((float *)out.data()), flags);
+	}
+
+	// shared plans must be executed with the new-array interface
+	void execute() { fftwf_execute_dft_r2c(plan.get(), in.data(), (fftwf_complex *)out.data()); }
+
+	std::span<float> input() { return in; }
+};
+
+} // namespace
+
+int main(const int argc, const char *const *const argv)
+{
+	const auto iterations = parse_iterations(argc, argv, 1000);
+	const std::string wisdom_path = argc > 2 ? argv[2] : "fftw-wisdom.dat";
+
+	auto &plan_cache = avz::FftwPlanCache::instance();
+	std::println(
+		"wisdom file '{}': {}",
+		wisdom_path,
+		plan_cache.import_wisdom(wisdom_path) ? "loaded" : "not found, measuring from scratch");
+
+	std::println("{:>8}{:>14}{:>14}{:>10}{:>14}", "size", "estimate_us", "measure_us", "speedup", "plan_ms");
+
+	for (const auto n : example_fft_sizes())
+	{
+		R2cTransform estimate, measure;
+		estimate.set_n(n, FFTW_ESTIMATE);
+
+		const auto plan_start = std::chrono::steady_clock::now();
+		measure.set_n(n, FFTW_MEASURE);
+		const std::chrono::duration<double, std::milli> plan_ms = std::chrono::steady_clock::now() - plan_start;
+
+		fill_noise(estimate.input());
+		fill_noise(measure.input());
+
+		const auto estimate_us = time_us(iterations, [&] { estimate.execute(); });
+		const auto measure_us = time_us(iterations, [&] { measure.execute(); });
+
+		std::println(
+			"{:>8}{:>14.2f}{:>14.2f}{:>9.2f}x{:>14.1f}",
+			n,
+			estimate_us,
+			measure_us,
+			estimate_us / measure_us,
+			plan_ms.count());
+	}
+
+	if (!plan_cache.export_wisdom(wisdom_path))
+	{
+		std::println(stderr, "failed to save wisdom to '{}'", wisdom_path);
+		return EXIT_FAILURE;
+	}
+}
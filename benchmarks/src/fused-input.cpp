@@ -0,0 +1,199 @@
+// Times FrequencyAnalyzer::copy_to_input, which gathers a channel (or mixes stereo), removes DC, pre-emphasizes and
+// windows in one pass, against doing each step as a separate pass over a deinterleaved copy, and verifies that both
+// give the same spectrum for every combination of those steps. Also verifies that MultiChannelAudioAnalyzer's
+// batched and packed stereo paths apply the same steps to every channel. Exits with failure if any differ.
+// usage: fused-input [iterations]
+#include "BenchmarkFramework.hpp"
+#include <avz/analysis.hpp>
+
+#include <cmath>
+#include <print>
+#include <tuple>
+
+using namespace avz::benchmarks;
+using WindowFunction = avz::FrequencyAnalyzer::WindowFunction;
+using StereoMix = avz::FrequencyAnalyzer::StereoMix;
+
+namespace
+{
+
+struct Settings
+{
+	const char *name;
+	WindowFunction window_func;
+	bool dc_removal;
+	float pre_emphasis;
+
+	void apply(avz::FrequencyAnalyzer &fa) const
+	{
+		fa.set_window_func(window_func);
+		fa.set_dc_removal(dc_removal);
+		fa.set_pre_emphasis(pre_emphasis);
+	}
+};
+
+// where the samples come from: one channel of interleaved audio, or a mix of stereo
+struct Source
+{
+	const char *name;
+	int num_channels, channel;
+	// only used for stereo mixes, with num_channels = 2 and channel = -1
+	StereoMix mix;
+};
+
+// the steps copy_to_input fuses, one pass each over an already gathered `x`, in double where they accumulate
+void preprocess_unfused(std::span<float> x, const std::span<const float> window, const Settings &s)
+{
+	if (const auto a = s.pre_emphasis)
+	{
+		// backwards, so every step still sees the previous input sample; the one before the first is itself
+		for (size_t i = x.size() - 1; i > 0; --i)
+			x[i] -= a * x[i - 1];
+		x[0] *= 1 - a;
+	}
+
+	if (s.dc_removal)
+	{
+		double sum{}, window_sum{};
+		for (size_t i = 0; i < x.size(); ++i)
+		{
+			const auto w = window.empty() ? 1. : window[i];
+			sum += x[i] * w;
+			window_sum += w;
+		}
+		const float mean = sum / window_sum;
+		for (auto &v : x)
+			v -= mean;
+	}
+
+	if (!window.empty())
+		for (size_t i = 0; i < x.size(); ++i)
+			x[i] *= window[i];
+}
+
+void gather(const std::span<float> x, const std::span<const float> audio, const Source &src)
+{
+	if (src.channel >= 0)
+		avz::util::extract_channel(x, audio, src.num_channels, src.channel);
+	else
+		for (size_t i = 0; i < x.size(); ++i)
+			x[i] = 0.5f * (audio[2 * i] + (src.mix == StereoMix::Mid ? 1 : -1) * audio[2 * i + 1]);
+}
+
+// largest difference between two spectra, relative to the largest bin of `expected`
+float max_relative_error(
+	const std::span<const std::complex<float>> actual, const std::span<const std::complex<float>> expected)
+{
+	if (actual.size() != expected.size())
+		return INFINITY;
+	float max_error{}, max_amp{};
+	for (size_t k = 0; k < expected.size(); ++k)
+	{
+		max_error = std::max(max_error, std::abs(actual[k] - expected[k]));
+		max_amp = std::max(max_amp, std::abs(expected[k]));
+	}
+	return max_error / max_amp;
+}
+
+} // namespace
+
+int main(const int argc, const char *const *const argv)
+{
+	const auto iterations = parse_iterations(argc, argv, 1000);
+	constexpr auto tolerance = 1e-4f;
+	bool ok{true};
+
+	// 0.25s at 44.1kHz, zero-padded to a smooth transform size
+	constexpr int n = 11025, max_channels = 6;
+	constexpr auto size_policy = avz::FrequencyAnalyzer::SizePolicy::Smooth;
+
+	// noise under a tone, on a different DC offset per channel, so every step changes the spectrum
+	std::vector<float> audio(n * max_channels);
+	fill_noise(audio);
+	for (int i = 0; i < n; ++i)
+		for (int ch = 0; ch < max_channels; ++ch)
+			audio[i * max_channels + ch] += 0.1f * (ch + 1) + sinf(2 * M_PI * 440 * i / 44100);
+
+	const Settings settings[]{
+		{"none", WindowFunction::None, false, 0},
+		{"hann", WindowFunction::Hanning, false, 0},
+		{"hann+dc", WindowFunction::Hanning, true, 0},
+		{"hann+pe", WindowFunction::Hanning, false, 0.97f},
+		{"hann+dc+pe", WindowFunction::Hanning, true, 0.97f},
+		{"none+dc+pe", WindowFunction::None, true, 0.9f},
+		{"bh+dc+pe", WindowFunction::BlackmanHarris, true, 0.95f}};
+
+	const Source sources[]{
+		{"mono", 1, 0, {}}, {"6ch[4]", 6, 4, {}}, {"mid", 2, -1, StereoMix::Mid}, {"side", 2, -1, StereoMix::Side}};
+
+	std::println(
+		"{:>8}{:>12}{:>12}{:>14}{:>12}{:>10}", "source", "settings", "fused_us", "unfused_us", "rel_error", "status");
+	for (const auto &src : sources)
+		for (const auto &s : settings)
+		{
+			const auto src_audio = std::span{audio}.first(n * src.num_channels);
+			avz::FrequencyAnalyzer fa{n, size_policy}, plain{n, size_policy};
+			s.apply(fa);
+			plain.set_window_func(WindowFunction::None);
+
+			const auto fused = [&]
+			{
+				if (src.channel >= 0)
+					fa.copy_to_input(src_audio, src.num_channels, src.channel);
+				else
+					fa.copy_to_input(src_audio, src.mix);
+			};
+			std::vector<float> x(n);
+			const auto unfused = [&]
+			{
+				gather(x, src_audio, src);
+				preprocess_unfused(x, fa.get_window(), s);
+				plain.copy_to_input(x);
+			};
+			const auto fused_us = time_us(iterations, fused);
+			const auto unfused_us = time_us(iterations, unfused);
+
+			fa.execute_fft();
+			plain.execute_fft();
+			const auto error = max_relative_error(fa.get_output(), plain.get_output());
+			const auto matches = error <= tolerance;
+			ok &= matches;
+			std::println(
+				"{:>8}{:>12}{:>12.2f}{:>14.2f}{:>12.2e}{:>10}",
+				src.name,
+				s.name,
+				fused_us,
+				unfused_us,
+				error,
+				matches ? "ok" : "MISMATCH");
+		}
+
+	// every channel of the multi-channel paths against copy_to_input on that channel
+	std::println("{:>10}{:>12}{:>12}{:>10}", "path", "settings", "rel_error", "status");
+	const std::tuple<const char *, int, bool> paths[]{
+		{"packed", 2, true}, {"batched2", 2, false}, {"batched6", 6, false}};
+	for (const auto &[path, num_channels, packed] : paths)
+		for (const auto &s : settings)
+		{
+			const auto src_audio = std::span{audio}.first(n * num_channels);
+			avz::FrequencyAnalyzer fa{n, size_policy};
+			s.apply(fa);
+			avz::MultiChannelAudioAnalyzer mcaa{num_channels};
+			mcaa.set_packed_stereo(packed);
+			mcaa.execute_fft(fa, src_audio);
+
+			float error{};
+			for (int ch = 0; ch < num_channels; ++ch)
+			{
+				fa.copy_to_input(src_audio, num_channels, ch);
+				fa.execute_fft();
+				error = std::max(error, max_relative_error(mcaa.get_spectrum(ch), fa.get_output()));
+			}
+
+			const auto matches = error <= tolerance;
+			ok &= matches;
+			std::println("{:>10}{:>12}{:>12.2e}{:>10}", path, s.name, error, matches ? "ok" : "MISMATCH");
+		}
+
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
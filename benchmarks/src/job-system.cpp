@@ -0,0 +1,242 @@
+// Times one frame of fork-join work (a task per bass-nation layer) on JobSystem against the per-layer
+// worker threads it replaces, which were woken through a mutex and condition variable and joined through a
+// promise every frame. Also verifies that both compute the same results, that nested groups work and are stolen
+// by other threads, that exceptions reach the waiting thread, and that groups wait for their jobs when destroyed.
+// Exits with failure if any of this doesn't hold.
+// usage: job-system [iterations]
+#include "BenchmarkFramework.hpp"
+#include <avz/analysis.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <numeric>
+#include <print>
+#include <stdexcept>
+#include <thread>
+
+using namespace avz::benchmarks;
+
+namespace
+{
+
+constexpr int tasks = 18;
+
+// stands in for a layer's analysis: a dot product over its own slice of the input
+float work(const std::span<const float> in)
+{
+	return std::inner_product(in.begin(), in.end(), in.begin(), 0.f);
+}
+
+// the old BassNationSpectrumLayer threading, reduced to its synchronization
+class LayerThread
+{
+	std::thread worker;
+	std::mutex mu;
+	std::condition_variable cv;
+	bool has_work{}, stop{};
+	std::promise<void> promise;
+	std::span<const float> in;
+	float &out;
+
+public:
+	LayerThread(const std::span<const float> in, float &out)
+		: in{in},
+		  out{out}
+	{
+		worker = std::thread{[this] { loop(); }};
+	}
+
+	~LayerThread()
+	{
+		{
+			std::lock_guard lk{mu};
+			stop = true;
+		}
+		cv.notify_one();
+		worker.join();
+	}
+
+	std::future<void> trigger()
+	{
+		std::promise<void> p;
+		auto future = p.get_future();
+		{
+			std::lock_guard lk{mu};
+			promise = std::move(p);
+			has_work = true;
+		}
+		cv.notify_one();
+		return future;
+	}
+
+private:
+	void loop()
+	{
+		while (true)
+		{
+			std::unique_lock lk{mu};
+			cv.wait(lk, [this] { return has_work || stop; });
+			if (stop)
+				return;
+			has_work = false;
+			auto p = std::move(promise);
+			lk.unlock();
+			out = work(in);
+			p.set_value();
+		}
+	}
+};
+
+} // namespace
+
+int main(const int argc, const char *const *const argv)
+{
+	const auto iterations = parse_iterations(argc, argv, 2000);
+	bool ok{true};
+
+	avz::JobSystem jobs{std::max(4, avz::JobSystem::instance().get_thread_count())};
+
+	std::println(
+		"{:>10}{:>10}{:>14}{:>14}{:>14}{:>10}", "size", "threads", "serial_us", "layer_us", "jobs_us", "status");
+
+	for (const int size : {256, 4096, 65536})
+	{
+		std::vector<float> in(tasks * size);
+		fill_noise(in);
+		const auto slice = [&](const int i) { return std::span<const float>{in}.subspan(i * size, size); };
+
+		std::vector<float> expected(tasks), layer_out(tasks), job_out(tasks);
+		const auto serial_us = time_us(
+			iterations,
+			[&]
+			{
+				for (int i = 0; i < tasks; ++i)
+					expected[i] = work(slice(i));
+			});
+
+		double layer_us;
+		{
+			std::vector<std::unique_ptr<LayerThread>> layers;
+			for (int i = 0; i < tasks; ++i)
+				layers.emplace_back(std::make_unique<LayerThread>(slice(i), layer_out[i]));
+			std::vector<std::future<void>> futures(tasks);
+			layer_us = time_us(
+				iterations,
+				[&]
+				{
+					std::ranges::transform(layers, futures.begin(), &LayerThread::trigger);
+					std::ranges::for_each(futures, &std::future<void>::wait);
+				});
+		}
+
+		const auto jobs_us =
+			time_us(iterations, [&] { jobs.parallel_for(tasks, [&](const int i) { job_out[i] = work(slice(i)); }); });
+
+		// the same code inlined in different places may be vectorized differently, so allow for rounding
+		const auto close = [&](const std::vector<float> &out)
+		{
+			for (int i = 0; i < tasks; ++i)
+				if (std::abs(out[i] - expected[i]) > 1e-5f * expected[i])
+					return false;
+			return true;
+		};
+		const auto matches = close(layer_out) && close(job_out);
+		ok &= matches;
+		std::println(
+			"{:>10}{:>10}{:>14.2f}{:>14.2f}{:>14.2f}{:>10}",
+			size,
+			jobs.get_thread_count(),
+			serial_us,
+			layer_us,
+			jobs_us,
+			matches ? "ok" : "MISMATCH");
+	}
+
+	// nested fork-join: every outer job forks and waits on its own group
+	std::vector<int> counts(tasks * tasks);
+	jobs.parallel_for(
+		tasks, [&](const int i) { jobs.parallel_for(tasks, [&](const int j) { ++counts[i * tasks + j]; }); });
+	const auto nested_ok = std::ranges::all_of(counts, [](const int c) { return c == 1; });
+	ok &= nested_ok;
+	std::println("nested groups: {}", nested_ok ? "ok" : "FAILED");
+
+	// groups forked by jobs the submitting thread popped back are still spread over the workers: every nested job
+	// waits (for a second at most) until its group has run on two threads, which never happens if it runs inline
+	const auto main_thread = std::this_thread::get_id();
+	std::atomic<int> popped{};
+	std::atomic<bool> spread_ok{true};
+	jobs.parallel_for(
+		tasks,
+		[&](int)
+		{
+			if (std::this_thread::get_id() != main_thread)
+				return;
+			++popped;
+			std::atomic<std::thread::id> first_thread{};
+			std::atomic<bool> spread{};
+			const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{1};
+			jobs.parallel_for(
+				tasks,
+				[&](int)
+				{
+					std::thread::id none{};
+					const auto id = std::this_thread::get_id();
+					if (!first_thread.compare_exchange_strong(none, id) && none != id)
+						spread = true;
+					while (!spread && std::chrono::steady_clock::now() < deadline)
+						std::this_thread::yield();
+				});
+			if (!spread)
+				spread_ok = false;
+		});
+	ok &= spread_ok;
+	std::println("groups forked by popped jobs: {} ({} popped)", spread_ok ? "ok" : "FAILED", popped.load());
+
+	// an exception is rethrown by wait, after every other job of the group has run
+	std::atomic<int> ran{};
+	bool thrown{};
+	try
+	{
+		jobs.parallel_for(
+			tasks,
+			[&](const int i)
+			{
+				++ran;
+				if (i == tasks / 2)
+					throw std::runtime_error{"job failed"};
+			});
+	}
+	catch (const std::runtime_error &)
+	{
+		thrown = true;
+	}
+	const auto exception_ok = thrown && ran == tasks;
+	ok &= exception_ok;
+	std::println("exceptions: {}", exception_ok ? "ok" : "FAILED");
+
+	// a group unwound by an exception before its wait still waits for its jobs
+	std::atomic<bool> finished{};
+	try
+	{
+		avz::JobSystem::TaskGroup group;
+		jobs.run(
+			group,
+			[&]
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds{10});
+				finished = true;
+			});
+		throw std::runtime_error{"update failed"};
+	}
+	catch (const std::runtime_error &)
+	{
+	}
+	ok &= finished.load();
+	std::println("groups destroyed early: {}", finished ? "ok" : "FAILED");
+
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
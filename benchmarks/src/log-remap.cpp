@@ -0,0 +1,136 @@
+// Times LogSpectrumRemapper against packing with BinPacker and then filling the gaps with Interpolator, as the
+// log-spectrum example did before, and verifies that a pure tone lands in its column on the log scale and that
+// remapping a power spectrum keeps its total power. Exits with failure if it doesn't.
+// usage: log-remap [iterations]
+#include "BenchmarkFramework.hpp"
+#include <avz/analysis.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <print>
+
+using namespace avz::benchmarks;
+using Type = avz::Interpolator::InterpolationType;
+using avz::BinPacker;
+
+namespace
+{
+
+constexpr float sample_rate_hz = 48000;
+
+float sum(const std::span<const float> values)
+{
+	return std::accumulate(values.begin(), values.end(), 0.);
+}
+
+} // namespace
+
+int main(const int argc, const char *const *const argv)
+{
+	const auto iterations = parse_iterations(argc, argv, 10000);
+	bool ok{true};
+
+	// the log-spectrum example on a 1920 pixel wide window (an fft of twice the bar count), and a longer fft
+	// packed into fewer bars
+	const std::pair<int, int> sizes[]{{1920, 960}, {4096, 512}};
+
+	std::println("{:>8}{:>8}{:>8}{:>12}{:>12}", "fft", "bars", "gaps", "packer_us", "remapper_us");
+	for (const auto &[fft_size, bars] : sizes)
+	{
+		std::vector<float> in(fft_size / 2 + 1), out(bars);
+		fill_noise(in);
+		for (auto &v : in)
+			v = std::abs(v);
+
+		BinPacker packer;
+		avz::Interpolator interpolator;
+		interpolator.set_interp_type(Type::CSPLINE_HERMITE);
+		const auto packer_us = time_us(
+			iterations,
+			[&]
+			{
+				packer.bin_pack(out, in);
+				interpolator.interpolate(out);
+			});
+
+		avz::LogSpectrumRemapper remapper;
+		const auto remapper_us = time_us(iterations, [&] { remapper.remap(out, in); });
+		std::println(
+			"{:>8}{:>8}{:>8}{:>12.2f}{:>12.2f}", fft_size, bars, remapper.get_gap_count(), packer_us, remapper_us);
+	}
+
+	std::println(
+		"{:>8}{:>8}{:>10}{:>8}{:>10}{:>12}{:>10}", "fft", "bars", "tone_hz", "column", "peak_at", "power", "status");
+	for (const auto &[fft_size, bars] : sizes)
+	{
+		avz::FrequencyAnalyzer fa{fft_size};
+		avz::AudioAnalyzer aa;
+		std::vector<float> audio(fft_size), out(bars);
+
+		// the last column filled in by interpolation: tones well above it have every neighbouring column filled
+		const auto plan = BinPacker{}.get_plan(bars, fft_size / 2 + 1);
+		int last_gap{-1};
+		for (int row = 0; row < bars; ++row)
+			if (plan->is_row_empty(row))
+				last_gap = row;
+
+		for (const float tone_hz : {50.f, 150.f, 440.f, 1000.f, 3000.f, 10000.f})
+		{
+			// a tone at a bin center, so its peak is exactly one bin
+			const int bin = std::lround(tone_hz * fft_size / sample_rate_hz);
+			for (int i = 0; i < fft_size; ++i)
+				audio[i] = sinf(2 * M_PI * bin * i / fft_size);
+			aa.execute_fft(fa, audio);
+			aa.compute_amplitudes(fa);
+			const auto amplitudes = aa.get_amplitudes();
+
+			// input bin i goes to column log(i) / log(input size) * bars
+			const auto column = (int)(logf(bin) / logf(amplitudes.size()) * bars);
+
+			// the tone keeps its amplitude in its column however gaps are filled. linear gaps never rise above
+			// their neighbours, so the tone is also the loudest column; cubic ones can overshoot next to a peak.
+			bool lands{true};
+			int peak_at{};
+			for (const auto type : {Type::LINEAR, Type::CSPLINE_HERMITE, Type::MONOTONE})
+			{
+				avz::LogSpectrumRemapper remapper{BinPacker::Scale::LOG, BinPacker::AccumulationMethod::MAX, type};
+				remapper.remap(out, amplitudes);
+				lands &= out[column] == amplitudes[bin];
+				if (type == Type::LINEAR)
+				{
+					peak_at = std::ranges::max_element(out) - out.begin();
+					lands &= peak_at == column;
+				}
+			}
+
+			// summing a power spectrum moves its power between columns without changing it, and interpolation
+			// only adds power in the gaps, which a tone well above the last gap doesn't reach
+			std::vector<float> power(amplitudes.size());
+			std::ranges::transform(amplitudes, power.begin(), [](const float a) { return a * a; });
+			avz::LogSpectrumRemapper remapper{BinPacker::Scale::LOG, BinPacker::AccumulationMethod::SUM};
+			remapper.remap(out, power);
+			float packed_power{};
+			for (int row = 0; row < bars; ++row)
+				if (!plan->is_row_empty(row))
+					packed_power += out[row];
+			const auto power_ratio = sum(out) / sum(power);
+			bool keeps_power = std::abs(packed_power / sum(power) - 1) < 1e-4f;
+			if (column > last_gap + 2)
+				keeps_power &= std::abs(power_ratio - 1) < 0.01f;
+
+			ok &= lands && keeps_power;
+			std::println(
+				"{:>8}{:>8}{:>10.1f}{:>8}{:>10}{:>12.4f}{:>10}",
+				fft_size,
+				bars,
+				bin * sample_rate_hz / fft_size,
+				column,
+				peak_at,
+				power_ratio,
+				lands && keeps_power ? "ok" : "FAILED");
+		}
+	}
+
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
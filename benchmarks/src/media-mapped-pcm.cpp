@@ -0,0 +1,201 @@
+// Times one frame of Player's read_audio/consume_audio cycle on a memory-mapped float WAV file against
+// streaming the same samples through Media's ring buffer, as a decoder pipe does. Also verifies that every
+// window of the mapped file, its tags, a raw f32 file and seeking return the right data. Exits with failure if
+// they don't.
+// usage: media-mapped-pcm [iterations]
+#include "BenchmarkFramework.hpp"
+#include <avz/media/MappedPcmMedia.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <print>
+
+using namespace avz::benchmarks;
+using namespace std::string_literals;
+
+namespace
+{
+
+constexpr int channels = 2, sample_rate = 48000;
+
+// 10 seconds, long enough for thousands of 60 fps frames
+constexpr size_t total_samples = 10 * sample_rate * channels;
+
+float sample_at(const size_t index)
+{
+	return index % (1 << 20);
+}
+
+template <typename T>
+void put(std::ofstream &out, const T value)
+{
+	out.write((const char *)&value, sizeof(value));
+}
+
+// a minimal float wav file, with its tags after the samples
+void write_wav(const std::filesystem::path &path)
+{
+	const std::string info = "INFOINAM\x06\0\0\0title\0IART\x07\0\0\0artist\0\0"s;
+	const uint32_t data_bytes = total_samples * sizeof(float);
+	std::ofstream out{path, std::ios::binary};
+	out.write("RIFF", 4);
+	put<uint32_t>(out, 4 + 24 + 8 + data_bytes + 8 + info.size());
+	out.write("WAVEfmt ", 8);
+	put<uint32_t>(out, 16);
+	put<uint16_t>(out, 3);
+	put<uint16_t>(out, channels);
+	put<uint32_t>(out, sample_rate);
+	put<uint32_t>(out, sample_rate * channels * sizeof(float));
+	put<uint16_t>(out, channels * sizeof(float));
+	put<uint16_t>(out, 32);
+	out.write("data", 4);
+	put(out, data_bytes);
+	for (size_t i = 0; i < total_samples; ++i)
+		put(out, sample_at(i));
+	out.write("LIST", 4);
+	put<uint32_t>(out, info.size());
+	out.write(info.data(), info.size());
+}
+
+// the same samples streamed through Media's ring buffer, like FfmpegPopenMedia's pipe
+class StreamedMedia : public avz::Media
+{
+	FILE *file;
+	std::optional<std::vector<std::byte>> no_pic;
+
+public:
+	StreamedMedia(const std::filesystem::path &path)
+		: Media{path.string()},
+		  file{fopen(path.string().c_str(), "rb")}
+	{
+		fseek(file, 44, SEEK_SET);
+	}
+
+	~StreamedMedia() { fclose(file); }
+
+	size_t read_audio_samples(float *const buf, const int samples) override
+	{
+		return fread(buf, sizeof(float), samples, file);
+	}
+
+	void seek_source(const double seconds) override
+	{
+		fseek(file, 44 + std::llround(seconds * sample_rate) * channels * sizeof(float), SEEK_SET);
+	}
+
+	bool read_video_frame(std::vector<std::byte> &) override { return false; }
+	int audio_sample_rate() const override { return sample_rate; }
+	int audio_channels() const override { return channels; }
+	bool has_video_stream() const override { return false; }
+	int video_framerate() const override { return 0; }
+	const std::optional<std::vector<std::byte>> &attached_pic() const override { return no_pic; }
+	std::string title() const override { return {}; }
+	std::string artist() const override { return {}; }
+};
+
+// whether every window from the start of `media` holds the right samples
+bool check_windows(avz::Media &media, const int frames, const int hop)
+{
+	for (size_t frame = 0;; ++frame)
+	{
+		const auto audio = media.read_audio(frames);
+		if (!audio)
+			// the stream ends once less than a window is left
+			return (frame * hop + frames) * channels > total_samples;
+		for (size_t i = 0; i < audio->size(); ++i)
+			if ((*audio)[i] != sample_at(frame * hop * channels + i))
+				return false;
+		media.consume_audio(hop);
+	}
+}
+
+} // namespace
+
+int main(const int argc, const char *const *const argv)
+{
+	const auto iterations = parse_iterations(argc, argv, 10000);
+	bool ok{true};
+
+	const auto dir = std::filesystem::temp_directory_path();
+	const auto wav = dir / "avz-media-mapped-pcm.wav";
+	write_wav(wav);
+
+	std::println(
+		"{:>10}{:>8}{:>14}{:>12}{:>10}{:>10}", "frames", "hop", "streamed_us", "mapped_us", "speedup", "status");
+
+	// 0.25s windows moving at 60 fps
+	for (const auto &[frames, hop] : {std::pair{11025, 735}, std::pair{12000, 800}})
+	{
+		// restart from the beginning before reaching the end of the file
+		const auto cycle = [&](avz::Media &media, int &frame)
+		{
+			if ((size_t)(++frame * hop + frames) * channels > total_samples)
+			{
+				media.seek(0);
+				frame = 0;
+			}
+			media.read_audio(frames);
+			media.consume_audio(hop);
+		};
+
+		StreamedMedia streamed{wav};
+		int streamed_frame{};
+		const auto streamed_us = time_us(iterations, [&] { cycle(streamed, streamed_frame); });
+
+		avz::MappedPcmMedia mapped{wav};
+		int mapped_frame{};
+		const auto mapped_us = time_us(iterations, [&] { cycle(mapped, mapped_frame); });
+
+		mapped.seek(0);
+		bool matches = check_windows(mapped, frames, hop);
+		ok &= matches;
+
+		std::println(
+			"{:>10}{:>8}{:>14.2f}{:>12.2f}{:>9.2f}x{:>10}",
+			frames,
+			hop,
+			streamed_us,
+			mapped_us,
+			streamed_us / mapped_us,
+			matches ? "ok" : "MISMATCH");
+	}
+
+	avz::MappedPcmMedia mapped{wav};
+	const auto tags_ok = mapped.audio_sample_rate() == sample_rate && mapped.audio_channels() == channels &&
+						 mapped.title() == "title" && mapped.artist() == "artist";
+	ok &= tags_ok;
+	std::println("wav header and tags: {}", tags_ok ? "ok" : "FAILED");
+
+	// a seek lands on the exact frame, and reads past the end fail
+	mapped.seek(2.5);
+	const auto after_seek = mapped.read_audio(100);
+	mapped.seek(10);
+	const auto seek_ok = after_seek && after_seek->front() == sample_at(2.5 * sample_rate * channels) &&
+						 !mapped.read_audio(1) && mapped.read_audio(0);
+	ok &= seek_ok;
+	std::println("seek: {}", seek_ok ? "ok" : "FAILED");
+
+	// the samples of the wav file without its header and tags, as a raw f32 file
+	const auto raw = dir / "avz-media-mapped-pcm.f32";
+	{
+		std::ifstream in{wav, std::ios::binary};
+		std::vector<char> bytes(total_samples * sizeof(float));
+		in.seekg(44);
+		in.read(bytes.data(), bytes.size());
+		std::ofstream{raw, std::ios::binary}.write(bytes.data(), bytes.size());
+	}
+	{
+		avz::MappedPcmMedia raw_media{raw, sample_rate, channels};
+		const auto raw_ok = check_windows(raw_media, 4800, 800);
+		ok &= raw_ok;
+		std::println("raw f32: {}", raw_ok ? "ok" : "FAILED");
+	}
+
+	std::filesystem::remove(wav);
+	std::filesystem::remove(raw);
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,137 @@
+// Times one frame of Player's read_audio/consume_audio cycle on Media's ring buffer against the vector it
+// replaces, whose consume erased the front of the buffer, and verifies that every window read from the ring
+// buffer holds the right samples, across many wrap-arounds and after a seek. Exits with failure if it doesn't.
+// usage: media-ring-buffer [iterations]
+#include "BenchmarkFramework.hpp"
+#include <avz/media/Media.hpp>
+
+#include <cmath>
+#include <print>
+
+using namespace avz::benchmarks;
+
+namespace
+{
+
+constexpr int channels = 2;
+
+// samples count up from 0, wrapping before floats lose precision
+float sample_at(const size_t index)
+{
+	return index % (1 << 20);
+}
+
+// a source of sequential samples, returning short reads like a pipe does
+class CounterMedia : public avz::Media
+{
+	size_t next{};
+	std::optional<std::vector<std::byte>> no_pic;
+
+public:
+	CounterMedia()
+		: Media{"counter"}
+	{
+	}
+
+	size_t read_audio_samples(float *const buf, const int samples) override
+	{
+		const auto count = std::min(samples, 4096);
+		for (int i = 0; i < count; ++i)
+			buf[i] = sample_at(next++);
+		return count;
+	}
+
+	void seek_source(const double seconds) override { next = std::llround(seconds * audio_sample_rate()) * channels; }
+	bool read_video_frame(std::vector<std::byte> &) override { return false; }
+	int audio_sample_rate() const override { return 48000; }
+	int audio_channels() const override { return channels; }
+	bool has_video_stream() const override { return false; }
+	int video_framerate() const override { return 0; }
+	const std::optional<std::vector<std::byte>> &attached_pic() const override { return no_pic; }
+	std::string title() const override { return {}; }
+	std::string artist() const override { return {}; }
+};
+
+// Media's buffer before the ring buffer
+struct VectorBuffer
+{
+	CounterMedia media;
+	std::vector<float> buffer;
+
+	std::span<const float> read_audio(const int frames)
+	{
+		const auto samples = frames * channels;
+		while ((int)buffer.size() < samples)
+		{
+			std::vector<float> buf(samples);
+			const auto samples_read = media.read_audio_samples(buf.data(), samples);
+			buffer.insert(buffer.end(), buf.begin(), buf.begin() + samples_read);
+		}
+		return {buffer.data(), (size_t)samples};
+	}
+
+	void consume_audio(const int frames) { buffer.erase(buffer.begin(), buffer.begin() + frames * channels); }
+};
+
+} // namespace
+
+int main(const int argc, const char *const *const argv)
+{
+	const auto iterations = parse_iterations(argc, argv, 10000);
+	bool ok{true};
+
+	std::println("{:>10}{:>8}{:>12}{:>12}{:>10}{:>10}", "frames", "hop", "vector_us", "ring_us", "speedup", "status");
+
+	// 0.25s windows at 44.1 and 48 kHz, moving at 60 fps
+	for (const auto &[frames, hop] : {std::pair{11025, 735}, std::pair{12000, 800}})
+	{
+		VectorBuffer vector;
+		const auto vector_us = time_us(
+			iterations,
+			[&]
+			{
+				vector.read_audio(frames);
+				vector.consume_audio(hop);
+			});
+
+		CounterMedia media;
+		const auto ring_us = time_us(
+			iterations,
+			[&]
+			{
+				media.read_audio(frames);
+				media.consume_audio(hop);
+			});
+
+		// check every window of a fresh stream for long enough to wrap the ring buffer many times
+		CounterMedia checked;
+		bool matches{true};
+		for (size_t frame = 0; frame < 2000 && matches; ++frame)
+		{
+			const auto audio = checked.read_audio(frames);
+			matches = audio && audio->size() == (size_t)frames * channels;
+			for (size_t i = 0; matches && i < audio->size(); ++i)
+				matches = (*audio)[i] == sample_at(frame * hop * channels + i);
+			checked.consume_audio(hop);
+		}
+
+		// a seek drops the buffered window, the next one starts at the new position
+		checked.seek(1.5);
+		const auto audio = checked.read_audio(frames);
+		const size_t start = 72000 * channels;
+		matches &=
+			audio && (*audio)[0] == sample_at(start) && audio->back() == sample_at(start + frames * channels - 1);
+		ok &= matches;
+
+		std::println(
+			"{:>10}{:>8}{:>12.2f}{:>12.2f}{:>9.2f}x{:>10}",
+			frames,
+			hop,
+			vector_us,
+			ring_us,
+			vector_us / ring_us,
+			matches ? "ok" : "MISMATCH");
+	}
+
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
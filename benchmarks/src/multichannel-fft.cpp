@@ -0,0 +1,83 @@
+// Compares the batched multi-channel FFT (one plan execution for all channels) against
+// deinterleaving and transforming each channel separately, and verifies that both produce
+// the same amplitudes. Exits with failure if they don't.
+// usage: multichannel-fft [iterations]
+#include "BenchmarkFramework.hpp"
+#include <avz/analysis.hpp>
+
+#include <cmath>
+#include <print>
+
+using namespace avz::benchmarks;
+
+int main(const int argc, const char *const *const argv)
+{
+	const auto iterations = parse_iterations(argc, argv, 1000);
+	constexpr auto tolerance = 1e-4f;
+	bool ok{true};
+
+	std::println(
+		"{:>8}{:>10}{:>15}{:>14}{:>10}{:>12}",
+		"size",
+		"channels",
+		"per_channel_us",
+		"batched_us",
+		"speedup",
+		"rel_error");
+
+	for (const int num_channels : {1, 6, 8})
+		for (const auto n : example_fft_sizes())
+		{
+			avz::FrequencyAnalyzer fa{n, avz::FrequencyAnalyzer::SizePolicy::Smooth};
+			std::vector<float> audio(num_channels * n), channel(n);
+			fill_noise(audio);
+
+			std::vector<avz::AudioAnalyzer> per_channel(num_channels);
+			avz::MultiChannelAudioAnalyzer batched{num_channels};
+
+			const auto per_channel_us = time_us(
+				iterations,
+				[&]
+				{
+					for (int ch = 0; ch < num_channels; ++ch)
+					{
+						avz::util::extract_channel(channel, audio, num_channels, ch);
+						per_channel[ch].execute_fft(fa, channel);
+						per_channel[ch].compute_amplitudes(fa);
+					}
+				});
+			const auto batched_us = time_us(
+				iterations,
+				[&]
+				{
+					batched.execute_fft(fa, audio);
+					batched.compute_amplitudes();
+				});
+
+			float max_error{}, max_amp{};
+			for (int ch = 0; ch < num_channels; ++ch)
+			{
+				const auto a = batched.get_amplitudes(ch);
+				const auto b = per_channel[ch].get_amplitudes();
+				for (size_t i = 0; i < b.size(); ++i)
+				{
+					max_error = std::max(max_error, std::abs(a[i] - b[i]));
+					max_amp = std::max(max_amp, b[i]);
+				}
+			}
+			const auto error = max_error / max_amp;
+			ok &= error <= tolerance;
+
+			std::println(
+				"{:>8}{:>10}{:>15.2f}{:>14.2f}{:>9.2f}x{:>12.2e}{}",
+				n,
+				num_channels,
+				per_channel_us,
+				batched_us,
+				per_channel_us / batched_us,
+				error,
+				error <= tolerance ? "" : "  MISMATCH");
+		}
+
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
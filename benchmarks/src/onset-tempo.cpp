@@ -0,0 +1,91 @@
+// Times OnsetAnalyzer::process per frame, and verifies that it finds every beat of a synthetic
+// drum pattern and its tempo. Exits with failure if it doesn't.
+// usage: onset-tempo [iterations]
+#include "BenchmarkFramework.hpp"
+#include <avz/analysis.hpp>
+
+#include <cmath>
+#include <print>
+
+using namespace avz::benchmarks;
+
+namespace
+{
+
+constexpr float frame_rate_hz = 60;
+constexpr int seconds = 20;
+
+// amplitude frames of a beat at `bpm` over a noise floor: a broadband hit that decays over a few frames
+std::vector<std::vector<float>> make_frames(const int bins, const float bpm)
+{
+	const auto num_frames = (int)(seconds * frame_rate_hz);
+	const auto period = 60 * frame_rate_hz / bpm;
+	std::vector<std::vector<float>> frames(num_frames, std::vector<float>(bins));
+	std::vector<float> noise(bins);
+	for (int f = 0; f < num_frames; ++f)
+	{
+		fill_noise(noise, f + 1);
+		const auto since_beat = fmodf(f, period);
+		const auto hit = expf(-since_beat / 2);
+		for (int k = 0; k < bins; ++k)
+			frames[f][k] = 0.01f * std::abs(noise[k]) + 0.2f * hit / (1 + 0.01f * k);
+	}
+	return frames;
+}
+
+} // namespace
+
+int main(const int argc, const char *const *const argv)
+{
+	const auto iterations = parse_iterations(argc, argv, 20);
+	bool ok{true};
+
+	// largest FFT the examples run
+	const auto bins = example_fft_sizes().back() / 2 + 1;
+
+	std::println(
+		"{:>8}{:>8}{:>12}{:>10}{:>12}{:>14}{:>8}",
+		"bins",
+		"bpm",
+		"frame_us",
+		"onsets",
+		"tempo_bpm",
+		"confidence",
+		"status");
+
+	for (const auto bpm : {90.f, 120.f, 150.f})
+	{
+		const auto frames = make_frames(bins, bpm);
+		avz::OnsetAnalyzer oa{frame_rate_hz};
+		int onsets{};
+
+		const auto total_us = time_us(
+			iterations,
+			[&]
+			{
+				oa.reset();
+				onsets = 0;
+				for (const auto &frame : frames)
+					onsets += oa.process(frame);
+			});
+		const auto frame_us = total_us / frames.size();
+
+		// the first beat has no previous frame to rise from
+		const auto beats = (int)ceilf(seconds * bpm / 60) - 1;
+		const auto tempo = oa.get_tempo_bpm();
+		const bool matches = std::abs(onsets - beats) <= 1 && std::abs(tempo - bpm) <= 0.02f * bpm;
+		ok &= matches;
+
+		std::println(
+			"{:>8}{:>8}{:>12.3f}{:>10}{:>12.2f}{:>14.2f}{:>8}",
+			bins,
+			bpm,
+			frame_us,
+			onsets,
+			tempo,
+			oa.get_tempo_confidence(),
+			matches ? "ok" : "MISMATCH");
+	}
+
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,95 @@
+// Times one PeakEstimator estimate per interpolation method, with and without the phase vocoder, at shake-bass's
+// default settings, and verifies how close each gets to the frequency of tones swept across the bass range.
+// Exits with failure if any method is further off than its bound.
+// usage: peak-estimator [iterations]
+#include "BenchmarkFramework.hpp"
+#include <avz/analysis.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <print>
+
+using namespace avz::benchmarks;
+
+namespace
+{
+
+using Interpolation = avz::PeakEstimator::Interpolation;
+
+constexpr float sample_rate_hz = 44100;
+
+// shake-bass: a 0.0625s window moving at 60 fps
+constexpr int window = sample_rate_hz * 0.0625f, hop = sample_rate_hz / 60;
+
+constexpr int from_hz = 20, to_hz = 260;
+
+struct Method
+{
+	const char *name;
+	Interpolation interpolation;
+	bool phase_vocoder;
+	// worst error allowed over the sweep; the bin center bound is filled in from the bin spacing
+	float max_error_hz;
+};
+
+} // namespace
+
+int main(const int argc, const char *const *const argv)
+{
+	const auto iterations = parse_iterations(argc, argv, 100000);
+	bool ok{true};
+
+	avz::FrequencyAnalyzer fa{window, avz::FrequencyAnalyzer::SizePolicy::Smooth};
+	const auto bin_spacing_hz = sample_rate_hz / fa.get_transform_size();
+	std::println("window {}, transform {}, {:.2f} Hz bin spacing", window, fa.get_transform_size(), bin_spacing_hz);
+
+	const Method methods[]{
+		// the nearest bin center is at most half a bin away, give or take rounding
+		{"none", Interpolation::None, false, bin_spacing_hz / 2 + 0.01f},
+		{"quadratic", Interpolation::Quadratic, false, 1},
+		{"gaussian", Interpolation::Gaussian, false, 0.3f},
+		{"gaussian+pv", Interpolation::Gaussian, true, 0.05f}};
+
+	std::println("{:>14}{:>14}{:>14}{:>10}{:>10}", "method", "estimate_us", "max_error_hz", "bound", "status");
+	for (const auto &method : methods)
+	{
+		avz::AudioAnalyzer aa;
+		std::vector<float> audio(window + 3 * hop);
+
+		fill_noise(audio);
+		aa.execute_fft(fa, std::span{audio}.first(window));
+		aa.compute_amplitudes(fa);
+		avz::PeakEstimator timed{method.interpolation, method.phase_vocoder};
+		const auto estimate_us =
+			time_us(iterations, [&] { aa.estimate_peak_frequency(fa, sample_rate_hz, from_hz, to_hz, timed, hop); });
+
+		// a few frames of each tone, so the phase vocoder has a previous frame to refine against
+		float max_error_hz{};
+		for (float freq_hz = 40; freq_hz < 240; freq_hz += 1.37f)
+		{
+			for (size_t i = 0; i < audio.size(); ++i)
+				audio[i] = 0.5f * sinf(2 * M_PI * freq_hz * i / sample_rate_hz + 0.3f);
+			avz::PeakEstimator estimator{method.interpolation, method.phase_vocoder};
+			avz::PeakEstimator::Estimate estimate{};
+			for (int frame = 0; frame < 3; ++frame)
+			{
+				aa.execute_fft(fa, std::span{audio}.subspan(frame * hop, window));
+				aa.compute_amplitudes(fa);
+				estimate = aa.estimate_peak_frequency(fa, sample_rate_hz, from_hz, to_hz, estimator, hop);
+			}
+			max_error_hz = std::max(max_error_hz, std::abs(estimate.frequency_hz - freq_hz));
+		}
+
+		const auto within = max_error_hz <= method.max_error_hz;
+		ok &= within;
+		std::println(
+			"{:>14}{:>14.3f}{:>14.4f}{:>10.2f}{:>10}",
+			method.name,
+			estimate_us,
+			max_error_hz,
+			method.max_error_hz,
+			within ? "ok" : "FAILED");
+	}
+
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
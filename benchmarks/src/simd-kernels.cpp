@@ -0,0 +1,112 @@
+// Times every avz::simd kernel for each instruction set the CPU supports, and verifies
+// that each matches the scalar kernels, and that the dB kernels are within 1.5e-4 dB of std::log10.
+// Exits with failure if any doesn't.
+// usage: simd-kernels [iterations]
+#include "BenchmarkFramework.hpp"
+#include <avz/analysis.hpp>
+
+#include <cmath>
+#include <print>
+
+using namespace avz::benchmarks;
+using avz::simd::Isa;
+
+namespace
+{
+
+float max_abs_diff(std::span<const float> a, std::span<const float> b)
+{
+	float diff{};
+	for (size_t i = 0; i < a.size(); ++i)
+		diff = std::max(diff, std::abs(a[i] - b[i]));
+	return diff;
+}
+
+} // namespace
+
+int main(const int argc, const char *const *const argv)
+{
+	const auto iterations = parse_iterations(argc, argv, 10000);
+	const auto detected = avz::simd::detect_isa();
+	bool ok{true};
+
+	std::println("detected: {}", avz::simd::isa_name(detected));
+	std::println(
+		"{:>8}{:>8}{:>14}{:>12}{:>16}{:>12}{:>10}{:>8}",
+		"bins",
+		"isa",
+		"magnitude_us",
+		"power_us",
+		"magnitude_max_us",
+		"to_db_us",
+		"flux_us",
+		"status");
+
+	// largest FFT the examples run
+	const auto n = example_fft_sizes().back() / 2 + 1;
+
+	std::vector<float> noise(2 * n);
+	fill_noise(noise);
+	const std::span in{(const std::complex<float> *)noise.data(), (size_t)n};
+
+	// scalar results are the reference
+	std::vector<float> ref_mag(n), ref_pow(n), ref_db(n);
+	avz::simd::set_isa(Isa::Scalar);
+	avz::simd::magnitude(ref_mag, in, 1.f / n);
+	avz::simd::power(ref_pow, in, 1.f / n);
+	avz::simd::amplitude_to_db(ref_db, ref_mag);
+	// the power spectrum stands in for the previous frame
+	const auto ref_flux = avz::simd::spectral_flux(ref_mag, ref_pow);
+
+	for (const auto isa : {Isa::Scalar, Isa::Neon, Isa::Avx2, Isa::Avx512})
+	{
+		try
+		{
+			avz::simd::set_isa(isa);
+		}
+		catch (const std::invalid_argument &)
+		{
+			continue;
+		}
+
+		std::vector<float> mag(n), pow(n), mag_max(n), db(n);
+		const auto magnitude_us = time_us(iterations, [&] { avz::simd::magnitude(mag, in, 1.f / n); });
+		const auto power_us = time_us(iterations, [&] { avz::simd::power(pow, in, 1.f / n); });
+		float max{};
+		const auto magnitude_max_us =
+			time_us(iterations, [&] { max = avz::simd::magnitude_max(mag_max, in, 1.f / n); });
+		const auto to_db_us = time_us(iterations, [&] { avz::simd::amplitude_to_db(db, ref_mag); });
+		float flux{};
+		const auto flux_us = time_us(iterations, [&] { flux = avz::simd::spectral_flux(ref_mag, ref_pow); });
+
+		// relative tolerance for the linear kernels, absolute (in dB) for the log approximation
+		const auto ref_max = *std::ranges::max_element(ref_mag);
+		const auto tolerance = 1e-5f * ref_max;
+		const bool matches = max_abs_diff(mag, ref_mag) <= tolerance && max_abs_diff(pow, ref_pow) <= tolerance
+			&& max_abs_diff(mag_max, ref_mag) <= tolerance && std::abs(max - ref_max) <= tolerance
+			&& max_abs_diff(db, ref_db) <= 1e-3f && std::abs(flux - ref_flux) <= 1e-5f * ref_flux;
+		ok &= matches;
+
+		std::println(
+			"{:>8}{:>8}{:>14.2f}{:>12.2f}{:>16.2f}{:>12.2f}{:>10.2f}{:>8}",
+			n,
+			avz::simd::isa_name(isa),
+			magnitude_us,
+			power_us,
+			magnitude_max_us,
+			to_db_us,
+			flux_us,
+			matches ? "ok" : "MISMATCH");
+	}
+
+	avz::simd::set_isa(detected);
+	// the log2 polynomial is off by up to 1.7e-5, i.e. 20 * log10(2) * 1.7e-5 = 1.02e-4 dB, plus float rounding
+	float db_error{};
+	for (int i = 0; i < n; ++i)
+		db_error = std::max(db_error, std::abs(ref_db[i] - 20 * std::log10(std::max(ref_mag[i], 1e-6f))));
+	const auto db_ok = db_error <= 1.5e-4f;
+	ok &= db_ok;
+	std::println("dB error: {:.2e} dB, {}", db_error, db_ok ? "ok" : "FAILED");
+
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
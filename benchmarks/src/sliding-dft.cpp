@@ -0,0 +1,115 @@
+// Times one frame of SlidingDftAnalyzer (sliding a hop of new audio through the tracked bass bins) against a
+// FrequencyAnalyzer transform of the whole window, and verifies that after hundreds of hops and many Goertzel
+// re-anchors, the sliding bins still match the transform's. Exits with failure if they don't.
+// usage: sliding-dft [iterations]
+#include "BenchmarkFramework.hpp"
+#include <avz/analysis.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <print>
+#include <tuple>
+
+using namespace avz::benchmarks;
+using WindowFunction = avz::FrequencyAnalyzer::WindowFunction;
+
+namespace
+{
+
+constexpr int sample_rate_hz = 48000, from_hz = 20, to_hz = 250;
+
+// 0.25s windows moving at 60 fps, for 10 seconds
+constexpr int window = sample_rate_hz / 4, hop = sample_rate_hz / 60, frames = 600;
+
+// largest difference between the sliding bins and the transform's, relative to the loudest of them
+float max_relative_error(const avz::SlidingDftAnalyzer &sdft, avz::AudioAnalyzer &aa)
+{
+	const auto sliding = sdft.get_amplitudes();
+	const auto reference = aa.get_amplitudes().subspan(sdft.get_first_bin(), sliding.size());
+	float max_error{}, max_amp{};
+	for (size_t k = 0; k < sliding.size(); ++k)
+	{
+		max_error = std::max(max_error, std::abs(sliding[k] - reference[k]));
+		max_amp = std::max(max_amp, reference[k]);
+	}
+	return max_error / max_amp;
+}
+
+} // namespace
+
+int main(const int argc, const char *const *const argv)
+{
+	const auto iterations = parse_iterations(argc, argv, 1000);
+	bool ok{true};
+
+	// noise under a few bass tones
+	std::vector<float> audio(window + (frames + iterations + 1) * hop);
+	fill_noise(audio);
+	for (size_t i = 0; i < audio.size(); ++i)
+		for (const float freq_hz : {41.2f, 55.f, 98.f, 196.f})
+			audio[i] += sinf(2 * M_PI * freq_hz * i / sample_rate_hz);
+	const auto frame_audio = [&](const int frame) { return std::span{audio}.subspan(frame * hop, window); };
+
+	{
+		avz::SlidingDftAnalyzer sdft{window, sample_rate_hz, from_hz, to_hz};
+		avz::FrequencyAnalyzer fa{window};
+		avz::AudioAnalyzer aa;
+		int frame{};
+		sdft.update(frame_audio(frame), hop);
+		const auto sliding_us = time_us(
+			iterations,
+			[&]
+			{
+				sdft.update(frame_audio(++frame), hop);
+				sdft.compute_amplitudes();
+			});
+		const auto fft_us = time_us(
+			iterations,
+			[&]
+			{
+				aa.execute_fft(fa, frame_audio(frame));
+				aa.compute_amplitudes(fa);
+			});
+		std::println("{:>8}{:>8}{:>12}{:>12}", "window", "hop", "sliding_us", "fft_us");
+		std::println("{:>8}{:>8}{:>12.2f}{:>12.2f}", window, hop, sliding_us, fft_us);
+	}
+
+	// without a window the sliding dft is exactly the transform's bins. the windows are applied in the frequency
+	// domain in their periodic form, while FrequencyAnalyzer uses the symmetric form, so they differ slightly.
+	const std::tuple<WindowFunction, const char *, float> windows[]{
+		{WindowFunction::None, "none", 1e-5f},
+		{WindowFunction::Hanning, "hanning", 1e-3f},
+		{WindowFunction::Blackman, "blackman", 1e-3f}};
+
+	std::println("{:>10}{:>12}{:>12}{:>10}", "window", "reanchor", "rel_error", "status");
+	for (const auto &[window_func, name, tolerance] : windows)
+		// the default re-anchor interval, and one that doesn't line up with the hop
+		for (const int reanchor : {window, 997})
+		{
+			avz::SlidingDftAnalyzer sdft{window, sample_rate_hz, from_hz, to_hz};
+			sdft.set_window_func(window_func);
+			sdft.set_reanchor_interval(reanchor);
+			avz::FrequencyAnalyzer fa{window};
+			fa.set_window_func(window_func);
+			avz::AudioAnalyzer aa;
+
+			// compare every 100 frames, so the drift of the sliding updates between re-anchors shows up
+			float error{};
+			for (int frame = 0; frame <= frames; ++frame)
+			{
+				sdft.update(frame_audio(frame), hop);
+				if (frame % 100)
+					continue;
+				sdft.compute_amplitudes();
+				aa.execute_fft(fa, frame_audio(frame));
+				aa.compute_amplitudes(fa);
+				error = std::max(error, max_relative_error(sdft, aa));
+			}
+
+			const auto matches = error <= tolerance;
+			ok &= matches;
+			std::println("{:>10}{:>12}{:>12.2e}{:>10}", name, reanchor, error, matches ? "ok" : "MISMATCH");
+		}
+
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
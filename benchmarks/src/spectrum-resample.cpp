@@ -0,0 +1,84 @@
+// Times resample_spectrum with a precomputed SpectrumResamplePlan against the Interpolator overload, for the
+// bass-nation example's grid and a few others, and verifies that both give the same output for the types they
+// share a curve for, and stay close to the natural spline for CSPLINE. Exits with failure if they don't.
+// usage: spectrum-resample [iterations]
+#include "BenchmarkFramework.hpp"
+#include <avz/analysis.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <print>
+#include <tuple>
+
+using namespace avz::benchmarks;
+using Type = avz::Interpolator::InterpolationType;
+
+int main(const int argc, const char *const *const argv)
+{
+	const auto iterations = parse_iterations(argc, argv, 10000);
+	bool ok{true};
+
+	struct Case
+	{
+		const char *name;
+		float sample_rate_hz;
+		int fft_size, out_size;
+		float start_freq, end_freq;
+	};
+	const Case cases[]{
+		// bass-nation: 0.25s at 48kHz decimated by 24, onto a 1920 pixel wide window
+		{"bass", 2000, 500, 960, 20, 135},
+		// fewer output points than bins
+		{"full", 48000, 4096, 512, 0, 24000},
+		// a range ending on the last bin, and a single output point
+		{"top", 44100, 1102, 100, 20000, 22050},
+		{"single", 44100, 2048, 1, 440, 440},
+	};
+
+	// LINEAR and CSPLINE_HERMITE are the same curves, evaluated differently; CSPLINE is approximated
+	const std::tuple<Type, const char *, float> types[]{
+		{Type::LINEAR, "linear", 1e-5f}, {Type::CSPLINE_HERMITE, "hermite", 1e-5f}, {Type::CSPLINE, "cspline", 0.15f}};
+
+	std::println("{:>8}{:>10}{:>14}{:>10}{:>12}{:>10}", "grid", "type", "interp_us", "plan_us", "rel_error", "status");
+	for (const auto &[name, sample_rate_hz, fft_size, out_size, start_freq, end_freq] : cases)
+	{
+		std::vector<float> in(fft_size / 2 + 1), expected(out_size), out(out_size);
+		fill_noise(in);
+		for (auto &v : in)
+			v = std::abs(v);
+
+		for (const auto &[type, type_name, tolerance] : types)
+		{
+			avz::Interpolator interpolator;
+			interpolator.set_interp_type(type);
+			avz::SpectrumResamplePlan plan{type};
+			const auto interp_us = time_us(
+				iterations,
+				[&]
+				{
+					avz::util::resample_spectrum(
+						expected, in, sample_rate_hz, fft_size, start_freq, end_freq, interpolator);
+				});
+			const auto plan_us = time_us(
+				iterations,
+				[&] { avz::util::resample_spectrum(out, in, sample_rate_hz, fft_size, start_freq, end_freq, plan); });
+
+			float max_error{};
+			for (int i = 0; i < out_size; ++i)
+				max_error = std::max(max_error, std::abs(out[i] - expected[i]));
+			const auto error = max_error / std::ranges::max(in);
+			const auto matches = error <= tolerance;
+			ok &= matches;
+			std::println(
+				"{:>8}{:>10}{:>14.2f}{:>10.2f}{:>12.2e}{:>10}",
+				name,
+				type_name,
+				interp_us,
+				plan_us,
+				error,
+				matches ? "ok" : "MISMATCH");
+		}
+	}
+
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
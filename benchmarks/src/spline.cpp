@@ -0,0 +1,239 @@
+// Times fitting and sampling a Spline the way spectrum gap-filling does (same knots every frame, then new knots
+// every frame) for each spline type, and verifies the fits: the natural spline against a double-precision
+// reference, no overshoot from the monotone spline on step data, splines of fewer than 3 knots, and refits that
+// switch between knot positions. Exits with failure if any is wrong.
+// usage: spline [iterations]
+#include "BenchmarkFramework.hpp"
+#include <avz/analysis.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <print>
+
+using namespace avz::benchmarks;
+using Type = avz::Spline::Type;
+
+namespace
+{
+
+// natural cubic spline in double precision, solved directly for every fit: the same system as Spline, so the
+// two should agree to single precision
+struct ReferenceSpline
+{
+	std::vector<double> x, y, b, c, d;
+
+	ReferenceSpline(const std::span<const float> xs, const std::span<const float> ys)
+		: x(xs.begin(), xs.end()),
+		  y(ys.begin(), ys.end())
+	{
+		const auto n = x.size();
+		std::vector<double> h(n - 1), diag(n, 1), upper(n), rhs(n);
+		for (size_t i = 0; i < n - 1; ++i)
+			h[i] = x[i + 1] - x[i];
+		for (size_t i = 1; i < n - 1; ++i)
+		{
+			diag[i] = 2 * (h[i - 1] + h[i]);
+			rhs[i] = 3 * ((y[i + 1] - y[i]) / h[i] - (y[i] - y[i - 1]) / h[i - 1]);
+		}
+
+		// thomas algorithm, with c[0] = c[n - 1] = 0
+		c.assign(n, 0);
+		for (size_t i = 1; i < n - 1; ++i)
+		{
+			const auto pivot = diag[i] - h[i - 1] * upper[i - 1];
+			upper[i] = h[i] / pivot;
+			rhs[i] = (rhs[i] - h[i - 1] * rhs[i - 1]) / pivot;
+		}
+		for (size_t i = n - 2; i > 0; --i)
+			c[i] = rhs[i] - upper[i] * c[i + 1];
+
+		b.resize(n - 1);
+		d.resize(n - 1);
+		for (size_t i = 0; i < n - 1; ++i)
+		{
+			b[i] = (y[i + 1] - y[i]) / h[i] - h[i] * (2 * c[i] + c[i + 1]) / 3;
+			d[i] = (c[i + 1] - c[i]) / (3 * h[i]);
+		}
+	}
+
+	// only between the first and last knot
+	double operator()(const double X) const
+	{
+		const auto i = std::clamp<size_t>(std::ranges::upper_bound(x, X) - x.begin(), 1, x.size() - 1) - 1;
+		const auto dx = X - x[i];
+		return y[i] + dx * (b[i] + dx * (c[i] + dx * d[i]));
+	}
+};
+
+// knots at increasing, unevenly spaced positions, like the nonzero bins of a sparse spectrum
+std::vector<float> knot_positions(const int n, const unsigned seed)
+{
+	std::vector<float> x(n);
+	fill_noise(x, seed);
+	float position{};
+	for (auto &v : x)
+		v = position += 1.5f + v;
+	return x;
+}
+
+// largest difference between `spline` and the reference over every knot interval, relative to the largest knot
+float natural_error(const avz::Spline &spline, const std::span<const float> x, const std::span<const float> y)
+{
+	const ReferenceSpline reference{x, y};
+	float max_error{};
+	for (size_t i = 0; i + 1 < x.size(); ++i)
+		for (const float t : {0.f, 0.25f, 0.5f, 0.75f})
+		{
+			const auto X = x[i] + t * (x[i + 1] - x[i]);
+			max_error = std::max(max_error, (float)std::abs(spline(X) - reference(X)));
+		}
+	return max_error / std::ranges::max(y, {}, [](const float v) { return std::abs(v); });
+}
+
+} // namespace
+
+int main(const int argc, const char *const *const argv)
+{
+	const auto iterations = parse_iterations(argc, argv, 10000);
+	constexpr auto tolerance = 1e-4f;
+	bool ok{true};
+
+	// a spectrum of 1000 bins with a third of them empty, filled in at the empty bins
+	constexpr int knots = 667;
+	const auto x = knot_positions(knots, 1), other_x = knot_positions(knots, 2);
+	std::vector<float> y(knots), other_y(knots);
+	fill_noise(y, 3);
+	fill_noise(other_y, 4);
+	std::vector<float> xs(knots / 2), out(xs.size());
+	for (size_t i = 0; i < xs.size(); ++i)
+		xs[i] = x[2 * i] + 0.5f;
+
+	const std::pair<Type, const char *> types[]{
+		{Type::LINEAR, "linear"}, {Type::NATURAL, "natural"}, {Type::HERMITE, "hermite"}, {Type::MONOTONE, "monotone"}};
+
+	std::println("{:>10}{:>8}{:>16}{:>14}", "type", "knots", "same_knots_us", "new_knots_us");
+	for (const auto &[type, name] : types)
+	{
+		avz::Spline spline;
+		spline.set_type(type);
+		const auto same_us = time_us(
+			iterations,
+			[&]
+			{
+				spline.set_points(x, y);
+				spline.sample_sorted(xs, out);
+			});
+		int frame{};
+		const auto new_us = time_us(
+			iterations,
+			[&]
+			{
+				spline.set_points(++frame % 2 ? x : other_x, y);
+				spline.sample_sorted(xs, out);
+			});
+		std::println("{:>10}{:>8}{:>16.2f}{:>14.2f}", name, knots, same_us, new_us);
+	}
+
+	// natural spline against the reference, refit with the same knots (reusing the cached factorization),
+	// different knots, then the first knots again
+	{
+		avz::Spline spline;
+		float error{};
+		spline.set_points(x, y);
+		error = std::max(error, natural_error(spline, x, y));
+		spline.set_points(x, other_y);
+		error = std::max(error, natural_error(spline, x, other_y));
+		spline.set_points(other_x, y);
+		error = std::max(error, natural_error(spline, other_x, y));
+		spline.set_points(x, y);
+		error = std::max(error, natural_error(spline, x, y));
+
+		// uniform knots, and knots at the same positions passed explicitly
+		std::vector<float> uniform_x(knots);
+		for (int i = 0; i < knots; ++i)
+			uniform_x[i] = i;
+		spline.set_values(other_y);
+		error = std::max(error, natural_error(spline, uniform_x, other_y));
+		spline.set_points(uniform_x, y);
+		error = std::max(error, natural_error(spline, uniform_x, y));
+
+		const auto matches = error <= tolerance;
+		ok &= matches;
+		std::println("natural vs double-precision reference: {:.2e} {}", error, matches ? "ok" : "MISMATCH");
+	}
+
+	// every type goes straight through knots on a line
+	{
+		bool straight{true};
+		std::vector<float> line(knots);
+		for (int i = 0; i < knots; ++i)
+			line[i] = 2 * x[i] - 3;
+		for (const auto &[type, name] : types)
+		{
+			avz::Spline spline;
+			spline.set_type(type);
+			spline.set_points(x, line);
+			for (const auto X : xs)
+				straight &= std::abs(spline(X) - (2 * X - 3)) <= tolerance * std::abs(line.back());
+		}
+		ok &= straight;
+		std::println("straight lines: {}", straight ? "ok" : "FAILED");
+	}
+
+	// steps: the monotone spline stays within each step and never turns back, where the natural one rings
+	{
+		const std::vector<float> step_x{0, 1, 2, 3, 4, 5, 6, 7}, step_y{0, 0, 0, 1, 1, 1, 3, 3};
+		avz::Spline monotone, natural;
+		monotone.set_type(Type::MONOTONE);
+		monotone.set_points(step_x, step_y);
+		natural.set_points(step_x, step_y);
+
+		bool monotonic{true};
+		float natural_overshoot{}, prev{monotone(0)};
+		for (float X = 0; X <= 7; X += 1.f / 64)
+		{
+			const auto v = monotone(X);
+			const auto segment = std::min<size_t>(X, 6);
+			monotonic &= v >= prev && v >= step_y[segment] && v <= step_y[segment + 1];
+			prev = v;
+			natural_overshoot = std::max(natural_overshoot, natural(X) - step_y[segment + 1]);
+		}
+		// otherwise the step data isn't testing anything
+		monotonic &= natural_overshoot > 0.01f;
+		ok &= monotonic;
+		std::println("monotone steps: {}", monotonic ? "ok" : "FAILED");
+	}
+
+	// fewer than 3 knots: 0 without knots, constant through one, a line through two (extended past both ends)
+	{
+		bool small{true};
+		for (const auto &[type, name] : types)
+		{
+			avz::Spline spline;
+			spline.set_type(type);
+			spline.set_points({}, {});
+			small &= spline(1) == 0;
+			float samples[2]{1, 1};
+			spline.sample_sorted(std::vector<float>{0, 1}, samples);
+			small &= samples[0] == 0 && samples[1] == 0;
+
+			spline.set_points(std::vector<float>{2}, std::vector<float>{5});
+			small &= spline(-1) == 5 && spline(2) == 5 && spline(10) == 5;
+
+			spline.set_points(std::vector<float>{1, 3}, std::vector<float>{1, 5});
+			for (const float X : {-1.f, 1.f, 2.f, 2.5f, 3.f, 6.f})
+				small &= std::abs(spline(X) - (2 * X - 1)) <= 1e-5f;
+
+			// and back to many knots on the same storage, where the natural fit factorizes again
+			if (type == Type::NATURAL)
+			{
+				spline.set_points(x, y);
+				small &= natural_error(spline, x, y) <= tolerance;
+			}
+		}
+		ok &= small;
+		std::println("fewer than 3 knots: {}", small ? "ok" : "FAILED");
+	}
+
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,85 @@
+// Compares the packed stereo FFT (both channels in one complex FFT) against the batched real FFT,
+// and verifies that both produce the same amplitudes. Exits with failure if they don't.
+// usage: stereo-fft [iterations]
+#include "BenchmarkFramework.hpp"
+#include <avz/analysis.hpp>
+
+#include <cmath>
+#include <print>
+
+using namespace avz::benchmarks;
+
+namespace
+{
+
+// largest difference between the two paths' amplitudes, relative to the largest amplitude
+float max_relative_error(const avz::StereoAnalyzer &packed, const avz::StereoAnalyzer &batched)
+{
+	float max_error{}, max_amp{};
+	for (int ch = 0; ch < 2; ++ch)
+	{
+		const auto a = packed.get_amplitudes(ch);
+		const auto b = batched.get_amplitudes(ch);
+		if (a.size() != b.size())
+			return INFINITY;
+		for (size_t i = 0; i < a.size(); ++i)
+		{
+			max_error = std::max(max_error, std::abs(a[i] - b[i]));
+			max_amp = std::max(max_amp, b[i]);
+		}
+	}
+	return max_error / max_amp;
+}
+
+} // namespace
+
+int main(const int argc, const char *const *const argv)
+{
+	const auto iterations = parse_iterations(argc, argv, 1000);
+	constexpr auto tolerance = 1e-4f;
+	bool ok{true};
+
+	std::println(
+		"{:>8}{:>10}{:>14}{:>14}{:>10}{:>12}", "size", "policy", "batched_us", "packed_us", "speedup", "rel_error");
+
+	for (const auto policy : {avz::FrequencyAnalyzer::SizePolicy::Exact, avz::FrequencyAnalyzer::SizePolicy::Smooth})
+		for (const auto n : example_fft_sizes())
+		{
+			avz::FrequencyAnalyzer fa{n, policy};
+			std::vector<float> audio(2 * n);
+			fill_noise(audio);
+
+			avz::StereoAnalyzer packed, batched;
+			batched.set_packed_stereo(false);
+
+			const auto batched_us = time_us(
+				iterations,
+				[&]
+				{
+					batched.execute_fft(fa, audio);
+					batched.compute_amplitudes();
+				});
+			const auto packed_us = time_us(
+				iterations,
+				[&]
+				{
+					packed.execute_fft(fa, audio);
+					packed.compute_amplitudes();
+				});
+
+			const auto error = max_relative_error(packed, batched);
+			ok &= error <= tolerance;
+
+			std::println(
+				"{:>8}{:>10}{:>14.2f}{:>14.2f}{:>9.2f}x{:>12.2e}{}",
+				n,
+				policy == avz::FrequencyAnalyzer::SizePolicy::Exact ? "exact" : "smooth",
+				batched_us,
+				packed_us,
+				batched_us / packed_us,
+				error,
+				error <= tolerance ? "" : "  MISMATCH");
+		}
+
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,126 @@
+// Times computing every window table at the example programs' window sizes, and getting a cached one, and verifies
+// every table: symmetric, peaking at 1, and with the coherent gain (mean value) that the window's definition gives.
+// Exits with failure if any table is off.
+// usage: window-cache [iterations]
+#include "BenchmarkFramework.hpp"
+#include <avz/analysis.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <print>
+
+using namespace avz::benchmarks;
+using WindowFunction = avz::FrequencyAnalyzer::WindowFunction;
+
+namespace
+{
+
+struct Window
+{
+	const char *name;
+	WindowFunction window_func;
+	float kaiser_beta;
+	// cosine-sum coefficients a0, a1, ... of w[n] = sum_k (-1)^k a_k cos(2 pi k n / (N - 1)); empty for Kaiser
+	std::vector<double> coeffs;
+};
+
+// mean value of a symmetric window of `size` values. for a cosine sum, every cosine term averages to 0 over the
+// first N - 1 values, and the last value repeats the first: a0 + (w[0] - a0) / N. for Kaiser, the trapezoid rule
+// over the integral of I0(beta sqrt(1 - x^2)) / I0(beta) on [-1, 1], which is 2 sinh(beta) / (beta I0(beta)).
+double coherent_gain(const Window &w, const int size)
+{
+	if (w.coeffs.empty())
+	{
+		const auto beta = (double)w.kaiser_beta, i0 = std::cyl_bessel_i(0., beta);
+		const auto integral = 2 * sinh(beta) / (beta * i0), end_value = 1 / i0;
+		return ((size - 1) / 2. * integral + end_value) / size;
+	}
+
+	double first{};
+	for (size_t k = 0; k < w.coeffs.size(); ++k)
+		first += k % 2 ? -w.coeffs[k] : w.coeffs[k];
+	return w.coeffs[0] + (first - w.coeffs[0]) / size;
+}
+
+} // namespace
+
+int main(const int argc, const char *const *const argv)
+{
+	const auto iterations = parse_iterations(argc, argv, 1000);
+	constexpr auto tolerance = 1e-5f;
+	bool ok{true};
+
+	const Window windows[]{
+		{"hanning", WindowFunction::Hanning, 0, {0.5, 0.5}},
+		{"hamming", WindowFunction::Hamming, 0, {0.54, 0.46}},
+		{"blackman", WindowFunction::Blackman, 0, {0.42, 0.5, 0.08}},
+		{"blackman-harris", WindowFunction::BlackmanHarris, 0, {0.35875, 0.48829, 0.14128, 0.01168}},
+		{"flat-top",
+		 WindowFunction::FlatTop,
+		 0,
+		 {0.21557895, 0.41663158, 0.277263158, 0.083578947, 0.006947368}},
+		{"kaiser2", WindowFunction::Kaiser, 2, {}},
+		{"kaiser8.6", WindowFunction::Kaiser, 8.6f, {}},
+		{"kaiser14", WindowFunction::Kaiser, 14, {}}};
+
+	// the largest example window, computed and then cached
+	const auto example_size = example_fft_sizes().back();
+	std::println("{:>16}{:>8}{:>14}{:>10}", "window", "size", "compute_us", "get_us");
+	for (const auto &w : windows)
+	{
+		std::vector<float> table(example_size);
+		const auto compute_us =
+			time_us(iterations, [&] { avz::WindowCache::compute(table, w.window_func, w.kaiser_beta); });
+		// held, so every get below finds it
+		const auto held = avz::WindowCache::instance().get(w.window_func, example_size, w.kaiser_beta);
+		const auto get_us =
+			time_us(iterations, [&] { avz::WindowCache::instance().get(w.window_func, example_size, w.kaiser_beta); });
+		std::println("{:>16}{:>8}{:>14.2f}{:>10.3f}", w.name, example_size, compute_us, get_us);
+	}
+
+	// odd sizes have a center value, which is exactly the peak; even sizes peak just below 1, between two values.
+	// the trapezoid rule is only within the tolerance of Kaiser's mean from ~1000 values, so shorter windows only have
+	// to be symmetric and peak at 1.
+	auto sizes = example_fft_sizes();
+	sizes.insert(sizes.begin(), {1, 2, 7, 64, 1001});
+
+	std::println(
+		"{:>16}{:>8}{:>12}{:>10}{:>12}{:>12}{:>10}",
+		"window",
+		"size",
+		"asymmetry",
+		"peak",
+		"gain",
+		"expected",
+		"status");
+	for (const auto &w : windows)
+		for (const auto size : sizes)
+		{
+			const auto table = avz::WindowCache::instance().get(w.window_func, size, w.kaiser_beta);
+			const std::span<const float> values = *table;
+
+			float asymmetry{};
+			for (int i = 0; i < size / 2; ++i)
+				asymmetry = std::max(asymmetry, std::abs(values[i] - values[size - 1 - i]));
+			const auto peak = std::ranges::max(values);
+			const auto gain = std::accumulate(values.begin(), values.end(), 0.) / size;
+			const auto expected_gain = coherent_gain(w, size);
+
+			const auto peak_ok = size % 2 ? std::abs(peak - 1) <= tolerance : peak <= 1 + tolerance;
+			const auto gain_ok = size < 1000 || std::abs(gain - expected_gain) <= tolerance;
+			const auto matches = asymmetry <= tolerance && peak_ok && gain_ok;
+			ok &= matches;
+			std::println(
+				"{:>16}{:>8}{:>12.2e}{:>10.6f}{:>12.6f}{:>12.6f}{:>10}",
+				w.name,
+				size,
+				asymmetry,
+				peak,
+				gain,
+				expected_gain,
+				matches ? "ok" : "MISMATCH");
+		}
+
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -1,11 +1,14 @@
 #pragma once
 
+#include <avz/analysis/BandEnvelopeAnalyzer.hpp>
 #include <avz/gfx.hpp>
 #include <avz/main.hpp>
 #include <avz/media.hpp>
 
 #include <SFML/Graphics.hpp>
 #include <argparse/argparse.hpp>
+#include <array>
+#include <span>
 
 namespace avz::examples
 {
@@ -22,8 +25,11 @@ struct ExampleConfig
 	int framerate = 60;
 	float audio_duration_sec = 0.25f;
 	float media_start_time_sec = 0.0f;
+	float prefetch_sec = 0.0f;
 	bool profiler_enabled = false;
 	std::string font_path;
+	std::string fft_backend;
+	std::string fftw_wisdom_path;
 	std::string window_title;
 };
 
@@ -52,14 +58,37 @@ ExampleConfig parse_arguments(
 class ExampleBase : public avz::Base
 {
 public:
+#if defined(LIBAVZ_MEDIA_LIBAV)
+	avz::LibavMedia media;
+#else
 	avz::FfmpegPopenMedia media;
+#endif
 	int sample_rate_hz;
 	int num_channels;
 
+	// audio frames per video frame: how far the audio buffer moves between calls to update()
+	int afpvf;
+
 	ExampleBase(const ExampleConfig &config);
-	virtual ~ExampleBase() = default;
+	virtual ~ExampleBase();
+
+private:
+	std::string fftw_wisdom_path;
 };
 
+/**
+ * @brief Low, mid, and high bass bands, for examples driving a particle system with a `BandEnvelopeAnalyzer`
+ */
+inline constexpr std::array<avz::BandEnvelopeAnalyzer::Band, 3> bass_bands{{{0, 83}, {83, 166}, {166, 250}}};
+
+/**
+ * @brief Get the `additional_displacement` to pass to `ParticleSystem::update` from the envelopes of `bass_bands`
+ *
+ * Each band is weighted by its position through a Gompertz function, so lower bass frequencies boost the
+ * particles more than higher ones, and the largest weighted envelope is returned.
+ */
+float bass_displacement(std::span<const float> envelopes);
+
 /**
  * @brief Run an example visualization
  *
@@ -8,9 +8,6 @@ struct BasicSpectrum : ExampleBase
 {
 	int fft_size{};
 
-	// buffer for extraction of first channel
-	std::vector<float> a;
-
 	avz::ColorSettings color;
 	avz::SpectrumDrawable spectrum;
 	avz::FrequencyAnalyzer fa;
@@ -33,12 +30,8 @@ struct BasicSpectrum : ExampleBase
 
 	void update(std::span<const float> audio_buffer) override
 	{
-		// make sure we can fit one channel of audio
-		a.resize(fft_size);
-
-		// extract first channel of audio and perform FFT (needed in case media file has stereo audio)
-		capture_time("strided_copy", avz::util::extract_channel(a, audio_buffer, num_channels, 0));
-		capture_time("fft", aa.execute_fft(fa, a));
+		// perform FFT on the first channel of audio, gathered straight from the interleaved buffer
+		capture_time("fft", aa.execute_fft(fa, audio_buffer, num_channels, 0));
 		capture_time("amplitudes", aa.compute_amplitudes(fa));
 
 		// finally, pass the data to SpectrumDrawable to draw to the screen!
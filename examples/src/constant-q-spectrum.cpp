@@ -0,0 +1,44 @@
+#include "ExampleFramework.hpp"
+#include <avz/analysis.hpp>
+#include <avz/gfx.hpp>
+
+using namespace avz::examples;
+
+struct ConstantQSpectrum : ExampleBase
+{
+	avz::ColorSettings color;
+	avz::SpectrumDrawable spectrum;
+
+	// 8 octaves of 24 bins from A0 (27.5 Hz) to A8 (7040 Hz): every octave is analyzed by a 512-point FFT
+	// at its own decimated sample rate, instead of one FFT large enough for the lowest octave
+	avz::ConstantQAnalyzer cq;
+
+	ConstantQSpectrum(const ExampleConfig &config)
+		: ExampleBase{config},
+		  spectrum{{{}, (sf::Vector2i)size}, color},
+		  cq{(float)sample_rate_hz, 27.5f, 8, 24}
+	{
+		// stretch the bins across the window, rounding the bar width up so there are never more bars than bins
+		const int bins = cq.get_bin_count();
+		spectrum.set_bar_width(((int)size.x + bins - 1) / bins);
+		spectrum.set_bar_spacing(0);
+		spectrum.set_multiplier(4);
+		emplace_layer<avz::Layer>("spectrum").add_draw({spectrum});
+	}
+
+	void update(std::span<const float> audio_buffer) override
+	{
+		// push the audio that arrived since the last frame through the octave pyramid
+		capture_time("decimate", cq.update(audio_buffer, afpvf, num_channels, 0));
+		capture_time("constant_q", cq.compute_amplitudes());
+
+		// the bins are already musically spaced, so no bin packing or interpolation is needed
+		capture_time("spectrum_update", spectrum.update(cq.get_amplitudes()));
+	}
+};
+
+LIBAVZ_EXAMPLE_MAIN_CUSTOM(
+	ConstantQSpectrum,
+	"Constant-Q spectrum from an octave-wise multirate pyramid",
+	0.1f,
+	viz.cq.get_input_window_size())
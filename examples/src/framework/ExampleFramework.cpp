@@ -1,4 +1,11 @@
 #include "ExampleFramework.hpp"
+#include <avz/analysis/fft.hpp>
+#if defined(LIBAVZ_FFT_FFTW)
+#include <avz/analysis/FftwPlanCache.hpp>
+#endif
+
+#include <algorithm>
+#include <cmath>
 
 namespace avz::examples
 {
@@ -41,6 +48,11 @@ ExampleConfig parse_arguments(
 		.default_value(0.0f)
 		.scan<'g', float>();
 
+	parser.add_argument("--prefetch")
+		.help("Decode this much audio ahead on a separate thread (seconds, 0 to disable)")
+		.default_value(0.0f)
+		.scan<'g', float>();
+
 	parser.add_argument("-p", "--profiler")
 		.help("Enable performance profiler")
 		.flag();
@@ -48,6 +60,14 @@ ExampleConfig parse_arguments(
 	parser.add_argument("--font")
 		.help("Path to font file for profiler")
 		.default_value("");
+
+	parser.add_argument("--fft-backend")
+		.help("FFT library to use: fftw, pocketfft or pffft (default: the build's default)")
+		.default_value("");
+
+	parser.add_argument("--fftw-wisdom")
+		.help("FFTW wisdom cache file: enables FFTW_MEASURE plans, loaded on start and saved on exit")
+		.default_value("");
 	// clang-format on
 
 	try
@@ -73,8 +93,11 @@ ExampleConfig parse_arguments(
 	config.framerate = parser.get<int>("--framerate");
 	config.audio_duration_sec = parser.get<float>("--fft-window");
 	config.media_start_time_sec = parser.get<float>("--media-start");
+	config.prefetch_sec = parser.get<float>("--prefetch");
 	config.profiler_enabled = parser.get<bool>("--profiler");
 	config.font_path = parser.get<std::string>("--font");
+	config.fft_backend = parser.get<std::string>("--fft-backend");
+	config.fftw_wisdom_path = parser.get<std::string>("--fftw-wisdom");
 	config.window_title = argv[0];
 
 	// Validate values
@@ -98,6 +121,11 @@ ExampleConfig parse_arguments(
 		std::cerr << "Error: Media start time cannot be negative\n";
 		std::exit(EXIT_FAILURE);
 	}
+	if (config.prefetch_sec < 0.0f)
+	{
+		std::cerr << "Error: Prefetch duration cannot be negative\n";
+		std::exit(EXIT_FAILURE);
+	}
 
 	return config;
 }
@@ -106,8 +134,46 @@ ExampleBase::ExampleBase(const ExampleConfig &config)
 	: Base{config.size},
 	  media{config.media_path, config.media_start_time_sec},
 	  sample_rate_hz{media.audio_sample_rate()},
-	  num_channels{media.audio_channels()}
+	  num_channels{media.audio_channels()},
+	  afpvf{sample_rate_hz / config.framerate},
+	  fftw_wisdom_path{config.fftw_wisdom_path}
 {
+	if (config.prefetch_sec > 0)
+	{
+#if defined(LIBAVZ_MEDIA_LIBAV)
+		std::cerr << "decoding in-process with libav, ignoring --prefetch\n";
+#else
+		media.start_prefetch(config.prefetch_sec);
+#endif
+	}
+
+	// derived classes construct their analyzers after this, so they will all use this backend and these flags
+	if (config.fft_backend.size())
+	{
+		try
+		{
+			avz::fft::set_default_backend(avz::fft::backend_from_name(config.fft_backend));
+		}
+		catch (const std::invalid_argument &e)
+		{
+			std::cerr << e.what() << '\n';
+			std::exit(EXIT_FAILURE);
+		}
+	}
+
+	if (fftw_wisdom_path.size())
+	{
+#if defined(LIBAVZ_FFT_FFTW)
+		auto &plan_cache = avz::FftwPlanCache::instance();
+		if (!plan_cache.import_wisdom(fftw_wisdom_path))
+			std::cerr << "no usable fftw wisdom in '" << fftw_wisdom_path << "', plans will be measured from scratch\n";
+		plan_cache.set_default_flags(FFTW_MEASURE);
+#else
+		std::cerr << "built without the fftw backend, ignoring --fftw-wisdom\n";
+		fftw_wisdom_path.clear();
+#endif
+	}
+
 	if (config.profiler_enabled)
 	{
 		enable_profiler();
@@ -118,4 +184,30 @@ ExampleBase::ExampleBase(const ExampleConfig &config)
 	}
 }
 
+ExampleBase::~ExampleBase()
+{
+#if !defined(LIBAVZ_MEDIA_LIBAV)
+	if (media.is_prefetching() && media.get_underruns())
+		std::cerr << "audio prefetch ran dry " << media.get_underruns() << " times\n";
+#endif
+
+#if defined(LIBAVZ_FFT_FFTW)
+	if (fftw_wisdom_path.size() && !avz::FftwPlanCache::instance().export_wisdom(fftw_wisdom_path))
+		std::cerr << "failed to save fftw wisdom to '" << fftw_wisdom_path << "'\n";
+#endif
+}
+
+float bass_displacement(const std::span<const float> envelopes)
+{
+	// these examples used to take the bass bins of a Hann-windowed FFT, which measures a sine of amplitude A as
+	// A / 4, and divide them by 5. an envelope measures about A, so dividing by 20 keeps the particles as lively
+	float max{};
+	for (size_t i = 0; i < envelopes.size(); ++i)
+	{
+		const auto normalized_pos = (i + 0.5f) / envelopes.size();
+		max = std::max(max, envelopes[i] * expf(-expf(4.5 * normalized_pos - 4)) / 20);
+	}
+	return max;
+}
+
 } // namespace avz::examples
@@ -8,19 +8,17 @@ struct LogSpectrum : ExampleBase
 {
 	int fft_size{};
 
-	// audio, spectrum
-	std::vector<float> a, s;
+	// spectrum
+	std::vector<float> s;
 
 	avz::ColorSettings color;
 	avz::SpectrumDrawable spectrum;
 	avz::FrequencyAnalyzer fa;
 	avz::AudioAnalyzer aa;
 
-	// needed to logarithmically pack fft_size spectral samples into the spectrum's bars
-	avz::BinPacker bp;
-
-	// needed to interpolate the gaps left by BinPacker's spreading out of bins
-	avz::Interpolator ip;
+	// logarithmically packs fft_size spectral samples into the spectrum's bars, then fills the gaps left by
+	// spreading out the low bins. both steps are compiled once into a sparse operator, so each frame is one gather
+	avz::LogSpectrumRemapper remapper;
 
 	LogSpectrum(const ExampleConfig &config)
 		: ExampleBase{config},
@@ -36,21 +34,17 @@ struct LogSpectrum : ExampleBase
 		fa.set_fft_size(fft_size);
 
 		// logarithmically scale bin indices (frequencies)
-		bp.set_scale(avz::BinPacker::Scale::LOG);
+		remapper.set_scale(avz::BinPacker::Scale::LOG);
 
 		// when multiple values go to a bin, accumulate them using std::max()
 		// for fun, change this to SUM and see what happens
-		bp.set_accum_method(avz::BinPacker::AccumulationMethod::MAX);
+		remapper.set_accum_method(avz::BinPacker::AccumulationMethod::MAX);
 	}
 
 	void update(std::span<const float> audio_buffer) override
 	{
-		// make sure we can fit one channel of audio
-		a.resize(fft_size);
-
-		// extract first channel of audio and perform FFT (needed in case media file has stereo audio)
-		capture_time("strided_copy", avz::util::extract_channel(a, audio_buffer, num_channels, 0));
-		capture_time("fft", aa.execute_fft(fa, a));
+		// perform FFT on the first channel of audio, gathered straight from the interleaved buffer
+		capture_time("fft", aa.execute_fft(fa, audio_buffer, num_channels, 0));
 		capture_time("amplitudes", aa.compute_amplitudes(fa));
 
 		// make sure we can fit all the spectrum bars
@@ -58,11 +52,9 @@ struct LogSpectrum : ExampleBase
 		s.assign(spectrum.get_bar_count(), 0);
 
 		// pack FFT amplitudes into a smaller set of "bins" (our spectrum bars!)
-		capture_time("bin_pack", bp.bin_pack(s, aa.get_amplitudes()));
-
-		// there will be gaps caused by BinPacker because we logarithmically spread the output bins
-		// interpolate between them to make a nice looking curve
-		capture_time("interpolate", ip.interpolate(s));
+		// there would be gaps because we logarithmically spread the output bins,
+		// so they are interpolated from their neighbours to make a nice looking curve
+		capture_time("remap", remapper.remap(s, aa.get_amplitudes()));
 
 		// finally, pass the data to SpectrumDrawable to draw to the screen!
 		capture_time("spectrum_update", spectrum.update(s));
@@ -2,7 +2,7 @@
 #include <avz/analysis.hpp>
 #include <avz/gfx.hpp>
 
-#include <future>
+#include <array>
 #include <memory>
 // #include <print>
 
@@ -14,17 +14,15 @@ struct MirroredBassNation : ExampleBase
 {
 	const int fft_size;
 
+	// every layer declares its analysis here, so the channel is decimated once for all of them
+	avz::AnalysisGraph graph{(float)sample_rate_hz, num_channels};
 	std::vector<std::unique_ptr<BassNationSpectrumLayer>> spectrums;
 	avz::ColorSettings cs;
-	std::vector<std::future<void>> futures;
 
-	// calculate the FFT amplitudes array indices of min/max frequencies in Hz
-	const int min_fft_index = avz::util::bin_index_from_freq(0, sample_rate_hz, fft_size);
-	const int max_fft_index = avz::util::bin_index_from_freq(250, sample_rate_hz, fft_size);
-	std::vector<float> a, p;
+	// the particles only need low, mid, and high bass envelopes, updated from only the audio
+	// that arrived since the last frame instead of running a transform over the whole window
+	avz::BandEnvelopeAnalyzer bea{(float)sample_rate_hz, bass_bands};
 	avz::ParticleSystem ps;
-	avz::FrequencyAnalyzer fa{fft_size};
-	avz::AudioAnalyzer aa;
 	avz::fx::PolarCenter ps_polar{
 		(sf::Vector2f)size, // Dimensions of linear space
 		size.y * 0.25f,		// Base radius inner hole: 25% screen height
@@ -75,50 +73,28 @@ struct MirroredBassNation : ExampleBase
 			cs.set_solid_color(colors[i]);
 
 			auto &spectrum = *spectrums.emplace_back(
-				std::make_unique<BassNationSpectrumLayer>(new_fft_size, sample_rate_hz, size, cs, true));
-			spectrum.configure_spectrum(false, size);
+				std::make_unique<BassNationSpectrumLayer>(graph, new_fft_size, size, cs, true, false));
 
 			spectrum_layer.add_draw({spectrum.spectrum, &spectrum_polar});
 		}
 
 		// Add mirror effect to create mirrored versions on the right side
 		spectrum_layer.add_effect(&mirror_l2r);
-
-		futures.resize(spectrums.size());
 	}
 
 	void update(std::span<const float> audio_buffer) override
 	{
-		// start an update for each spectrum
-		std::ranges::transform(
-			spectrums, futures.begin(), std::bind_back(&BassNationSpectrumLayer::trigger_work, audio_buffer));
+		// start the spectrums' analysis, which forks its transforms onto the other cores.
+		// if anything below throws, destroying `analysis` waits for it before its captures go away
+		auto &jobs = avz::JobSystem::instance();
+		avz::JobSystem::TaskGroup analysis;
+		jobs.run(analysis, [&] { graph.run(audio_buffer, afpvf); });
 
 		// while the spectrums are updating, update our particle system
 		{
-			// make sure we can fit one channel of audio
-			a.resize(fft_size);
-
-			// extract first channel of audio and perform FFT (needed in case media file has stereo audio)
-			capture_time("strided_copy", avz::util::extract_channel(a, audio_buffer, num_channels, 0));
-			capture_time("fft", aa.execute_fft(fa, a));
-
-			// compute amplitudes from FFT output
-			capture_time("amplitudes", aa.compute_amplitudes(fa));
-
-			// compute FFT amplitudes, take only the bass frequencies
-			const auto amps = aa.get_amplitudes().subspan(min_fft_index, max_fft_index - min_fft_index);
-			p.resize(amps.size());
-
-			// weight each element by its normalized position through a Gompertz function
-			// this makes lower bass frequencies boost the particles more than higher bass frequencies
-			for (size_t i = 0; i < amps.size(); ++i)
-			{
-				const auto normalized_pos = (float)i / amps.size();
-				p[i] = amps[i] * expf(-expf(4.5 * normalized_pos - 4)) / 5;
-			}
-
-			float max;
-			capture_time("max", max = std::ranges::max(p));
+			// filter the first channel's new audio through the band filters
+			capture_time("band_envelopes", bea.update(audio_buffer, afpvf, num_channels, 0));
+			const auto max = bass_displacement(bea.get_envelopes());
 
 			// pass the max as `additional_displacement` to ParticleSystem::update.
 			// the displacement is then scaled to the window's height, and dampened
@@ -126,8 +102,10 @@ struct MirroredBassNation : ExampleBase
 			capture_time("ps_update", ps.update(max));
 		}
 
-		// wait for all spectrums to finish updating
-		std::ranges::for_each(futures, &std::future<void>::wait);
+		// wait for the analysis (helping with it if it isn't done) before drawing the spectrums
+		jobs.wait(analysis);
+		for (const auto &spectrum : spectrums)
+			spectrum->update(graph);
 	}
 };
 
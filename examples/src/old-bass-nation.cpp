@@ -2,7 +2,6 @@
 #include <avz/analysis.hpp>
 #include <avz/gfx.hpp>
 
-#include <future>
 #include <memory>
 // #include <print>
 
@@ -14,9 +13,10 @@ struct OldBassNation : ExampleBase
 {
 	const int max_fft_size;
 
+	// every layer declares its analysis here, so each channel is decimated once for all of them
+	avz::AnalysisGraph graph{(float)sample_rate_hz, num_channels};
 	std::vector<std::unique_ptr<BassNationSpectrumLayer>> spectrums;
 	avz::ColorSettings cs;
-	std::vector<std::future<void>> futures;
 
 	avz::fx::Polar polar_left;
 	avz::fx::Polar polar_right;
@@ -57,28 +57,22 @@ struct OldBassNation : ExampleBase
 			cs.set_solid_color(colors[i]);
 
 			auto &left_layer = *spectrums.emplace_back(
-				std::make_unique<BassNationSpectrumLayer>(new_fft_size, sample_rate_hz, size, cs, true));
-			left_layer.configure_spectrum(false, size);
+				std::make_unique<BassNationSpectrumLayer>(graph, new_fft_size, size, cs, true, false));
 
 			auto &right_layer = *spectrums.emplace_back(
-				std::make_unique<BassNationSpectrumLayer>(new_fft_size, sample_rate_hz, size, cs, false));
-			right_layer.configure_spectrum(true, size);
+				std::make_unique<BassNationSpectrumLayer>(graph, new_fft_size, size, cs, false, true));
 
 			spectrum_layer.add_draw({left_layer.spectrum, &polar_left});
 			spectrum_layer.add_draw({right_layer.spectrum, &polar_right});
 		}
-
-		futures.resize(spectrums.size());
 	}
 
 	void update(std::span<const float> audio_buffer) override
 	{
-		// std::ranges::transform(spectrums, futures.begin(), [=](auto &l) { return l->trigger_work(audio_buffer); });
-		std::ranges::transform(
-			spectrums, futures.begin(), std::bind_back(&BassNationSpectrumLayer::trigger_work, audio_buffer));
-
-		// wait for all compute tasks
-		std::ranges::for_each(futures, &std::future<void>::wait);
+		// runs the layers' transforms in parallel
+		capture_time("analysis", graph.run(audio_buffer, afpvf));
+		for (const auto &layer : spectrums)
+			layer->update(graph);
 	}
 };
 
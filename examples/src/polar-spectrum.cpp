@@ -8,13 +8,14 @@ struct PolarSpectrum : ExampleBase
 {
 	const int fft_size;
 
-	std::vector<float> s, a;
+	std::vector<float> s;
 
 	avz::ColorSettings color;
 	avz::SpectrumDrawable spectrum;
 	avz::FrequencyAnalyzer fa;
 	avz::AudioAnalyzer aa;
-	avz::Interpolator ip;
+	// bin weights for the fixed output grid, computed once
+	avz::SpectrumResamplePlan rp;
 
 	avz::fx::Polar polar;
 
@@ -22,7 +23,7 @@ struct PolarSpectrum : ExampleBase
 		: ExampleBase{config},
 		  fft_size{static_cast<int>(config.audio_duration_sec * sample_rate_hz)},
 		  spectrum{{{}, (sf::Vector2i)size}, color},
-		  fa{fft_size},
+		  fa{fft_size, avz::FrequencyAnalyzer::SizePolicy::Smooth},
 		  polar{
 			  (sf::Vector2f)size, // Dimensions of linear space
 			  size.y * 0.25f,	  // Base radius inner hole: 25% screen height
@@ -40,14 +41,12 @@ struct PolarSpectrum : ExampleBase
 
 	void update(std::span<const float> audio_buffer) override
 	{
-		a.resize(fft_size);
-		capture_time("strided_copy", avz::util::extract_channel(a, audio_buffer, num_channels, 0));
-		capture_time("fft", aa.execute_fft(fa, a));
+		capture_time("fft", aa.execute_fft(fa, audio_buffer, num_channels, 0));
 		capture_time("amplitudes", aa.compute_amplitudes(fa));
 		s.assign(spectrum.get_bar_count(), 0);
 		capture_time(
 			"resample_spectrum",
-			avz::util::resample_spectrum(s, aa.get_amplitudes(), sample_rate_hz, fft_size, 20, 250, ip));
+			avz::util::resample_spectrum(s, aa.get_amplitudes(), sample_rate_hz, fa.get_transform_size(), 20, 250, rp));
 		capture_time("spectrum_update", spectrum.update(s));
 	}
 };
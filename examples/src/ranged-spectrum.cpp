@@ -8,20 +8,21 @@ struct RangedSpectrum : ExampleBase
 {
 	const int fft_size;
 
-	std::vector<float> a, s;
+	std::vector<float> s;
 
 	avz::ColorSettings color;
 	avz::SpectrumDrawable spectrum;
 	avz::FrequencyAnalyzer fa;
 	avz::AudioAnalyzer aa;
 
-	avz::Interpolator ip;
+	// bin weights for the fixed output grid, computed once
+	avz::SpectrumResamplePlan rp;
 
 	RangedSpectrum(const ExampleConfig &config)
 		: ExampleBase{config},
 		  fft_size{static_cast<int>(config.audio_duration_sec * sample_rate_hz)},
 		  spectrum{{{}, (sf::Vector2i)size}, color},
-		  fa{fft_size}
+		  fa{fft_size, avz::FrequencyAnalyzer::SizePolicy::Smooth}
 	{
 		spectrum.set_bar_width(1);
 		spectrum.set_bar_spacing(0);
@@ -32,14 +33,12 @@ struct RangedSpectrum : ExampleBase
 
 	void update(std::span<const float> audio_buffer) override
 	{
-		a.resize(fft_size);
-		capture_time("strided_copy", avz::util::extract_channel(a, audio_buffer, num_channels, 0));
-		capture_time("fft", aa.execute_fft(fa, a));
+		capture_time("fft", aa.execute_fft(fa, audio_buffer, num_channels, 0));
 		capture_time("amplitudes", aa.compute_amplitudes(fa));
 		s.assign(spectrum.get_bar_count(), 0);
 		capture_time(
 			"resample_spectrum",
-			avz::util::resample_spectrum(s, aa.get_amplitudes(), sample_rate_hz, fft_size, 20, 250, ip));
+			avz::util::resample_spectrum(s, aa.get_amplitudes(), sample_rate_hz, fa.get_transform_size(), 20, 250, rp));
 		capture_time("spectrum_update", spectrum.update(s));
 	}
 };
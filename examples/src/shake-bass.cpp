@@ -2,15 +2,21 @@
 #include <avz/analysis.hpp>
 #include <avz/gfx.hpp>
 
+#include <array>
+
 using namespace avz::examples;
 
 struct ShakeBassTest : ExampleBase
 {
 	const int fft_size;
 
-	avz::FrequencyAnalyzer fa{fft_size};
+	avz::FrequencyAnalyzer fa{fft_size, avz::FrequencyAnalyzer::SizePolicy::Smooth};
 	avz::StereoAnalyzer sa;
 
+	// one peak estimator per band and channel. interpolating between bins and refining with the phase
+	// from the previous frame keeps the frequencies smooth with a window 4x shorter than a plain peak search needs
+	std::array<std::array<avz::PeakEstimator, 2>, 3> estimators;
+
 	sf::RectangleShape rect;
 	avz::fx::Shake shake;
 
@@ -25,6 +31,10 @@ struct ShakeBassTest : ExampleBase
 		rect.setOutlineColor(sf::Color::White);
 		rect.setOutlineThickness(1);
 
+		for (auto &band : estimators)
+			for (auto &estimator : band)
+				estimator.set_phase_vocoder(true);
+
 		emplace_layer<avz::Layer>("shake").add_draw({rect, &shake});
 	}
 
@@ -33,19 +43,25 @@ struct ShakeBassTest : ExampleBase
 		capture_time("fft", sa.execute_fft(fa, audio_buffer));
 
 		// amplitudes are required to be computed before calling compute_peak_frequency()
-		sa.compute_amplitudes(fa);
+		sa.compute_amplitudes();
 
 		// split up 0-250Hz into three bands: low bass, mid bass, high bass.
 		// since we are calling this on a StereoAnalyzer, it will average the peak frequency
 		// of the frequency range across both channels.
 		constexpr auto band_size = 250 / 3;
-		const auto [f1, a1] = sa.compute_averaged_peak_frequency(fa, sample_rate_hz, 0, band_size);
-		const auto [f2, a2] = sa.compute_averaged_peak_frequency(fa, sample_rate_hz, band_size + 1, 2 * band_size);
-		const auto [f3, a3] = sa.compute_averaged_peak_frequency(fa, sample_rate_hz, 2 * band_size + 1, 3 * band_size);
+		const auto peak = [&](int band)
+		{
+			const auto from_hz = band ? band * band_size + 1 : 0;
+			return sa.estimate_averaged_peak_frequency(
+				fa, sample_rate_hz, from_hz, (band + 1) * band_size, estimators[band], afpvf);
+		};
+		const auto [f1, a1] = peak(0);
+		const auto [f2, a2] = peak(1);
+		const auto [f3, a3] = peak(2);
 
 		// pass the three frequencies & amplitudes to Shake effect
 		shake.setParameters({f1, f2, f3}, {a1, a2, a3}, 100);
 	}
 };
 
-LIBAVZ_EXAMPLE_MAIN_CUSTOM(ShakeBassTest, "Shake effect visualization based on bass frequencies", 0.25f, viz.fft_size)
+LIBAVZ_EXAMPLE_MAIN_CUSTOM(ShakeBassTest, "Shake effect visualization based on bass frequencies", 0.0625f, viz.fft_size)
@@ -8,13 +8,14 @@ struct StereoPolarSpectrum : ExampleBase
 {
 	const int fft_size;
 
-	std::vector<float> s, a;
+	std::vector<float> s;
 
 	avz::ColorSettings cs;
 	avz::SpectrumDrawable spectrum_left, spectrum_right;
 	avz::FrequencyAnalyzer fa;
-	avz::AudioAnalyzer aa;
-	avz::Interpolator ip;
+	avz::StereoAnalyzer sa;
+	// bin weights for the fixed output grid, computed once
+	avz::SpectrumResamplePlan rp;
 
 	avz::fx::Polar polar_left, polar_right;
 
@@ -23,7 +24,7 @@ struct StereoPolarSpectrum : ExampleBase
 		  fft_size{static_cast<int>(config.audio_duration_sec * sample_rate_hz)},
 		  spectrum_left{{{}, (sf::Vector2i)size}, cs},
 		  spectrum_right{{{}, (sf::Vector2i)size}, cs},
-		  fa{fft_size},
+		  fa{fft_size, avz::FrequencyAnalyzer::SizePolicy::Smooth},
 		  polar_left{(sf::Vector2f)size, size.y * 0.25f, size.y * 0.5f, M_PI / 2, M_PI},
 		  polar_right{polar_left}
 	{
@@ -43,22 +44,22 @@ struct StereoPolarSpectrum : ExampleBase
 
 	void update(std::span<const float> audio_buffer) override
 	{
-		auto process_channel = [&](bool backwards, int channel, avz::SpectrumDrawable &spectrum)
+		// both channels are transformed by a single complex FFT
+		capture_time("fft", sa.execute_fft(fa, audio_buffer));
+		capture_time("amplitudes", sa.compute_amplitudes());
+
+		auto process_channel = [&](bool backwards, std::span<const float> amps, avz::SpectrumDrawable &spectrum)
 		{
 			spectrum.set_backwards(backwards);
-			a.resize(fft_size);
-			capture_time("strided_copy", avz::util::extract_channel(a, audio_buffer, num_channels, channel));
-			capture_time("fft", aa.execute_fft(fa, a));
-			capture_time("amplitudes", aa.compute_amplitudes(fa));
 			s.assign(spectrum.get_bar_count(), 0);
 			capture_time(
 				"resample_spectrum",
-				avz::util::resample_spectrum(s, aa.get_amplitudes(), sample_rate_hz, fft_size, 20, 125, ip));
+				avz::util::resample_spectrum(s, amps, sample_rate_hz, fa.get_transform_size(), 20, 125, rp));
 			capture_time("spectrum_update", spectrum.update(s));
 		};
 
-		process_channel(false, 0, spectrum_left);
-		process_channel(true, 1, spectrum_right);
+		process_channel(false, sa.left(), spectrum_left);
+		process_channel(true, sa.right(), spectrum_right);
 	}
 };
 
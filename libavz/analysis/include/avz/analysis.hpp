@@ -1,9 +1,27 @@
 #pragma once
 
+#include <avz/analysis/AnalysisGraph.hpp>
 #include <avz/analysis/AudioAnalyzer.hpp>
+#include <avz/analysis/BandEnvelopeAnalyzer.hpp>
 #include <avz/analysis/BinPacker.hpp>
+#include <avz/analysis/BinPlan.hpp>
+#include <avz/analysis/ConstantQAnalyzer.hpp>
+#include <avz/analysis/Decimator.hpp>
+#if defined(LIBAVZ_FFT_FFTW)
+#include <avz/analysis/FftwPlanCache.hpp>
+#endif
 #include <avz/analysis/FrequencyAnalyzer.hpp>
 #include <avz/analysis/Interpolator.hpp>
+#include <avz/analysis/JobSystem.hpp>
+#include <avz/analysis/LogSpectrumRemapper.hpp>
 #include <avz/analysis/MultiChannelAudioAnalyzer.hpp>
+#include <avz/analysis/OnsetAnalyzer.hpp>
+#include <avz/analysis/PeakEstimator.hpp>
+#include <avz/analysis/SlidingDftAnalyzer.hpp>
+#include <avz/analysis/SpectrumResamplePlan.hpp>
+#include <avz/analysis/Spline.hpp>
 #include <avz/analysis/StereoAnalyzer.hpp>
+#include <avz/analysis/WindowCache.hpp>
+#include <avz/analysis/fft.hpp>
+#include <avz/analysis/simd.hpp>
 #include <avz/analysis/util.hpp>
@@ -0,0 +1,240 @@
+#pragma once
+
+#include <array>
+#include <avz/analysis/Decimator.hpp>
+#include <avz/analysis/FrequencyAnalyzer.hpp>
+#include <avz/analysis/Interpolator.hpp>
+#include <avz/analysis/JobSystem.hpp>
+#include <avz/analysis/SpectrumResamplePlan.hpp>
+#include <complex>
+#include <map>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace avz
+{
+
+/**
+ * Declarative per-frame analysis shared between consumers, e.g. the layers of a visualizer.
+ *
+ * Consumers declare the chain of nodes they need (channel extract -> decimate -> FFT -> amplitudes -> resample)
+ * and keep a typed handle to the output. Declaring a node identical to an existing one (same kind, input and
+ * parameters) returns the existing node, so a channel is extracted once, a decimator is shared by every FFT
+ * reading from it, and so on. Windows sized by their consumers are merged: a channel holds as many frames as its
+ * longest consumer needs, and a decimator keeps as many samples.
+ *
+ * `run` executes every node once per frame in topological order. Nodes at the same depth don't depend on each
+ * other, so they run as one task group on a `JobSystem`.
+ *
+ * Like `Decimator::update`, the graph expects the latest window of audio every frame, moving forward by `hop`
+ * frames between calls. Every node's window starts at the first frame of the audio, and shorter consumers read
+ * the start of a longer window. This holds for decimators too: like `Decimator::update`, a decimator reads only
+ * the first `window * factor` frames of its channel, even when a longer consumer of the same channel extends the
+ * channel's window past them.
+ */
+class AnalysisGraph
+{
+public:
+	// handle tags, for the type of data a node outputs
+	// mono samples at the node's sample rate
+	struct Samples;
+	// complex bins of a transform
+	struct Spectrum;
+	// amplitudes of the bins of a transform
+	struct Amplitudes;
+	// amplitudes resampled onto a fixed grid of frequencies
+	struct Resampled;
+
+	template <typename T>
+	struct Handle
+	{
+		int node{-1};
+		inline bool valid() const { return node >= 0; }
+	};
+
+private:
+	enum class Kind
+	{
+		Channel,
+		Decimate,
+		Fft,
+		Amplitudes,
+		Resample,
+	};
+
+	struct Key
+	{
+		Kind kind;
+		int input;
+		std::array<float, 4> params;
+		auto operator<=>(const Key &) const = default;
+	};
+
+	struct Node
+	{
+		Kind kind{};
+		// node whose output this one reads, -1 for channels
+		int input{-1};
+		// number of nodes between this one and the audio, nodes at the same depth run concurrently
+		int level{};
+
+		// channel: channel index; decimate: factor; fft: fft size; resample: output size
+		int param{};
+		// frames (channel) or samples (decimate) requested when declared
+		int min_window{};
+		// frames (channel) or samples (decimate) needed by the node itself and its consumers
+		int window{};
+
+		float sample_rate_hz{};
+
+		// channel, amplitudes and resample output
+		std::vector<float> values{};
+		std::unique_ptr<Decimator> dec{};
+		std::unique_ptr<FrequencyAnalyzer> fa{};
+		std::unique_ptr<SpectrumResamplePlan> plan{};
+		SpectrumResamplePlan::Grid grid{};
+	};
+
+	float sample_rate_hz;
+	int num_channels;
+	JobSystem *jobs{&JobSystem::instance()};
+
+	std::vector<Node> nodes;
+	std::map<Key, int> node_ids;
+	bool compiled{};
+	int input_frames{};
+
+	// node indices ordered by level, and where each level starts in `order`
+	std::vector<int> order, level_start;
+
+	// state of the frame being run
+	std::span<const float> audio;
+	int hop{};
+
+public:
+	/**
+	 * @param sample_rate_hz sample rate of the audio passed to `run`
+	 * @param num_channels channel count of the interleaved audio passed to `run`
+	 * @throws `std::invalid_argument` if any argument is not positive
+	 */
+	AnalysisGraph(float sample_rate_hz, int num_channels);
+
+	AnalysisGraph(const AnalysisGraph &) = delete;
+	AnalysisGraph &operator=(const AnalysisGraph &) = delete;
+
+	/**
+	 * Declare the extraction of one channel of the audio.
+	 * @param channel channel to extract
+	 * @param frames minimum frames to extract, 0 to extract exactly what consumers need
+	 * @throws `std::invalid_argument` if `channel` is out of range or `frames` is negative
+	 */
+	Handle<Samples> channel(int channel, int frames = 0);
+
+	/**
+	 * Declare an anti-aliased decimation of a channel, see `Decimator`.
+	 * Consumers read the decimated samples at `input`'s sample rate divided by `factor`.
+	 * @param input channel to decimate
+	 * @param factor decimation factor, e.g. from `Decimator::factor_for`
+	 * @param window_size minimum decimated samples to keep, 0 to keep exactly what consumers need
+	 * @throws `std::invalid_argument` if `input` isn't a channel, `factor` is not positive or `window_size` is negative
+	 */
+	Handle<Samples> decimate(Handle<Samples> input, int factor, int window_size = 0);
+
+	/**
+	 * Declare a transform of the first `fft_size` samples of `input`, see `FrequencyAnalyzer`.
+	 * @throws `std::invalid_argument` if `input` isn't a node of this graph, or `fft_size` is not positive
+	 */
+	Handle<Spectrum> fft(
+		Handle<Samples> input,
+		int fft_size,
+		FrequencyAnalyzer::WindowFunction window_func = FrequencyAnalyzer::WindowFunction::Hanning,
+		FrequencyAnalyzer::SizePolicy size_policy = FrequencyAnalyzer::SizePolicy::Exact);
+
+	/**
+	 * Declare the amplitudes of a transform, see `util::compute_amplitudes`.
+	 * @throws `std::invalid_argument` if `input` isn't a node of this graph
+	 */
+	Handle<Amplitudes> amplitudes(Handle<Spectrum> input);
+
+	/**
+	 * Declare the resampling of amplitudes onto `out_size` frequencies from `start_freq` to `end_freq`,
+	 * see `SpectrumResamplePlan`.
+	 * @throws `std::invalid_argument` if `input` isn't a node of this graph, or `out_size` is not positive
+	 */
+	Handle<Resampled> resample(
+		Handle<Amplitudes> input,
+		int out_size,
+		float start_freq,
+		float end_freq,
+		Interpolator::InterpolationType type = Interpolator::InterpolationType::CSPLINE);
+
+	/**
+	 * Size every node's window and allocate its state. Called by `run` after any node was declared;
+	 * decimators whose window changed start over.
+	 * @throws `std::invalid_argument` if a resample grid is invalid
+	 */
+	void compile();
+
+	/**
+	 * Run every node on the latest window of audio.
+	 * @param audio interleaved audio containing at least `get_input_frames()` frames; later frames are ignored
+	 * @param hop frames the window moved since the previous call
+	 * @throws `std::invalid_argument` if `audio` is too short
+	 * @throws the first exception thrown by a node, after the rest of its level has run
+	 */
+	void run(std::span<const float> audio, int hop);
+
+	/**
+	 * Get the output of a node from the last `run`. Samples of a decimator are its whole window, oldest first.
+	 */
+	std::span<const float> get(Handle<Samples> handle) const;
+	std::span<const std::complex<float>> get(Handle<Spectrum> handle) const;
+	inline std::span<const float> get(Handle<Amplitudes> handle) const { return nodes[handle.node].values; }
+	inline std::span<const float> get(Handle<Resampled> handle) const { return nodes[handle.node].values; }
+
+	/**
+	 * Get the sample rate of the samples a node was computed from, e.g. for bin <-> Hz conversions.
+	 */
+	template <typename T>
+	inline float get_sample_rate(const Handle<T> handle) const
+	{
+		return nodes[handle.node].sample_rate_hz;
+	}
+
+	/**
+	 * Get the transform size, including zero-padding, that produced a spectrum or its amplitudes.
+	 */
+	int get_transform_size(Handle<Spectrum> handle) const;
+	inline int get_transform_size(const Handle<Amplitudes> handle) const
+	{
+		return get_transform_size(Handle<Spectrum>{nodes[handle.node].input});
+	}
+
+	/**
+	 * Get the number of audio frames `run` reads. Valid after `compile` or `run`.
+	 */
+	inline int get_input_frames() const { return input_frames; }
+
+	/**
+	 * Get the number of distinct nodes declared.
+	 */
+	inline int get_node_count() const { return nodes.size(); }
+
+	/**
+	 * Set the job system running independent nodes, `JobSystem::instance()` by default.
+	 * `run` may itself be called from a job of the same system.
+	 * @param jobs job system to use, or null to run every node on the calling thread
+	 */
+	inline void set_job_system(JobSystem *const jobs) { this->jobs = jobs; }
+	inline JobSystem *get_job_system() const { return jobs; }
+
+private:
+	int add_node(Kind kind, int input, std::array<float, 4> params, Node node);
+	void check_input(int input, const char *method) const;
+	std::span<const float> samples(int node) const;
+
+	void execute(Node &node);
+};
+
+} // namespace avz
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <avz/analysis/FrequencyAnalyzer.hpp>
+#include <avz/analysis/PeakEstimator.hpp>
 #include <cassert>
 #include <span>
 #include <vector>
@@ -22,10 +23,40 @@ private:
 
 public:
 	void execute_fft(FrequencyAnalyzer &fa, std::span<const float> audio);
+
+	/**
+	 * Execute FFT on one channel of interleaved audio, see `FrequencyAnalyzer::copy_to_input`.
+	 */
+	void execute_fft(FrequencyAnalyzer &fa, std::span<const float> interleaved, int num_channels, int channel);
 	void compute_amplitudes(const FrequencyAnalyzer &fa);
+
+	/**
+	 * Compute amplitudes from a spectrum produced outside of a `FrequencyAnalyzer`.
+	 * @param spectrum the non-negative frequency bins of a transform
+	 * @param fft_size number of real samples that were transformed, excluding zero-padding
+	 */
+	void compute_amplitudes(std::span<const std::complex<float>> spectrum, int fft_size);
 	std::span<const float> get_amplitudes();
+
+	/**
+	 * Find the loudest bin between `from_hz` and `to_hz`.
+	 * @param sample_rate_hz effective sample rate of the analyzed samples, e.g. `Decimator::output_sample_rate()`
+	 */
 	FrequencyAmplitudePair
-	compute_peak_frequency(const FrequencyAnalyzer &fa, int sample_rate_hz, int from_hz, int to_hz);
+	compute_peak_frequency(const FrequencyAnalyzer &fa, float sample_rate_hz, int from_hz, int to_hz);
+
+	/**
+	 * Estimate the loudest peak between `from_hz` and `to_hz` to a fraction of a bin, see `PeakEstimator`.
+	 * @param estimator estimator tracking this range
+	 * @param hop samples the analysis window moved since the previous frame, for the phase vocoder
+	 */
+	PeakEstimator::Estimate estimate_peak_frequency(
+		const FrequencyAnalyzer &fa,
+		float sample_rate_hz,
+		int from_hz,
+		int to_hz,
+		PeakEstimator &estimator,
+		int hop = 0);
 };
 
 } // namespace avz
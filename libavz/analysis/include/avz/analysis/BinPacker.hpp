@@ -1,14 +1,17 @@
 #pragma once
 
+#include <memory>
 #include <span>
-#include <vector>
 
 namespace avz
 {
 
+class BinPlan;
+
 /**
  * Packs frequency spectrum bins using various scaling methods and accumulation strategies.
- * Maintains state for efficient index mapping computations.
+ * The mapping for the current settings and sizes is compiled into a shared `BinPlan`, which is
+ * looked up again whenever a setting or either spectrum size changes.
  */
 class BinPacker
 {
@@ -17,7 +20,10 @@ public:
 	{
 		LINEAR,
 		LOG,
-		NTH_ROOT
+		NTH_ROOT,
+		// triangular filterbanks, see `BinPlan`; require `set_sample_rate`
+		MEL,
+		BARK
 	};
 
 	enum class AccumulationMethod
@@ -32,21 +38,15 @@ private:
 
 	// nth root for NTH_ROOT scale
 	int nth_root{2};
-	float nthroot_inv{1.f / nth_root};
 
 	// method for accumulating amplitudes in frequency bins
 	AccumulationMethod am{AccumulationMethod::MAX};
 
-	// struct to hold the "max"s used in `calc_index_ratio`
-	struct _scale_max
-	{
-		float linear, log, sqrt, cbrt, nthroot;
-		void calc(int new_max, float nthroot_inv);
-	} scale_max;
+	// sample rate of the input spectrum for MEL and BARK scales
+	float sample_rate_hz{};
 
-	// state for bin packing
-	int bin_pack_input_size{};
-	std::vector<std::pair<int, int>> bin_pack_index_mapping;
+	// plan used by the last `bin_pack`
+	std::shared_ptr<const BinPlan> plan;
 
 public:
 	BinPacker() = default;
@@ -70,6 +70,14 @@ public:
 	 */
 	void set_accum_method(AccumulationMethod am);
 
+	/**
+	 * Set the sample rate the input spectrum was computed at, used by the `MEL` and `BARK` scales.
+	 * The input spectrum is assumed to span 0 Hz to nyquist.
+	 * @param sample_rate_hz new sample rate
+	 * @throws `std::invalid_argument` if `sample_rate_hz` is not positive
+	 */
+	void set_sample_rate(float sample_rate_hz);
+
 	/**
 	 * Get the current scale.
 	 */
@@ -85,16 +93,24 @@ public:
 	 */
 	inline AccumulationMethod get_accum_method() const { return am; }
 
+	/**
+	 * Get the current sample rate, 0 if never set.
+	 */
+	inline float get_sample_rate() const { return sample_rate_hz; }
+
 	/**
 	 * Pack frequency bins from input to output spectrum using configured scale and accumulation method.
 	 * @param out output spectrum (smaller size)
 	 * @param in input spectrum (larger size)
+	 * @throws `std::invalid_argument` if the scale is `MEL` or `BARK` and no sample rate was set
 	 */
 	void bin_pack(std::span<float> out, std::span<const float> in);
 
-private:
-	float calc_index_ratio(float i) const;
-	void compute_bin_pack_index_mappings(size_t out_size, size_t in_size);
+	/**
+	 * Get the plan for the current settings and the given spectrum sizes.
+	 * @throws `std::invalid_argument` if the scale is `MEL` or `BARK` and no sample rate was set
+	 */
+	std::shared_ptr<const BinPlan> get_plan(int out_size, int in_size);
 };
 
 } // namespace avz
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <avz/analysis/BinPacker.hpp>
+#include <compare>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace avz
+{
+
+/**
+ * Immutable, compiled mapping from an input spectrum to a smaller output spectrum.
+ * Every output bin reads a contiguous run of input bins, so the mapping is stored as a sparse matrix in
+ * compressed-row (CSR) form where only the first column of each row is kept. Executing a plan is a
+ * branch-free sparse matrix-vector product: the accumulation method is chosen once, when the plan is built.
+ *
+ * `LINEAR`, `LOG` and `NTH_ROOT` plans give every input bin to exactly one output bin with weight 1; a bin exactly
+ * on the edge between two output bins goes to the upper one.
+ * `MEL` and `BARK` plans are triangular filterbanks: overlapping, weighted rows whose centers are evenly
+ * spaced on the perceptual scale between 0 Hz and nyquist. Each triangle peaks at 1, so a pure tone at a
+ * filter's center keeps its amplitude with `AccumulationMethod::MAX`.
+ *
+ * Plans are shared through `BinPlan::get`, so rebuilding a `BinPacker` or changing sizes back and forth is cheap.
+ */
+class BinPlan
+{
+public:
+	struct Key
+	{
+		int in_size, out_size;
+		BinPacker::Scale scale;
+		// only used by Scale::NTH_ROOT, 0 otherwise
+		int nth_root;
+		BinPacker::AccumulationMethod method;
+		// only used by Scale::MEL and Scale::BARK, 0 otherwise
+		float sample_rate_hz;
+		auto operator<=>(const Key &) const = default;
+	};
+
+private:
+	Key key;
+
+	// row i reads in[first_column[i]] onward, for row_offsets[i + 1] - row_offsets[i] columns
+	std::vector<int> row_offsets, first_column;
+
+	// one weight per stored column, empty if every weight is 1
+	std::vector<float> weights;
+
+	void (BinPlan::*kernel)(float *out, const float *in) const;
+
+public:
+	/**
+	 * Compile a plan. Prefer `BinPlan::get`, which shares plans between users.
+	 * Unused parameters in `key` (see `Key`) are ignored.
+	 * @throws `std::invalid_argument` if a size is not positive, `nth_root` is zero for `NTH_ROOT`,
+	 * or `sample_rate_hz` is not positive or `in_size` is less than 2 for `MEL` and `BARK`
+	 */
+	explicit BinPlan(const Key &key);
+
+	/**
+	 * Get a shared plan for `key`, compiling it if no live plan matches.
+	 * @throws `std::invalid_argument` under the same conditions as the constructor
+	 */
+	static std::shared_ptr<const BinPlan> get(Key key);
+
+	/**
+	 * Normalize `key` so that parameters unused by its scale don't produce distinct plans.
+	 */
+	static Key normalize(Key key);
+
+	/**
+	 * Pack `in` into `out`. Output bins that no input bin maps to are set to 0.
+	 * @param out output spectrum, `get_key().out_size` values
+	 * @param in input spectrum, `get_key().in_size` values
+	 */
+	void execute(std::span<float> out, std::span<const float> in) const;
+
+	inline const Key &get_key() const { return key; }
+
+	/**
+	 * Number of stored matrix entries, i.e. multiply-adds (or comparisons) per execution.
+	 */
+	inline int get_nonzero_count() const { return row_offsets.back(); }
+
+	/**
+	 * Whether no input bin maps to output bin `row`, i.e. `execute` always outputs 0 there.
+	 */
+	inline bool is_row_empty(const int row) const { return row_offsets[row + 1] == row_offsets[row]; }
+
+	/**
+	 * Whether the plan has explicit weights (`MEL` and `BARK` filterbanks).
+	 */
+	inline bool is_weighted() const { return !weights.empty(); }
+
+private:
+	void compile_index_scale();
+	void compile_filterbank();
+
+	template <BinPacker::AccumulationMethod method, bool weighted>
+	void execute_rows(float *out, const float *in) const;
+};
+
+} // namespace avz
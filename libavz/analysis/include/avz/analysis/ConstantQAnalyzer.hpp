@@ -0,0 +1,119 @@
+#pragma once
+
+#include <avz/analysis/Decimator.hpp>
+#include <avz/analysis/fft.hpp>
+#include <complex>
+#include <span>
+#include <vector>
+
+namespace avz
+{
+
+/**
+ * Constant-Q spectrum: `bins_per_octave` geometrically spaced bins per octave, each with a bandwidth proportional
+ * to its frequency, so bass gets fine frequency resolution and treble gets fine time resolution.
+ *
+ * Built as an octave-wise multirate pyramid. The top octave is analyzed at the input sample rate, and each lower
+ * octave at half the rate of the one above it, produced by a chain of factor-2 `Decimator`s. Halving both the
+ * frequencies and the sample rate leaves every octave looking the same in FFT bins, so all octaves share one
+ * short FFT size and one precomputed sparse spectral kernel (Brown & Puckette): each constant-Q bin is a
+ * weighted sum of the few FFT bins around it.
+ *
+ * Kernels are aligned to the end of the analysis window, so every bin reflects the most recent audio.
+ * A sinusoid of amplitude A at a bin's center frequency produces an amplitude of about A / 2,
+ * the same as an unwindowed `AudioAnalyzer` bin.
+ */
+class ConstantQAnalyzer
+{
+	float sample_rate_hz, min_freq_hz;
+	int octaves, bins_per_octave;
+	int fft_size{};
+
+	// level k decimates the input by 2^k; level 0 is the input itself, so it isn't stored here
+	std::vector<Decimator> levels;
+
+	// latest fft_size samples of the input, for the top octave
+	std::vector<float> top;
+	bool primed{};
+
+	fft::dft_r2c_1d fft;
+
+	// sparse spectral kernel shared by every octave:
+	// bin j is the sum of fft output[kernel_first[j] + i] * kernel[kernel_offsets[j] + i]
+	std::vector<int> kernel_offsets, kernel_first;
+	std::vector<std::complex<float>> kernel;
+
+	// lowest bin first
+	std::vector<float> _amplitudes;
+
+public:
+	/**
+	 * @param sample_rate_hz input sample rate
+	 * @param min_freq_hz center frequency of the lowest bin
+	 * @param octaves number of octaves, so the highest bin is just under `min_freq_hz * 2^octaves`
+	 * @param bins_per_octave bins per octave; more bins means a higher Q and longer analysis windows
+	 * @param sparsity kernel values smaller than this fraction of a bin's largest value are dropped
+	 * @throws `std::invalid_argument` if any argument is not positive, or the highest bin is above
+	 * 40% of the sample rate (the decimators' passband)
+	 */
+	ConstantQAnalyzer(
+		float sample_rate_hz, float min_freq_hz, int octaves, int bins_per_octave, float sparsity = 0.005f);
+
+	/**
+	 * Number of input frames needed by `update`: one FFT of the lowest octave, at the input rate.
+	 */
+	inline int get_input_window_size() const { return fft_size << (octaves - 1); }
+
+	/**
+	 * Size of the FFT computed for every octave.
+	 */
+	inline int get_fft_size() const { return fft_size; }
+
+	/**
+	 * Total number of bins, `octaves * bins_per_octave`.
+	 */
+	inline int get_bin_count() const { return octaves * bins_per_octave; }
+
+	/**
+	 * Center frequency of bin `i`, counting from the lowest bin.
+	 */
+	float get_bin_frequency(int i) const;
+
+	/**
+	 * Quality factor: center frequency over bandwidth, the same for every bin.
+	 */
+	float get_q() const;
+
+	/**
+	 * Feed the latest window of audio, which moved forward by `hop` frames since the previous call
+	 * (e.g. `Player`'s audio frames per video frame). The whole window is pushed through the pyramid on the first
+	 * call or when `hop` covers the window, and only the newest `hop` frames otherwise.
+	 * @param audio audio buffer containing at least `get_input_window_size()` frames; later frames are ignored
+	 * @param hop frames the window moved since the previous call
+	 * @param num_channels channel count if `audio` is interleaved
+	 * @param channel channel to analyze
+	 */
+	void update(std::span<const float> audio, int hop, int num_channels = 1, int channel = 0);
+
+	/**
+	 * Forget all pyramid state. The next `update` pushes a whole window again.
+	 */
+	void reset();
+
+	/**
+	 * Transform every octave and compute the constant-Q amplitudes from the last `update`.
+	 * @throws `std::logic_error` if `update` hasn't been called
+	 */
+	void compute_amplitudes();
+
+	/**
+	 * Get the constant-Q amplitudes, lowest bin first. Can be passed straight to `SpectrumDrawable::update`.
+	 * @throws `std::logic_error` if `compute_amplitudes` hasn't been called
+	 */
+	std::span<const float> get_amplitudes() const;
+
+private:
+	void compute_kernel(float sparsity);
+};
+
+} // namespace avz
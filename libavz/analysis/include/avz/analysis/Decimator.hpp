@@ -0,0 +1,96 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+namespace avz
+{
+
+/**
+ * Anti-aliased integer-factor decimator whose filter state persists between calls.
+ * Only every `factor`-th output of the lowpass FIR is computed (polyphase decimation), so
+ * the cost is `taps_per_phase` multiply-adds per input sample.
+ *
+ * Keeps the most recent `window_size` decimated samples contiguous, ready to be passed to
+ * `FrequencyAnalyzer`. Low-frequency analysis (e.g. a 20-135 Hz spectrum) at a reduced rate gets the
+ * same frequency resolution from a much smaller FFT: 0.25s at 48kHz / 24 is a 500-point FFT instead of 12000.
+ * Use `output_sample_rate()` as the sample rate for everything computed from the decimated samples.
+ */
+class Decimator
+{
+	int factor, window_size;
+
+	// symmetric lowpass FIR, so each output is a straight dot product with the history
+	std::vector<float> taps;
+
+	// the last taps.size() - 1 input samples, followed by the samples being pushed
+	std::vector<float> history;
+
+	// index into `history` of the input sample that produces the next output
+	size_t next_output{};
+
+	// each output is written twice, `window_size` apart, so the latest window is always contiguous
+	std::vector<float> window_buf;
+	int window_pos{};
+
+	bool primed{};
+
+public:
+	/**
+	 * @param factor decimation factor
+	 * @param window_size number of decimated samples to keep available through `window()`
+	 * @param taps_per_phase FIR length per output sample; higher values give a sharper anti-aliasing filter
+	 * @throws `std::invalid_argument` if any argument is not positive
+	 */
+	Decimator(int factor, int window_size, int taps_per_phase = 16);
+
+	/**
+	 * Pick the decimation factor that brings `input_sample_rate` down closest to (but not below) `target_sample_rate`.
+	 */
+	static int factor_for(float input_sample_rate, float target_sample_rate);
+
+	/**
+	 * Filter and decimate new input samples, appending the results to the window.
+	 * @param samples new audio, oldest first
+	 * @param num_channels channel count if `samples` is interleaved
+	 * @param channel channel to decimate
+	 * @returns number of decimated samples appended; the newest of them are at the end of `window()`
+	 */
+	int push(std::span<const float> samples, int num_channels = 1, int channel = 0);
+
+	/**
+	 * Convenience for render loops that receive the latest window of audio every frame, where
+	 * the window moves forward by `hop` frames between calls (e.g. `Player`'s audio frames per video frame).
+	 * Pushes the whole `get_input_window_size()` frames on the first call, then only the newest `hop` frames.
+	 * @param audio audio buffer containing at least `get_input_window_size()` frames; later frames are ignored
+	 * @param hop frames the window moved since the previous call
+	 * @param num_channels channel count if `audio` is interleaved
+	 * @param channel channel to decimate
+	 */
+	void update(std::span<const float> audio, int hop, int num_channels = 1, int channel = 0);
+
+	/**
+	 * Forget all filter state and decimated samples.
+	 */
+	void reset();
+
+	/**
+	 * Get the latest `window_size` decimated samples, oldest first.
+	 */
+	inline std::span<const float> window() const { return {window_buf.data() + window_pos, (size_t)window_size}; }
+
+	inline int get_factor() const { return factor; }
+	inline int get_window_size() const { return window_size; }
+
+	/**
+	 * Number of input frames covered by `window()`.
+	 */
+	inline int get_input_window_size() const { return window_size * factor; }
+
+	/**
+	 * Sample rate of the decimated samples.
+	 */
+	inline float output_sample_rate(const float input_sample_rate) const { return input_sample_rate / factor; }
+};
+
+} // namespace avz
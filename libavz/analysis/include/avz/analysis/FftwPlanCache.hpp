@@ -0,0 +1,117 @@
+#pragma once
+
+#include <compare>
+#include <fftw3.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace avz
+{
+
+/**
+ * Process-wide, thread-safe registry of FFTW plans.
+ * Plans are keyed by transform kind and size, array alignment, and planner flags, and are shared
+ * between every FFT wrapper that asks for the same key. Wrappers must execute shared plans
+ * with FFTW's new-array functions (e.g. `fftwf_execute_dft_r2c`) on their own buffers.
+ *
+ * Also manages FFTW wisdom, so that expensive `FFTW_MEASURE`/`FFTW_PATIENT` plans
+ * can be computed once, saved to a file, and reloaded almost instantly on the next launch.
+ */
+class FftwPlanCache
+{
+public:
+	using Plan = std::shared_ptr<fftwf_plan_s>;
+
+	enum class Kind
+	{
+		// real-to-complex forward transform
+		R2C,
+		// complex-to-complex forward transform
+		C2C,
+		// `howmany` real-to-complex forward transforms of interleaved input into consecutive output rows
+		R2C_INTERLEAVED,
+	};
+
+	struct Key
+	{
+		Kind kind;
+		int n, howmany;
+		int in_alignment, out_alignment;
+		unsigned flags;
+		auto operator<=>(const Key &) const = default;
+	};
+
+private:
+	// guards `plans` AND every call into the FFTW planner, which is not thread-safe
+	std::mutex mu;
+	std::map<Key, std::weak_ptr<fftwf_plan_s>> plans;
+	unsigned default_flags{FFTW_ESTIMATE};
+
+	FftwPlanCache() = default;
+
+public:
+	FftwPlanCache(const FftwPlanCache &) = delete;
+	FftwPlanCache &operator=(const FftwPlanCache &) = delete;
+
+	/**
+	 * Get the process-wide plan cache.
+	 */
+	static FftwPlanCache &instance();
+
+	/**
+	 * Get a shared real-to-complex plan of size `n`, creating it if no live plan matches.
+	 * If `flags` contains `FFTW_WISDOM_ONLY` and no wisdom exists for the key,
+	 * falls back to an `FFTW_ESTIMATE` plan instead of failing.
+	 * @param n transform size
+	 * @param in_alignment `fftwf_alignment_of` the input array the plan will be executed on
+	 * @param out_alignment `fftwf_alignment_of` the output array the plan will be executed on
+	 * @param flags FFTW planner flags
+	 * @throws `std::runtime_error` if FFTW fails to create the plan
+	 */
+	Plan get_r2c(int n, int in_alignment, int out_alignment, unsigned flags);
+
+	/**
+	 * Get a shared forward complex-to-complex plan of size `n`. Behaves like `get_r2c`.
+	 * @throws `std::runtime_error` if FFTW fails to create the plan
+	 */
+	Plan get_c2c(int n, int in_alignment, int out_alignment, unsigned flags);
+
+	/**
+	 * Get a shared plan performing `howmany` real-to-complex transforms of size `n` at once.
+	 * Input sample `i` of transform `t` is read from `in[i * howmany + t]` (i.e. interleaved channels),
+	 * and its bins are written to `out[t * (n / 2 + 1) ...]`. Behaves like `get_r2c`.
+	 * @throws `std::runtime_error` if FFTW fails to create the plan
+	 */
+	Plan get_r2c_interleaved(int n, int howmany, int in_alignment, int out_alignment, unsigned flags);
+
+	/**
+	 * Set the planner flags used by FFT wrappers that don't specify their own.
+	 * Only affects plans created after this call.
+	 * @param flags FFTW planner flags, e.g. `FFTW_MEASURE`
+	 */
+	void set_default_flags(unsigned flags);
+	unsigned get_default_flags();
+
+	/**
+	 * Merge FFTW wisdom from a file into the current process.
+	 * @param path wisdom file, usually written by `export_wisdom`
+	 * @returns whether the file was read successfully
+	 */
+	bool import_wisdom(const std::string &path);
+
+	/**
+	 * Save all wisdom accumulated by this process (including imported wisdom) to a file.
+	 * @param path wisdom file to (over)write
+	 * @returns whether the file was written successfully
+	 */
+	bool export_wisdom(const std::string &path);
+
+private:
+	Plan get(const Key &key);
+	static fftwf_plan create_plan(const Key &key, unsigned flags);
+	static void destroy_plan(fftwf_plan plan);
+};
+
+} // namespace avz
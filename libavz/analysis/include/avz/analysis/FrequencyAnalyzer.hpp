@@ -1,9 +1,10 @@
 #pragma once
 
+#include <memory>
 #include <span>
 #include <vector>
 
-#include <avz/analysis/fftwf_dft_r2c_1d.hpp>
+#include <avz/analysis/fft.hpp>
 
 namespace avz
 {
@@ -22,50 +23,183 @@ public:
 		Hanning,
 		Hamming,
 		Blackman,
+		// 4-term Blackman-Harris: very low sidelobes (-92 dB) for a wider main lobe
+		BlackmanHarris,
+		// flat-top: accurate peak amplitudes between bins, at the cost of frequency resolution
+		FlatTop,
+		// Kaiser-Bessel, shaped by `set_kaiser_beta`
+		Kaiser,
+	};
+
+	/**
+	 * How the transform size is chosen from the requested FFT size.
+	 * Sizes with large prime factors (e.g. 0.25s at 44.1kHz = 11025) make every FFT backend fall back to slow
+	 * algorithms, so the non-exact policies zero-pad the window up to a size they are fast at.
+	 * PFFFT needs multiples of 32 without prime factors above 5, which `PowerOfTwo` always gives (from 32 up);
+	 * sizes it can't transform fall back to another backend.
+	 */
+	enum class SizePolicy
+	{
+		// transform exactly `fft_size` samples
+		Exact,
+		// zero-pad to the next even 2^a * 3^b * 5^c * 7^d
+		Smooth,
+		// zero-pad to the next power of two
+		PowerOfTwo,
+	};
+
+	/**
+	 * Ways to combine the two channels of interleaved stereo audio into one signal.
+	 */
+	enum class StereoMix
+	{
+		// (L + R) / 2
+		Mid,
+		// (L - R) / 2
+		Side,
 	};
 
 private:
 	int fft_size;
-	fftwf_dft_r2c_1d fftw;
+	int transform_size;
+	SizePolicy size_policy;
+	fft::Backend fft_backend{fft::get_default_backend()};
+	fft::dft_r2c_1d fft;
 	WindowFunction window_func{WindowFunction::Hanning};
-	std::vector<float> window_values;
+	float kaiser_beta{8.6f};
+	// shared with other analyzers through WindowCache, null if the window function is None
+	std::shared_ptr<const aligned_vector<float>> window_values;
+	bool dc_removal{};
+	float pre_emphasis{};
 
 public:
 	/**
 	 * Initialize frequency spectrum renderer.
 	 * @param fft_size sample chunk size used by FFT processor
+	 * @param size_policy how to choose the transform size from `fft_size`
+	 * @throws `std::invalid_argument` if `fft_size` is not positive
 	 */
-	FrequencyAnalyzer(int fft_size);
+	FrequencyAnalyzer(int fft_size, SizePolicy size_policy = SizePolicy::Exact);
 
 	/**
 	 * Set the FFT size used in the backend library.
 	 * @param fft_size new fft size to use
 	 * @returns reference to self
-	 * @throws `std::invalid_argument` if `fft_size` is not even
+	 * @throws `std::invalid_argument` if `fft_size` is not positive
 	 */
 	void set_fft_size(int fft_size);
+
+	/**
+	 * Get the number of samples expected by `copy_to_input`, which the window function covers.
+	 */
 	inline constexpr int get_fft_size() const { return fft_size; }
 
+	/**
+	 * Set the size policy, possibly changing the transform size.
+	 * @param size_policy new size policy to use
+	 */
+	void set_size_policy(SizePolicy size_policy);
+	inline constexpr SizePolicy get_size_policy() const { return size_policy; }
+
+	/**
+	 * Get the size of the transform actually performed, which is `get_fft_size()` plus any zero-padding.
+	 * This determines the bin spacing: use it for any bin <-> Hz conversions on the output.
+	 */
+	inline constexpr int get_transform_size() const { return transform_size; }
+
+	/**
+	 * Compute the transform size a `SizePolicy` chooses for `fft_size` samples.
+	 * @throws `std::invalid_argument` if `fft_size` is not positive
+	 */
+	static int compute_transform_size(int fft_size, SizePolicy size_policy);
+
+	/**
+	 * Set the FFT backend to run the transform on, defaults to `fft::get_default_backend()` at construction.
+	 * If it can't transform `get_transform_size()` samples, another backend is used (see `fft::get_plan`).
+	 * @throws `std::invalid_argument` if `backend` isn't compiled in
+	 */
+	void set_fft_backend(fft::Backend backend);
+
+	/**
+	 * Get the backend actually running the transform.
+	 */
+	inline fft::Backend get_fft_backend() const { return fft.get_backend(); }
+
 	/**
 	 * Set window function.
 	 * @param wf new window function to use
 	 */
 	void set_window_func(WindowFunction wf);
+	inline constexpr WindowFunction get_window_func() const { return window_func; }
+
+	/**
+	 * Set the shape parameter of `WindowFunction::Kaiser`. Higher values trade a wider main lobe
+	 * for lower sidelobes; the default of 8.6 is comparable to `WindowFunction::Blackman`.
+	 * @param beta new beta, must be >= 0
+	 * @throws `std::invalid_argument` if `beta` is negative
+	 */
+	void set_kaiser_beta(float beta);
+	inline constexpr float get_kaiser_beta() const { return kaiser_beta; }
+
+	/**
+	 * Get the window values `copy_to_input` multiplies the input by, for callers that window samples themselves.
+	 * Empty if the window function is `WindowFunction::None`.
+	 */
+	inline std::span<const float> get_window() const
+	{
+		return window_values ? std::span<const float>{*window_values} : std::span<const float>{};
+	}
+
+	/**
+	 * Subtract the (window-weighted) mean of each window before applying the window function,
+	 * so a DC offset doesn't leak into the lowest bins. Disabled by default.
+	 */
+	inline void set_dc_removal(const bool enabled) { dc_removal = enabled; }
+	inline constexpr bool get_dc_removal() const { return dc_removal; }
+
+	/**
+	 * Apply the first-order pre-emphasis filter `y[n] = x[n] - coefficient * x[n - 1]` before windowing,
+	 * which tilts the spectrum towards high frequencies. Typical coefficients are 0.9-0.97; 0 (default) disables it.
+	 * @throws `std::invalid_argument` if `coefficient` is not in [0, 1]
+	 */
+	void set_pre_emphasis(float coefficient);
+	inline constexpr float get_pre_emphasis() const { return pre_emphasis; }
 
 	/**
 	 * Copies the `wavedata` to the FFT processor for rendering.
+	 * Any samples past `fft_size` in the transform are left zeroed.
 	 * @param wavedata input wave sample data, expected to be of size `fft_size`
 	 */
 	void copy_to_input(std::span<const float> wavedata);
 
-	inline constexpr void execute_fft() const { fftw.execute(); }
-	inline constexpr std::span<const std::complex<float>> get_output() const { return fftw.output(); }
+	/**
+	 * Copies one channel of interleaved audio (e.g. straight from `Media::read_audio`) to the FFT processor.
+	 * Gathering the channel, DC removal, pre-emphasis, and windowing happen in a single pass,
+	 * without an intermediate deinterleaved buffer.
+	 * @param interleaved interleaved audio containing at least `fft_size` frames; later frames are ignored
+	 * @param num_channels channel count of `interleaved`
+	 * @param channel channel to copy
+	 */
+	void copy_to_input(std::span<const float> interleaved, int num_channels, int channel);
+
+	/**
+	 * Copies the mid or side signal of interleaved stereo audio to the FFT processor, like the overload above.
+	 * @param interleaved interleaved stereo audio containing at least `fft_size` frames; later frames are ignored
+	 * @param mix which combination of the two channels to analyze
+	 */
+	void copy_to_input(std::span<const float> interleaved, StereoMix mix);
+
+	inline void execute_fft() const { fft.execute(); }
+	inline constexpr std::span<const std::complex<float>> get_output() const { return fft.output(); }
 
 private:
+	// `sample(i)` returns the i-th input sample, gathered/mixed from wherever it came from
+	template <typename Sample>
+	void fused_copy_to_input(Sample sample);
+	template <typename Sample>
+	void window_to_input(float x0, Sample x);
+
 	void compute_window_values();
-	void apply_hanning_window();
-	void apply_hamming_window();
-	void apply_blackman_window();
 };
 
 } // namespace avz
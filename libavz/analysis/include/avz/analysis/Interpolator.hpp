@@ -1,7 +1,7 @@
 #pragma once
 
+#include <avz/analysis/Spline.hpp>
 #include <span>
-#include <tk-spline.hpp>
 #include <vector>
 
 namespace avz
@@ -9,21 +9,26 @@ namespace avz
 
 /**
  * Handles interpolation of frequency spectrum data using various methods.
+ * Storage is kept between calls, so after the first few frames (or `reserve`) interpolating doesn't allocate.
  */
 class Interpolator
 {
 public:
 	enum class InterpolationType
 	{
-		LINEAR = tk::spline::linear,
-		CSPLINE = tk::spline::cspline,
-		CSPLINE_HERMITE = tk::spline::cspline_hermite
+		LINEAR,
+		// natural cubic spline
+		CSPLINE,
+		// cubic hermite spline, slopes from neighbouring points
+		CSPLINE_HERMITE,
+		// monotone cubic (fritsch-carlson), never overshoots between points
+		MONOTONE
 	};
 
 private:
-	tk::spline spline;
-	std::vector<double> m_spline_x, m_spline_y;
-	std::vector<size_t> zero_indices;
+	Spline spline;
+	std::vector<float> m_spline_x, m_spline_y;
+	std::vector<float> zero_x, zero_y;
 	InterpolationType type{InterpolationType::CSPLINE};
 
 public:
@@ -38,6 +43,11 @@ public:
 	 */
 	InterpolationType get_interp_type() const { return type; }
 
+	/**
+	 * Reserve storage for spectra of up to `size` values.
+	 */
+	void reserve(size_t size);
+
 	/**
 	 * Interpolate spectrum data to fill gaps between non-zero values.
 	 * Uses the interpolation type set via set_interp_type().
@@ -53,11 +63,15 @@ public:
 	void set_values(std::span<const float> values);
 
 	/**
-	 * Sample the spline at a given X coordinate.
+	 * Sample the spline fit by the last `set_values` or `interpolate` at a given X coordinate.
+	 * Returns 0 if there is none, e.g. when the last `interpolate` found no gaps to fill.
 	 * @param x X coordinate (index)
 	 * @return interpolated value
 	 */
 	inline float sample(float x) const { return spline(x); }
+
+private:
+	void update_spline_type();
 };
 
 } // namespace avz
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace avz
+{
+
+/**
+ * Work-stealing job system for fork-join parallelism within a frame, e.g. spreading analysis over the cores
+ * in `Base::update` and joining before rendering.
+ *
+ * Every thread submitting jobs owns a fixed-size Chase-Lev deque and the job storage behind it: it pushes and
+ * pops at the bottom of its own deque, and idle threads steal from the top of the others'. Submitting a job
+ * copies its callable into that storage, so it never allocates or takes a lock. Idle workers spin briefly and
+ * then sleep on an atomic, which submitters only wake if someone is asleep.
+ *
+ * Waiting on a `TaskGroup` runs jobs (of any group) until the group is done, so jobs can fork and wait on
+ * nested groups, and the waiting thread is one of the threads doing the work.
+ */
+class JobSystem
+{
+public:
+	// capacity of every thread's deque; a job submitted to a full deque runs immediately instead
+	static constexpr int queue_capacity = 256;
+
+	// size of the callable a job can hold; capture large state by reference
+	static constexpr size_t job_storage_size = 48;
+
+	// threads other than the workers that can submit jobs at the same time
+	static constexpr int max_external_threads = 8;
+
+	/**
+	 * Jobs to wait for together. Destroying a group waits for its jobs first (dropping their exceptions), so
+	 * jobs capturing locals by reference never outlive them, even if an exception skips the `wait`.
+	 */
+	class TaskGroup
+	{
+		friend class JobSystem;
+		std::atomic<int> pending{};
+		std::atomic<bool> failed{};
+		std::exception_ptr error;
+
+		// the system jobs were submitted to
+		std::atomic<JobSystem *> system{};
+
+	public:
+		TaskGroup() = default;
+		~TaskGroup();
+		TaskGroup(const TaskGroup &) = delete;
+		TaskGroup &operator=(const TaskGroup &) = delete;
+
+		/**
+		 * Whether every job submitted so far has finished.
+		 */
+		inline bool done() const { return !pending.load(std::memory_order_acquire); }
+	};
+
+private:
+	struct Job
+	{
+		alignas(16) std::byte storage[job_storage_size];
+		void (*invoke)(const void *storage);
+		TaskGroup *group;
+		// set while the job is in a deque or running, so its storage isn't reused
+		std::atomic<bool> busy{};
+	};
+
+	// one thread's deque and job storage, defined in JobSystem.cpp
+	struct Context;
+
+	// workers first, then the contexts claimed by external threads
+	std::unique_ptr<Context[]> contexts;
+	int num_workers;
+	std::vector<std::jthread> workers;
+
+	// distinguishes systems in the thread-local context cache, addresses can be reused
+	unsigned id;
+
+	// bumped whenever a job is submitted or a group finishes; sleeping threads wait on it
+	std::atomic<unsigned> epoch{};
+	std::atomic<int> sleepers{};
+	std::atomic<bool> stopping{};
+
+public:
+	/**
+	 * @param num_threads threads running jobs, including the thread waiting on a group; 0 for the hardware
+	 * concurrency. `num_threads - 1` workers are started.
+	 * @throws `std::invalid_argument` if `num_threads` is negative
+	 */
+	explicit JobSystem(int num_threads = 0);
+	~JobSystem();
+
+	JobSystem(const JobSystem &) = delete;
+	JobSystem &operator=(const JobSystem &) = delete;
+
+	/**
+	 * Get the process-wide job system, with a thread per core.
+	 */
+	static JobSystem &instance();
+
+	/**
+	 * Get the number of threads running jobs, including the waiting thread.
+	 */
+	inline int get_thread_count() const { return num_workers + 1; }
+
+	/**
+	 * Submit `f()` to run on any thread as part of `group`. It runs immediately on the calling thread if its deque
+	 * is full, or it is the `max_external_threads + 1`-th thread other than the workers to submit jobs.
+	 * @param f callable small enough to store in a job, trivially copyable and destructible, e.g. a lambda
+	 * capturing by reference
+	 */
+	template <typename F>
+	void run(TaskGroup &group, const F &f)
+	{
+		static_assert(
+			sizeof(F) <= job_storage_size && alignof(F) <= alignof(Job) && std::is_trivially_copyable_v<F> &&
+				std::is_trivially_destructible_v<F>,
+			"[JobSystem::run] callable must fit in a job and be trivially copyable; capture by reference");
+
+		group.system.store(this, std::memory_order_relaxed);
+		Job *const job = acquire_job();
+		if (!job)
+		{
+			run_inline(group, [](const void *f) { (*static_cast<const F *>(f))(); }, &f);
+			return;
+		}
+		::new (job->storage) F{f};
+		job->invoke = [](const void *f) { (*static_cast<const F *>(f))(); };
+		job->group = &group;
+		submit(job);
+	}
+
+	/**
+	 * Run jobs until every job of `group` has finished.
+	 * @throws the first exception thrown by a job of `group`, after all of them have finished
+	 */
+	void wait(TaskGroup &group);
+
+	/**
+	 * Run `f(i)` for every `i` in [0, count) across the threads and wait for all of them.
+	 * @throws the first exception thrown by `f`, after every call has finished
+	 */
+	template <typename F>
+	void parallel_for(const int count, const F &f)
+	{
+		TaskGroup group;
+		for (int i = 0; i < count; ++i)
+			run(group, [&f, i] { f(i); });
+		wait(group);
+	}
+
+private:
+	Context *current_context();
+	Job *acquire_job();
+	void submit(Job *job);
+	void join(TaskGroup &group);
+	void run_inline(TaskGroup &group, void (*invoke)(const void *), const void *f);
+	void execute(Job *job);
+	Job *find_job(Context *self);
+	void sleep(unsigned seen);
+	void worker_loop(int index);
+};
+
+} // namespace avz
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <avz/analysis/BinPacker.hpp>
+#include <avz/analysis/BinPlan.hpp>
+#include <avz/analysis/Interpolator.hpp>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace avz
+{
+
+/**
+ * Bin packing and gap filling compiled into one precomputed operator.
+ * Spreading a spectrum onto a log scale leaves output bins that no input bin maps to. Which bins those are,
+ * and which filled bins surround them, only depends on the sizes and the scale, so the gap-filling weights are
+ * computed along with the `BinPlan`. Each `remap` packs the filled bins, then writes every gap from at most 4
+ * filled neighbours: no allocation and no zero detection, so genuinely silent bins stay silent.
+ *
+ * Unlike `Interpolator::interpolate`, the natural cubic spline isn't available, since its gap values depend
+ * on every filled bin. `CSPLINE`, `CSPLINE_HERMITE` and `MONOTONE` all use cubic Hermite weights with slopes
+ * from neighbouring filled bins (the `Spline::Type::HERMITE` curve), and `LINEAR` uses linear weights.
+ * Gaps before the first or after the last filled bin take that bin's value.
+ *
+ * Packing with `SUM` keeps the spectrum's total, but filling gaps adds to it: a lot at the low end, where a few
+ * input bins are spread over many output bins. The Hermite curves can also overshoot next to a peak.
+ */
+class LogSpectrumRemapper
+{
+	BinPacker packer;
+	Interpolator::InterpolationType type;
+
+	// plan the gaps were computed for
+	std::shared_ptr<const BinPlan> plan;
+
+	struct Gap
+	{
+		int row;
+		std::array<int, 4> sources;
+		std::array<float, 4> weights;
+	};
+	std::vector<Gap> gaps;
+
+public:
+	LogSpectrumRemapper(
+		BinPacker::Scale scale = BinPacker::Scale::LOG,
+		BinPacker::AccumulationMethod am = BinPacker::AccumulationMethod::MAX,
+		Interpolator::InterpolationType type = Interpolator::InterpolationType::CSPLINE_HERMITE);
+
+	/**
+	 * Set the spectrum's frequency scale. See `BinPacker::set_scale`.
+	 */
+	void set_scale(BinPacker::Scale scale);
+
+	/**
+	 * Set the nth-root to use when using the `NTH_ROOT` scale.
+	 * @throws `std::invalid_argument` if `nth_root` is zero
+	 */
+	void set_nth_root(int nth_root);
+
+	/**
+	 * Set frequency bin accumulation method.
+	 */
+	void set_accum_method(BinPacker::AccumulationMethod am);
+
+	/**
+	 * Set how gaps are filled.
+	 */
+	void set_interp_type(Interpolator::InterpolationType type);
+
+	inline BinPacker::Scale get_scale() const { return packer.get_scale(); }
+	inline BinPacker::AccumulationMethod get_accum_method() const { return packer.get_accum_method(); }
+	inline Interpolator::InterpolationType get_interp_type() const { return type; }
+
+	/**
+	 * Number of output bins filled by interpolation in the last `remap`.
+	 */
+	inline int get_gap_count() const { return gaps.size(); }
+
+	/**
+	 * Pack `in` into `out` and fill the gaps. The operator is recompiled only when a setting or either size changes.
+	 * @param out output spectrum (smaller size)
+	 * @param in input spectrum (larger size)
+	 */
+	void remap(std::span<float> out, std::span<const float> in);
+
+private:
+	void compile_gaps();
+};
+
+} // namespace avz
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <avz/analysis/AudioAnalyzer.hpp>
+#include <avz/analysis/fft.hpp>
 #include <span>
 #include <vector>
 
@@ -8,50 +9,131 @@ namespace avz
 {
 
 /**
- * Multi-channel audio analyzer that manages separate AudioAnalyzer instances per channel.
+ * Multi-channel audio analyzer that transforms every channel of an interleaved buffer at once.
  * Useful for stereo/multi-channel audio analysis.
+ *
+ * All channels are windowed in a single pass over the interleaved buffer and transformed by one batched
+ * plan execution: a single FFTW call, or one channel after another with the other FFT backends.
+ * Every channel gets the DC removal and pre-emphasis set on the `FrequencyAnalyzer`, exactly like
+ * `FrequencyAnalyzer::copy_to_input` applies them to one channel.
+ * Amplitudes are stored as a contiguous channels x bins matrix.
+ *
+ * With exactly 2 channels, both are transformed at once by packing them into the real and imaginary
+ * parts of one complex FFT, then separating the two spectra using the conjugate symmetry of real signals.
  */
 class MultiChannelAudioAnalyzer
 {
 	int num_channels{};
-	std::vector<AudioAnalyzer> analyzers;
+
+	// bins per channel, and the number of real samples per channel that produced them
+	int bins{}, fft_size{};
+
+	fft::dft_r2c_1d_interleaved batch_fft;
+
+	bool packed_stereo{true};
+	fft::dft_1d stereo_fft;
+	std::vector<std::complex<float>> stereo_spectra;
+
+	// per-channel means for DC removal
+	std::vector<float> channel_means;
+
+	// output of the last execute_fft, one row of `bins` per channel
+	std::span<const std::complex<float>> spectra;
+
+	std::vector<float> _amplitudes;
 
 public:
 	/**
 	 * Construct analyzer for N channels.
 	 * @param num_channels Number of audio channels (1=mono, 2=stereo, etc.)
-	 * @param sample_rate_hz Audio sample rate in Hz
-	 * @param window_size_samples FFT window size in samples
 	 */
 	MultiChannelAudioAnalyzer(int num_channels);
 
 	/**
 	 * Execute FFT on interleaved multi-channel audio buffer.
-	 * Automatically distributes audio to per-channel analyzers.
-	 * @param fa FrequencyAnalyzer (shared across channels)
-	 * @param interleaved_audio Interleaved audio buffer (size = window_size * num_channels)
+	 * @param fa FrequencyAnalyzer providing the FFT size, transform size, window, DC removal, and pre-emphasis
+	 * @param interleaved_audio Interleaved audio buffer (size >= fft_size * num_channels); later frames are ignored
 	 */
-	void execute_fft(FrequencyAnalyzer &fa, std::span<const float> interleaved_audio);
+	void execute_fft(const FrequencyAnalyzer &fa, std::span<const float> interleaved_audio);
 
-	void compute_amplitudes(FrequencyAnalyzer &fa);
+	/**
+	 * Compute the amplitudes of every channel from the last `execute_fft`.
+	 */
+	void compute_amplitudes();
 
 	/**
-	 * Get analyzer for specific channel.
+	 * Get the amplitudes of one channel.
 	 * @param channel Channel index (0-based)
+	 * @throws `std::out_of_range` if `channel` is invalid
+	 * @throws `std::logic_error` if `compute_amplitudes` hasn't been called
+	 */
+	std::span<const float> get_amplitudes(int channel) const;
+
+	/**
+	 * Get the amplitudes of every channel, `get_bin_count()` per channel, channel 0 first.
+	 * @throws `std::logic_error` if `compute_amplitudes` hasn't been called
+	 */
+	std::span<const float> get_amplitudes() const;
+
+	/**
+	 * Get the complex spectrum of one channel from the last `execute_fft`, `get_bin_count()` bins.
+	 * @throws `std::out_of_range` if `channel` is invalid
+	 * @throws `std::logic_error` if `execute_fft` hasn't been called
 	 */
-	AudioAnalyzer &operator[](int channel);
-	const AudioAnalyzer &operator[](int channel) const;
+	std::span<const std::complex<float>> get_spectrum(int channel) const;
+
+	/**
+	 * Enable or disable the packed complex FFT for 2 channels (enabled by default).
+	 * When disabled, 2 channels go through the batched real FFT like any other channel count.
+	 */
+	inline void set_packed_stereo(const bool enabled) { packed_stereo = enabled; }
+	inline bool get_packed_stereo() const { return packed_stereo; }
 
 	/**
 	 * Get number of channels.
 	 */
 	inline int get_num_channels() const { return num_channels; }
 
+	/**
+	 * Get number of bins per channel.
+	 */
+	inline int get_bin_count() const { return bins; }
+
+	/**
+	 * Find the loudest bin of one channel between `from_hz` and `to_hz`.
+	 * @throws `std::logic_error` if `compute_amplitudes` hasn't been called
+	 */
+	AudioAnalyzer::FrequencyAmplitudePair compute_peak_frequency(
+		const FrequencyAnalyzer &fa, int channel, float sample_rate_hz, int from_hz, int to_hz) const;
+
 	/**
 	 * Average peak frequency across all channels (useful for stereo->mono reduction).
 	 */
 	AudioAnalyzer::FrequencyAmplitudePair
-	compute_averaged_peak_frequency(const FrequencyAnalyzer &fa, int sample_rate_hz, int from_hz, int to_hz);
+	compute_averaged_peak_frequency(const FrequencyAnalyzer &fa, float sample_rate_hz, int from_hz, int to_hz) const;
+
+	/**
+	 * Estimate the loudest peak of every channel to a fraction of a bin (see `PeakEstimator`),
+	 * and average the frequencies and amplitudes across channels.
+	 * @param estimators one estimator per channel, all tracking this range
+	 * @param hop samples the analysis window moved since the previous frame, for the phase vocoder
+	 * @throws `std::invalid_argument` if there isn't one estimator per channel
+	 * @throws `std::logic_error` if `compute_amplitudes` hasn't been called
+	 */
+	PeakEstimator::Estimate estimate_averaged_peak_frequency(
+		const FrequencyAnalyzer &fa,
+		float sample_rate_hz,
+		int from_hz,
+		int to_hz,
+		std::span<PeakEstimator> estimators,
+		int hop = 0) const;
+
+private:
+	void execute_batched_fft(const FrequencyAnalyzer &fa, std::span<const float> interleaved_audio);
+	void execute_packed_stereo_fft(const FrequencyAnalyzer &fa, std::span<const float> interleaved_audio);
+
+	// preprocess and window `fft_size` frames of every channel from `in` to `out`, both interleaved
+	void window_channels(const FrequencyAnalyzer &fa, const float *in, float *out);
 };
 
 } // namespace avz
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+namespace avz
+{
+
+/**
+ * Onset detector and tempo tracker driven by one amplitude frame per call, e.g. from `AudioAnalyzer`
+ * once per video frame.
+ *
+ * The onset envelope is the half-wave rectified spectral flux between consecutive frames (see
+ * `simd::spectral_flux`). An onset is a local maximum of the flux above an adaptive threshold: a running mean
+ * of the flux times a multiplier, plus an offset. Onsets are confirmed one frame late, since a maximum
+ * can't be recognized until the flux falls again.
+ *
+ * Tempo comes from an exponentially decaying autocorrelation of the onset envelope over the lags
+ * in the tempo range, updated incrementally. Each frame costs O(bins + lags), independent of how much history
+ * the autocorrelation remembers.
+ */
+class OnsetAnalyzer
+{
+	float frame_rate_hz;
+
+	// autocorrelation lags in frames, covering [min_bpm, max_bpm]
+	int min_lag, max_lag;
+
+	// per-frame decay of the running mean and the autocorrelation
+	float mean_decay, acf_decay;
+
+	float threshold_multiplier{1.5f}, threshold_offset{};
+	int min_interval;
+
+	std::vector<float> prev_amplitudes;
+
+	// flux of the last two frames, newest first, for peak picking
+	float flux[2]{}, threshold{};
+
+	// running mean of the flux as a decaying sum over the decaying frame count, so it is unbiased from the start
+	float flux_sum{}, frame_weight{};
+	int frames_since_onset;
+	bool onset{};
+
+	// onset envelope above its mean, each value written twice `max_lag` apart so any lag window is contiguous
+	std::vector<float> novelty;
+	int novelty_pos{};
+
+	// acf[l - min_lag] = sum over t of decay^age * novelty[t] * novelty[t - l]
+	std::vector<float> acf;
+	float energy{};
+
+	// acf weighted by the tempo prior, scratch for picking the tempo
+	std::vector<float> lag_weights, scores;
+	float tempo_bpm{}, tempo_confidence{};
+
+public:
+	/**
+	 * @param frame_rate_hz rate at which `process` is called
+	 * @param min_bpm slowest tempo to track
+	 * @param max_bpm fastest tempo to track
+	 * @param tempo_memory_sec time constant of the autocorrelation; longer is steadier but slower to follow changes
+	 * @throws `std::invalid_argument` if the tempo range isn't positive and increasing, or spans fewer than 3 lags
+	 * at `frame_rate_hz`
+	 */
+	OnsetAnalyzer(float frame_rate_hz, float min_bpm = 60, float max_bpm = 200, float tempo_memory_sec = 8);
+
+	/**
+	 * Analyze the next amplitude frame. The first frame, and any frame whose size differs from the previous one,
+	 * only becomes the reference for the next.
+	 * @returns whether an onset was confirmed at the previous frame
+	 */
+	bool process(std::span<const float> amplitudes);
+
+	/**
+	 * Forget all previous frames, onsets and tempo.
+	 */
+	void reset();
+
+	/**
+	 * An onset needs `flux > mean * multiplier + offset`, where `mean` is the running mean flux
+	 * over about half a second.
+	 */
+	void set_threshold(float multiplier, float offset = 0);
+
+	/**
+	 * Set the shortest time between two onsets.
+	 */
+	void set_min_interval(float seconds);
+
+	/**
+	 * Get the spectral flux of the last frame, normalized by the bin count.
+	 */
+	inline float get_flux() const { return flux[0]; }
+
+	/**
+	 * Get the threshold the last frame's flux was compared against.
+	 */
+	inline float get_threshold() const { return threshold; }
+
+	/**
+	 * Whether the last `process` confirmed an onset.
+	 */
+	inline bool is_onset() const { return onset; }
+
+	/**
+	 * Get the estimated tempo, or 0 before any onset energy has been seen.
+	 */
+	inline float get_tempo_bpm() const { return tempo_bpm; }
+
+	/**
+	 * Get how periodic the onset envelope is at the estimated tempo, from 0 to 1.
+	 */
+	inline float get_tempo_confidence() const { return tempo_confidence; }
+
+	inline float get_frame_rate() const { return frame_rate_hz; }
+
+private:
+	void update_tempo(float x);
+};
+
+} // namespace avz
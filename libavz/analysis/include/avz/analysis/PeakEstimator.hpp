@@ -0,0 +1,92 @@
+#pragma once
+
+#include <complex>
+#include <span>
+#include <vector>
+
+namespace avz
+{
+
+/**
+ * Estimates the frequency and amplitude of the loudest peak in a frequency range to a fraction of a bin.
+ * The loudest bin is refined by fitting a parabola through it and its two neighbours, so a short FFT
+ * tracks a tone's frequency as smoothly as a much longer one.
+ *
+ * With the phase vocoder enabled, the estimate is refined further using how far the peak bin's phase moved
+ * since the previous frame. This is accurate to a small fraction of a bin, as long as the interpolated estimate
+ * is within `sample_rate_hz / (2 * hop)` Hz of the true frequency.
+ *
+ * Keep one estimator per tracked range and channel, since the phase vocoder remembers the previous frame.
+ */
+class PeakEstimator
+{
+public:
+	enum class Interpolation
+	{
+		// bin center, like `AudioAnalyzer::compute_peak_frequency`
+		None,
+		// parabola through the amplitudes
+		Quadratic,
+		// parabola through the log amplitudes: exact for gaussian windows, and very close for hann and blackman
+		Gaussian
+	};
+
+	struct Estimate
+	{
+		float frequency_hz;
+		float amplitude;
+	};
+
+private:
+	Interpolation interpolation;
+	bool phase_vocoder;
+
+	// previous frame's bins in the tracked range, for the phase vocoder
+	std::vector<std::complex<float>> prev_spectrum;
+	int prev_first_bin{}, prev_transform_size{};
+
+public:
+	PeakEstimator(Interpolation interpolation = Interpolation::Gaussian, bool phase_vocoder = false);
+
+	inline void set_interpolation(const Interpolation interpolation) { this->interpolation = interpolation; }
+	inline Interpolation get_interpolation() const { return interpolation; }
+
+	/**
+	 * Enable or disable phase vocoder refinement. Takes effect from the frame after the next `estimate`.
+	 */
+	void set_phase_vocoder(bool enabled);
+	inline bool get_phase_vocoder() const { return phase_vocoder; }
+
+	/**
+	 * Forget the previous frame.
+	 */
+	void reset();
+
+	/**
+	 * Estimate the loudest peak between `from_hz` and `to_hz`.
+	 * @param spectrum complex bins the amplitudes were computed from; only used by the phase vocoder
+	 * @param amplitudes amplitudes starting at bin 0
+	 * @param sample_rate_hz effective sample rate of the analyzed samples
+	 * @param transform_size transform size that produced `spectrum`
+	 * @param hop samples the analysis window moved since the previous call; only used by the phase vocoder
+	 * @param from_hz lowest frequency to search
+	 * @param to_hz highest frequency to search
+	 */
+	Estimate estimate(
+		std::span<const std::complex<float>> spectrum,
+		std::span<const float> amplitudes,
+		float sample_rate_hz,
+		int transform_size,
+		int hop,
+		int from_hz,
+		int to_hz);
+
+	/**
+	 * Refine the loudest bin `peak_bin` by interpolation alone.
+	 * @returns fractional bin index and interpolated amplitude
+	 */
+	static std::pair<float, float>
+	interpolate(std::span<const float> amplitudes, int peak_bin, Interpolation interpolation);
+};
+
+} // namespace avz
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <avz/analysis/AudioAnalyzer.hpp>
+#include <avz/analysis/FrequencyAnalyzer.hpp>
+#include <span>
+#include <vector>
+
+namespace avz
+{
+
+/**
+ * Keeps a narrow range of DFT bins up to date as new samples arrive, using the sliding DFT recurrence.
+ * Each new sample costs O(bins) instead of running a full `window_size` FFT every frame, which is much
+ * cheaper when only a small slice of the spectrum is needed (e.g. 0-250 Hz for bass-reactive effects).
+ *
+ * Windowing is applied in the frequency domain: the supported window functions are sums of cosines,
+ * which become short kernels over neighbouring bins. Only the periodic form of each window (cosines of
+ * `2*pi*n / N`) has such a kernel, while `FrequencyAnalyzer` uses the symmetric form (`2*pi*n / (N - 1)`).
+ * So results match a `FrequencyAnalyzer` of the same size to within floating point error only with `None`;
+ * windowed, they differ by a fraction of a percent of the loudest bin for windows of 512 samples or more,
+ * and less the longer the window.
+ *
+ * The recurrence accumulates rounding error over time, so the bins are periodically recomputed
+ * from the sample history with the Goertzel algorithm ("re-anchored").
+ */
+class SlidingDftAnalyzer
+{
+	int window_size, sample_rate_hz;
+	FrequencyAnalyzer::WindowFunction window_func{FrequencyAnalyzer::WindowFunction::Hanning};
+
+	// requested bins, and the bins actually tracked (requested +- 2 neighbours for the window kernel)
+	int first_bin, last_bin;
+	int first_tracked, last_tracked;
+
+	// unwindowed DFT of the tracked bins, and their per-sample rotations e^(j*2*pi*k/N)
+	std::vector<double> bins_re, bins_im;
+	std::vector<double> twiddles_re, twiddles_im;
+
+	// the last `window_size` samples, oldest at `history_pos`
+	std::vector<float> history;
+	int history_pos{};
+
+	int reanchor_interval;
+	int samples_since_anchor{};
+	bool primed{};
+
+	std::vector<float> _amplitudes;
+
+public:
+	/**
+	 * @param window_size number of samples in the sliding window, equivalent to `FrequencyAnalyzer`'s fft size
+	 * @param sample_rate_hz sample rate of the analyzed audio
+	 * @param from_hz lowest frequency to track
+	 * @param to_hz highest frequency to track
+	 * @throws `std::invalid_argument` if the sizes or frequency range are invalid
+	 */
+	SlidingDftAnalyzer(int window_size, int sample_rate_hz, int from_hz, int to_hz);
+
+	/**
+	 * Set window function. Takes effect on the next `compute_amplitudes`.
+	 * Only `None`, `Hanning`, `Hamming`, and `Blackman` are supported; others make `compute_amplitudes` throw.
+	 * @param wf new window function to use
+	 */
+	inline void set_window_func(const FrequencyAnalyzer::WindowFunction wf) { window_func = wf; }
+
+	/**
+	 * Set how many pushed samples may pass before the bins are recomputed from scratch.
+	 * Defaults to `window_size`, which keeps drift negligible at about the cost of the sliding updates.
+	 * @param samples re-anchor interval in samples
+	 */
+	void set_reanchor_interval(int samples);
+
+	/**
+	 * Replace the whole history with a full window of audio and recompute all bins.
+	 * @param window audio containing at least `window_size` frames
+	 * @param num_channels channel count if `window` is interleaved
+	 * @param channel channel to analyze
+	 */
+	void prime(std::span<const float> window, int num_channels = 1, int channel = 0);
+
+	/**
+	 * Slide the window forward by the given samples, updating every tracked bin.
+	 * @param samples new audio, oldest first
+	 * @param num_channels channel count if `samples` is interleaved
+	 * @param channel channel to analyze
+	 */
+	void push(std::span<const float> samples, int num_channels = 1, int channel = 0);
+
+	/**
+	 * Convenience for render loops that receive the latest window of audio every frame, where
+	 * the window moves forward by `hop` frames between calls (e.g. `Player`'s audio frames per video frame).
+	 * Primes on the first call, then only pushes the newest `hop` frames of the window.
+	 * @param audio audio buffer containing at least `window_size` frames; only the first `window_size` are used
+	 * @param hop frames the window moved since the previous call
+	 * @param num_channels channel count if `audio` is interleaved
+	 * @param channel channel to analyze
+	 */
+	void update(std::span<const float> audio, int hop, int num_channels = 1, int channel = 0);
+
+	/**
+	 * Apply the window and compute amplitudes of the requested bins, normalized like `AudioAnalyzer`'s.
+	 */
+	void compute_amplitudes();
+
+	/**
+	 * Get the amplitudes of the requested bins, starting at `get_first_bin()`.
+	 * @throws `std::logic_error` if `compute_amplitudes` hasn't been called
+	 */
+	std::span<const float> get_amplitudes() const;
+
+	inline int get_first_bin() const { return first_bin; }
+	inline int get_window_size() const { return window_size; }
+
+	/**
+	 * Find the loudest bin between `from_hz` and `to_hz`, clamped to the tracked range.
+	 * @throws `std::logic_error` if `compute_amplitudes` hasn't been called
+	 */
+	AudioAnalyzer::FrequencyAmplitudePair compute_peak_frequency(int from_hz, int to_hz) const;
+
+	/**
+	 * Sum of squared amplitudes between `from_hz` and `to_hz`, clamped to the tracked range.
+	 * @throws `std::logic_error` if `compute_amplitudes` hasn't been called
+	 */
+	float compute_band_energy(int from_hz, int to_hz) const;
+
+private:
+	void reanchor();
+	std::pair<int, int> bin_range(int from_hz, int to_hz) const;
+};
+
+} // namespace avz
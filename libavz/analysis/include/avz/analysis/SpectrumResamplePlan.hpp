@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <avz/analysis/Interpolator.hpp>
+#include <compare>
+#include <span>
+#include <vector>
+
+namespace avz
+{
+
+/**
+ * Precomputed resampling of a spectrum's amplitudes onto a fixed grid of output frequencies.
+ * Every output point depends on at most 4 neighbouring input bins, so the plan stores the first bin and the
+ * 4 weights of each point once, and each `execute` is a short gather-multiply-add over only the bins the grid
+ * touches. Bins outside the grid's frequency range are never read.
+ *
+ * The cubic types use cubic Hermite (Catmull-Rom) weights, which only depend on the 4 nearest bins: the same
+ * curve as `Interpolator`'s `CSPLINE_HERMITE`. For `CSPLINE` this is a local approximation of the natural cubic
+ * spline, which depends on every bin. `MONOTONE` also uses these weights, since its slopes depend on the
+ * amplitudes and can't be precomputed. `LINEAR` uses 2 of the 4 weights, and matches `Interpolator`'s `LINEAR`.
+ */
+class SpectrumResamplePlan
+{
+public:
+	struct Grid
+	{
+		// number of output points
+		int out_size;
+		// sample rate of the analyzed samples
+		float sample_rate_hz;
+		// transform size that produced the input amplitudes
+		int fft_size;
+		// frequencies (Hz) of the first and last output points
+		float start_freq, end_freq;
+		auto operator<=>(const Grid &) const = default;
+	};
+
+private:
+	Grid grid{};
+	Interpolator::InterpolationType type;
+	int in_size{};
+
+	// output point i is the dot product of weights[i] and the 4 input bins starting at first_bin[i]
+	std::vector<int> first_bin;
+	std::vector<std::array<float, 4>> weights;
+
+public:
+	/**
+	 * Create an empty plan, to be compiled by `set_grid`.
+	 */
+	SpectrumResamplePlan(Interpolator::InterpolationType type = Interpolator::InterpolationType::CSPLINE);
+
+	/**
+	 * @throws `std::invalid_argument` under the same conditions as `set_grid`
+	 */
+	SpectrumResamplePlan(
+		const Grid &grid, Interpolator::InterpolationType type = Interpolator::InterpolationType::CSPLINE);
+
+	/**
+	 * Compile the plan for `grid`, unless it already is.
+	 * @throws `std::invalid_argument` if `out_size` or `sample_rate_hz` is not positive,
+	 * or `fft_size` is less than 6 (fewer than 4 input bins)
+	 */
+	void set_grid(const Grid &grid);
+
+	/**
+	 * Set the interpolation type, recompiling the plan if needed.
+	 */
+	void set_interp_type(Interpolator::InterpolationType type);
+
+	inline const Grid &get_grid() const { return grid; }
+	inline Interpolator::InterpolationType get_interp_type() const { return type; }
+
+	/**
+	 * Number of input bins expected by `execute`, i.e. `fft_size / 2 + 1`.
+	 */
+	inline int get_input_size() const { return in_size; }
+
+	/**
+	 * Resample `in_amps` onto the grid.
+	 * @param out output spectrum, `get_grid().out_size` values
+	 * @param in_amps amplitudes from `AudioAnalyzer`, at least `get_input_size()` values
+	 * @throws `std::logic_error` if no grid was set
+	 */
+	void execute(std::span<float> out, std::span<const float> in_amps) const;
+
+private:
+	void compile();
+};
+
+} // namespace avz
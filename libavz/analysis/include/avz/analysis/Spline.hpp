@@ -0,0 +1,104 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+namespace avz
+{
+
+/**
+ * Single-precision piecewise-cubic interpolator.
+ * All storage is owned by the spline and only grows, so after `reserve` (or the first few frames)
+ * setting points and sampling never allocate.
+ *
+ * The natural cubic spline's tridiagonal system depends only on the X values, so its Thomas-algorithm
+ * factorization is kept and reused as long as the X values match the previous `set_points` call.
+ * Spectrum gap-filling usually hits this path, since the same bins are empty frame after frame.
+ *
+ * Outside the knots, the spline is extended linearly using the slope at the nearest end.
+ */
+class Spline
+{
+public:
+	enum class Type
+	{
+		// straight lines between knots
+		LINEAR,
+		// natural cubic spline (zero second derivative at both ends): smoothest, but may overshoot
+		NATURAL,
+		// cubic hermite with slopes from the parabola through each knot and its neighbours: local, may overshoot
+		HERMITE,
+		// fritsch-carlson monotone cubic: never overshoots between knots
+		MONOTONE
+	};
+
+private:
+	Type type{Type::NATURAL};
+
+	// knots
+	std::vector<float> x, y;
+
+	// whether x is 0, 1, 2, ..., so segments can be found without searching
+	bool uniform{};
+
+	// segment i: y[i] + b[i] * dx + c[i] * dx^2 + d[i] * dx^3, with dx = X - x[i]
+	// the last entry only holds the slope used to extend the spline past the last knot
+	std::vector<float> b, c, d;
+
+	// thomas-algorithm factorization of the natural spline system, valid while `factored_x == x`
+	std::vector<float> factored_x, upper, inv_pivot;
+
+	// slopes or right-hand side, depending on the type
+	std::vector<float> scratch;
+
+public:
+	/**
+	 * Set the spline type. Takes effect on the next `set_points` or `set_values`.
+	 */
+	inline void set_type(const Type type) { this->type = type; }
+	inline Type get_type() const { return type; }
+
+	/**
+	 * Reserve storage for `n` knots, so that later calls with at most `n` knots never allocate.
+	 */
+	void reserve(size_t n);
+
+	/**
+	 * Fit the spline through the given knots.
+	 * @param x X values, strictly increasing
+	 * @param y Y values, same size as `x`
+	 */
+	void set_points(std::span<const float> x, std::span<const float> y);
+
+	/**
+	 * Fit the spline through `values`, with X values 0, 1, 2, ...
+	 * @param values Y values
+	 */
+	void set_values(std::span<const float> values);
+
+	/**
+	 * Number of knots.
+	 */
+	inline size_t size() const { return x.size(); }
+
+	/**
+	 * Sample the spline at `X`. Returns 0 if the spline has no knots.
+	 */
+	float operator()(float X) const;
+
+	/**
+	 * Sample the spline at increasing X values, walking the segments instead of searching for each one.
+	 * @param xs X values, non-decreasing
+	 * @param out one value per X value
+	 */
+	void sample_sorted(std::span<const float> xs, std::span<float> out) const;
+
+private:
+	void fit();
+	void fit_natural();
+	void fit_hermite(std::span<const float> slopes);
+	void compute_slopes();
+	float eval(size_t segment, float X) const;
+};
+
+} // namespace avz
@@ -14,8 +14,6 @@ class StereoAnalyzer : public MultiChannelAudioAnalyzer
 public:
 	/**
 	 * Construct stereo analyzer.
-	 * @param sample_rate_hz Audio sample rate in Hz
-	 * @param window_size_samples FFT window size in samples
 	 */
 	StereoAnalyzer()
 		: MultiChannelAudioAnalyzer(2)
@@ -23,16 +21,14 @@ public:
 	}
 
 	/**
-	 * Get left channel analyzer.
+	 * Get left channel amplitudes.
 	 */
-	AudioAnalyzer &left() { return (*this)[0]; }
-	const AudioAnalyzer &left() const { return (*this)[0]; }
+	std::span<const float> left() const { return get_amplitudes(0); }
 
 	/**
-	 * Get right channel analyzer.
+	 * Get right channel amplitudes.
 	 */
-	AudioAnalyzer &right() { return (*this)[1]; }
-	const AudioAnalyzer &right() const { return (*this)[1]; }
+	std::span<const float> right() const { return get_amplitudes(1); }
 };
 
 } // namespace avz
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <avz/analysis/FrequencyAnalyzer.hpp>
+#include <avz/analysis/aligned_allocator.hpp>
+#include <compare>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace avz
+{
+
+/**
+ * Process-wide, thread-safe registry of window function tables.
+ * Tables are immutable and shared between every analyzer using the same window type and size,
+ * so a visualizer building many analyzers computes and stores each table only once.
+ * Tables are aligned to `simd_alignment` for SIMD loads.
+ */
+class WindowCache
+{
+public:
+	using Table = std::shared_ptr<const aligned_vector<float>>;
+
+	struct Key
+	{
+		FrequencyAnalyzer::WindowFunction window_func;
+		int size;
+		// only used by WindowFunction::Kaiser, 0 otherwise
+		float kaiser_beta;
+		auto operator<=>(const Key &) const = default;
+	};
+
+private:
+	std::mutex mu;
+	std::map<Key, std::weak_ptr<const aligned_vector<float>>> tables;
+
+	WindowCache() = default;
+
+public:
+	WindowCache(const WindowCache &) = delete;
+	WindowCache &operator=(const WindowCache &) = delete;
+
+	/**
+	 * Get the process-wide window cache.
+	 */
+	static WindowCache &instance();
+
+	/**
+	 * Get a shared table of `size` window values, creating it if no live table matches.
+	 * Windows are in their symmetric form, i.e. the first and last values are equal.
+	 * @param window_func window function, must not be `WindowFunction::None`
+	 * @param size number of values
+	 * @param kaiser_beta shape parameter of `WindowFunction::Kaiser`, ignored by other windows
+	 * @throws `std::invalid_argument` if `window_func` is `None` or `size` is not positive
+	 */
+	Table get(FrequencyAnalyzer::WindowFunction window_func, int size, float kaiser_beta = 0);
+
+	/**
+	 * Compute a window table without caching it.
+	 * @throws `std::invalid_argument` if `window_func` is `None` or `size` is not positive
+	 */
+	static void compute(std::span<float> out, FrequencyAnalyzer::WindowFunction window_func, float kaiser_beta = 0);
+};
+
+} // namespace avz
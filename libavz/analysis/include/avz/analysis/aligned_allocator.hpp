@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace avz
+{
+
+// alignment of every FFT buffer and window table: a cache line, enough for any SIMD load
+inline constexpr size_t simd_alignment = 64;
+
+/**
+ * Allocator aligning memory to `simd_alignment`, for buffers handed to FFT backends and SIMD kernels.
+ */
+template <typename T>
+struct aligned_allocator
+{
+	using value_type = T;
+
+	aligned_allocator() = default;
+	template <typename U>
+	aligned_allocator(const aligned_allocator<U> &)
+	{
+	}
+
+	inline T *allocate(const size_t n) { return (T *)::operator new(n * sizeof(T), std::align_val_t{simd_alignment}); }
+	inline void deallocate(T *const p, size_t) { ::operator delete(p, std::align_val_t{simd_alignment}); }
+
+	template <typename U>
+	inline bool operator==(const aligned_allocator<U> &) const
+	{
+		return true;
+	}
+};
+
+template <typename T>
+using aligned_vector = std::vector<T, aligned_allocator<T>>;
+
+} // namespace avz
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <avz/analysis/aligned_allocator.hpp>
+#include <complex>
+#include <memory>
+#include <span>
+#include <string_view>
+
+namespace avz::fft
+{
+
+/**
+ * FFT libraries avz-analysis can run its transforms on. Which ones are compiled in is chosen with the
+ * `LIBAVZ_FFT_*` CMake options; the default is picked at startup and can be changed at runtime.
+ */
+enum class Backend
+{
+	// FFTW: fastest at most sizes, especially with wisdom (see `FftwPlanCache`)
+	Fftw,
+	// PocketFFT: header-only, no external dependency, any size
+	PocketFft,
+	// PFFFT: small SIMD FFT; only sizes of the form 2^a * 3^b * 5^c that are multiples of 32 (16 for complex)
+	Pffft,
+};
+
+enum class Kind
+{
+	// real-to-complex forward transform, `n / 2 + 1` bins
+	R2C,
+	// complex-to-complex forward transform
+	C2C,
+	// `howmany` real-to-complex forward transforms of interleaved input into consecutive output rows
+	R2C_INTERLEAVED,
+};
+
+/**
+ * A transform of a fixed kind and size, immutable and shared between every wrapper asking for the same one.
+ * Every pointer passed to `execute` must be aligned to `simd_alignment`.
+ */
+class Plan
+{
+public:
+	virtual ~Plan() = default;
+
+	/**
+	 * Unnormalized forward transform.
+	 * @param in `n * howmany` real samples, or `n` complex samples for `Kind::C2C`; preserved
+	 * @param out interleaved (re, im) output
+	 * @param work scratch of `get_work_size()` floats
+	 */
+	virtual void execute(const float *in, float *out, float *work) const = 0;
+
+	virtual Backend get_backend() const = 0;
+	virtual size_t get_work_size() const { return 0; }
+};
+
+/**
+ * Backend picked at startup: `LIBAVZ_FFT_DEFAULT` if set at build time, else FFTW, PocketFFT, then PFFFT,
+ * whichever is compiled in first.
+ */
+Backend detect_backend();
+
+/**
+ * Get the backend transforms use unless they ask for another one.
+ */
+Backend get_default_backend();
+
+/**
+ * Set the backend used by transforms created after this call.
+ * @throws `std::invalid_argument` if `backend` isn't compiled in
+ */
+void set_default_backend(Backend backend);
+
+/**
+ * Whether `backend` is compiled in.
+ */
+bool is_available(Backend backend);
+
+/**
+ * Whether `backend` is compiled in and can perform a transform of `kind` and size `n`.
+ */
+bool supports(Backend backend, Kind kind, int n);
+
+const char *backend_name(Backend backend);
+
+/**
+ * Parse a name returned by `backend_name`.
+ * @throws `std::invalid_argument` if `name` isn't a backend
+ */
+Backend backend_from_name(std::string_view name);
+
+/**
+ * Get a shared plan, creating it if no live plan matches. If `backend` can't perform the transform,
+ * the first compiled-in backend that can is used instead, in the order of `detect_backend`.
+ * @param n transform size
+ * @param howmany number of interleaved transforms, only for `Kind::R2C_INTERLEAVED`
+ * @throws `std::invalid_argument` if `n` or `howmany` is not positive
+ * @throws `std::runtime_error` if no compiled-in backend can perform the transform
+ */
+std::shared_ptr<const Plan> get_plan(Kind kind, int n, int howmany = 1, Backend backend = get_default_backend());
+
+/**
+ * Real-to-complex forward transform with its own aligned buffers.
+ */
+class dft_r2c_1d
+{
+	aligned_vector<float> in, work;
+	aligned_vector<std::complex<float>> out;
+	std::shared_ptr<const Plan> plan;
+
+public:
+	/**
+	 * Resize the input/output buffers and acquire a plan for size `n`.
+	 * @param n transform size
+	 * @param backend preferred backend, see `get_plan`
+	 */
+	inline void set_n(const int n, const Backend backend = get_default_backend())
+	{
+		in.resize(n);
+		out.resize(n / 2 + 1);
+		plan = get_plan(Kind::R2C, n, 1, backend);
+		work.resize(plan->get_work_size());
+	}
+
+	// like FFTW's new-array execute functions, this writes through the const buffers
+	inline void execute() const { plan->execute(in.data(), (float *)out.data(), (float *)work.data()); }
+
+	inline constexpr int size() const { return in.size(); }
+	inline Backend get_backend() const { return plan->get_backend(); }
+	inline constexpr std::span<float> input() { return in; }
+	inline constexpr std::span<const std::complex<float>> output() const { return out; }
+};
+
+/**
+ * Forward complex-to-complex counterpart of `dft_r2c_1d`.
+ */
+class dft_1d
+{
+	aligned_vector<std::complex<float>> in, out;
+	aligned_vector<float> work;
+	std::shared_ptr<const Plan> plan;
+
+public:
+	inline void set_n(const int n, const Backend backend = get_default_backend())
+	{
+		in.resize(n);
+		out.resize(n);
+		plan = get_plan(Kind::C2C, n, 1, backend);
+		work.resize(plan->get_work_size());
+	}
+
+	inline void execute() const
+	{
+		plan->execute((const float *)in.data(), (float *)out.data(), (float *)work.data());
+	}
+
+	inline constexpr int size() const { return in.size(); }
+	inline Backend get_backend() const { return plan->get_backend(); }
+	inline constexpr std::span<std::complex<float>> input() { return in; }
+	inline constexpr std::span<const std::complex<float>> output() const { return out; }
+};
+
+/**
+ * Batched `dft_r2c_1d`: transforms every channel of an interleaved buffer at once.
+ * The output holds one row of `n / 2 + 1` bins per channel.
+ */
+class dft_r2c_1d_interleaved
+{
+	int n{}, channels{};
+	aligned_vector<float> in, work;
+	aligned_vector<std::complex<float>> out;
+	std::shared_ptr<const Plan> plan;
+
+public:
+	inline void set_n(const int n, const int channels, const Backend backend = get_default_backend())
+	{
+		this->n = n;
+		this->channels = channels;
+		in.resize(n * channels);
+		out.resize((n / 2 + 1) * channels);
+		plan = get_plan(Kind::R2C_INTERLEAVED, n, channels, backend);
+		work.resize(plan->get_work_size());
+	}
+
+	inline void execute() const { plan->execute(in.data(), (float *)out.data(), (float *)work.data()); }
+
+	inline constexpr int size() const { return n; }
+	inline constexpr int num_channels() const { return channels; }
+	inline constexpr int bins() const { return n / 2 + 1; }
+	inline Backend get_backend() const { return plan->get_backend(); }
+
+	/**
+	 * Interleaved input, `size() * num_channels()` samples.
+	 */
+	inline constexpr std::span<float> input() { return in; }
+
+	/**
+	 * Bins of every channel, channel 0 first.
+	 */
+	inline constexpr std::span<const std::complex<float>> output() const { return out; }
+	inline constexpr std::span<const std::complex<float>> output(const int channel) const
+	{
+		return output().subspan(channel * bins(), bins());
+	}
+};
+
+} // namespace avz::fft
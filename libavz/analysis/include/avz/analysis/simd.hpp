@@ -0,0 +1,73 @@
+#pragma once
+
+#include <complex>
+#include <span>
+
+/**
+ * Vectorized kernels for turning FFT output into amplitudes, selected at runtime for the CPU they run on.
+ * The library can be built once (without `-march=native`) and still use AVX2/AVX-512 where available.
+ */
+namespace avz::simd
+{
+
+enum class Isa
+{
+	Scalar,
+	Neon,
+	Avx2,
+	Avx512,
+};
+
+/**
+ * Get the instruction set the kernels currently dispatch to.
+ * Defaults to the best one supported by both the build and the CPU.
+ */
+Isa get_isa();
+
+/**
+ * Get the best instruction set supported by both the build and the CPU.
+ */
+Isa detect_isa();
+
+/**
+ * Force the kernels to use a specific instruction set, e.g. to compare implementations.
+ * @throws `std::invalid_argument` if `isa` is not supported by the build or the CPU
+ */
+void set_isa(Isa isa);
+
+const char *isa_name(Isa isa);
+
+/**
+ * `out[i] = |in[i]| * scale`
+ */
+void magnitude(std::span<float> out, std::span<const std::complex<float>> in, float scale = 1);
+
+/**
+ * `out[i] = |in[i]|^2 * scale`, skipping the square root.
+ */
+void power(std::span<float> out, std::span<const std::complex<float>> in, float scale = 1);
+
+/**
+ * Fused `magnitude` and maximum: a single pass that also returns the largest output value.
+ */
+float magnitude_max(std::span<float> out, std::span<const std::complex<float>> in, float scale = 1);
+
+/**
+ * `out[i] = 20 * log10(max(in[i], 10^(min_db / 20)))`, using a fast log approximation (error below 1.5e-4 dB).
+ * `out` may alias `in`.
+ */
+void amplitude_to_db(std::span<float> out, std::span<const float> in, float min_db = -120);
+
+/**
+ * `out[i] = 10 * log10(max(in[i], 10^(min_db / 10)))`, for the output of `power`. Same accuracy as `amplitude_to_db`.
+ * `out` may alias `in`.
+ */
+void power_to_db(std::span<float> out, std::span<const float> in, float min_db = -120);
+
+/**
+ * Half-wave rectified spectral flux: the sum of `max(curr[i] - prev[i], 0)`.
+ * Only rising bins count, so onsets stand out while decays are ignored.
+ */
+float spectral_flux(std::span<const float> curr, std::span<const float> prev);
+
+} // namespace avz::simd
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <avz/analysis/Interpolator.hpp>
+#include <avz/analysis/SpectrumResamplePlan.hpp>
+#include <complex>
 #include <span>
 
 namespace avz::util
@@ -18,13 +20,55 @@ inline constexpr int freq_from_bin_index(const int bin_index, const int sample_r
 
 void extract_channel(std::span<float> out, std::span<const float> in, int num_channels, int channel);
 
+/**
+ * Compute the amplitude of every bin of a spectrum, normalized by the number of transformed samples.
+ * @param out amplitudes, same size as `spectrum`
+ * @param spectrum the non-negative frequency bins of a transform
+ * @param fft_size number of real samples that were transformed, excluding zero-padding
+ */
+void compute_amplitudes(std::span<float> out, std::span<const std::complex<float>> spectrum, int fft_size);
+
+/**
+ * Find the loudest bin between `from_hz` and `to_hz`, clamped to the bins in `amplitudes`.
+ * @param amplitudes amplitudes starting at bin 0
+ * @param sample_rate_hz effective sample rate of the analyzed samples
+ * @param transform_size transform size that produced `amplitudes`
+ * @returns index of the loudest bin
+ */
+int find_peak_bin(std::span<const float> amplitudes, float sample_rate_hz, int transform_size, int from_hz, int to_hz);
+
+/**
+ * Resample the amplitudes between `start_freq` and `end_freq` onto every element of `spectrum`.
+ * @param spectrum output spectrum
+ * @param in_amps amplitudes from `AudioAnalyzer`
+ * @param sample_rate_hz sample rate of the analyzed samples, e.g. `Decimator::output_sample_rate()` after decimation
+ * @param fft_size transform size that produced `in_amps`, i.e. `FrequencyAnalyzer::get_transform_size()`
+ * @param start_freq frequency (Hz) of the first output element
+ * @param end_freq frequency (Hz) of the last output element
+ * @param interpolator interpolator used to sample between bins
+ */
 void resample_spectrum(
 	std::span<float> spectrum,
 	std::span<const float> in_amps,
-	int sample_rate_hz,
+	float sample_rate_hz,
 	int fft_size,
 	float start_freq,
 	float end_freq,
 	avz::Interpolator &interpolator);
 
+/**
+ * Resample the amplitudes between `start_freq` and `end_freq` onto every element of `spectrum`, using a
+ * precomputed plan. The plan is only recompiled when the output grid changes, so keep one plan per output grid.
+ * Parameters match the `Interpolator` overload.
+ * @param plan plan for this output grid, updated with `SpectrumResamplePlan::set_grid`
+ */
+void resample_spectrum(
+	std::span<float> spectrum,
+	std::span<const float> in_amps,
+	float sample_rate_hz,
+	int fft_size,
+	float start_freq,
+	float end_freq,
+	avz::SpectrumResamplePlan &plan);
+
 } // namespace avz::util
@@ -0,0 +1,273 @@
+#include <avz/analysis/AnalysisGraph.hpp>
+#include <avz/analysis/util.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+namespace avz
+{
+
+AnalysisGraph::AnalysisGraph(const float sample_rate_hz, const int num_channels)
+	: sample_rate_hz{sample_rate_hz},
+	  num_channels{num_channels}
+{
+	if (sample_rate_hz <= 0 || num_channels <= 0)
+		throw std::invalid_argument{"[AnalysisGraph] sample_rate_hz and num_channels must be > 0"};
+}
+
+int AnalysisGraph::add_node(const Kind kind, const int input, const std::array<float, 4> params, Node node)
+{
+	const Key key{kind, input, params};
+	if (const auto it = node_ids.find(key); it != node_ids.end())
+	{
+		// identical node: only its window can grow
+		auto &existing = nodes[it->second];
+		existing.min_window = std::max(existing.min_window, node.min_window);
+		compiled = false;
+		return it->second;
+	}
+
+	node.kind = kind;
+	node.input = input;
+	if (input >= 0)
+		node.level = nodes[input].level + 1;
+	nodes.emplace_back(std::move(node));
+	compiled = false;
+	return node_ids[key] = nodes.size() - 1;
+}
+
+void AnalysisGraph::check_input(const int input, const char *const method) const
+{
+	if (input < 0 || input >= (int)nodes.size())
+		throw std::invalid_argument{std::string{"[AnalysisGraph::"} + method + "] input is not a node of this graph"};
+}
+
+AnalysisGraph::Handle<AnalysisGraph::Samples> AnalysisGraph::channel(const int channel, const int frames)
+{
+	if (channel < 0 || channel >= num_channels)
+		throw std::invalid_argument{"[AnalysisGraph::channel] channel out of range"};
+	if (frames < 0)
+		throw std::invalid_argument{"[AnalysisGraph::channel] frames must be >= 0"};
+
+	return {add_node(
+		Kind::Channel,
+		-1,
+		{(float)channel},
+		{.param = channel, .min_window = frames, .sample_rate_hz = sample_rate_hz})};
+}
+
+AnalysisGraph::Handle<AnalysisGraph::Samples>
+AnalysisGraph::decimate(const Handle<Samples> input, const int factor, const int window_size)
+{
+	check_input(input.node, "decimate");
+	if (nodes[input.node].kind != Kind::Channel)
+		throw std::invalid_argument{"[AnalysisGraph::decimate] input must be a channel"};
+	if (factor <= 0 || window_size < 0)
+		throw std::invalid_argument{"[AnalysisGraph::decimate] factor must be > 0 and window_size >= 0"};
+
+	return {add_node(
+		Kind::Decimate,
+		input.node,
+		{(float)factor},
+		{.param = factor, .min_window = window_size, .sample_rate_hz = nodes[input.node].sample_rate_hz / factor})};
+}
+
+AnalysisGraph::Handle<AnalysisGraph::Spectrum> AnalysisGraph::fft(
+	const Handle<Samples> input,
+	const int fft_size,
+	const FrequencyAnalyzer::WindowFunction window_func,
+	const FrequencyAnalyzer::SizePolicy size_policy)
+{
+	check_input(input.node, "fft");
+	if (fft_size <= 0)
+		throw std::invalid_argument{"[AnalysisGraph::fft] fft_size must be > 0"};
+
+	const auto id = add_node(
+		Kind::Fft,
+		input.node,
+		{(float)fft_size, (float)window_func, (float)size_policy},
+		{.param = fft_size, .min_window = 0, .sample_rate_hz = nodes[input.node].sample_rate_hz});
+
+	auto &node = nodes[id];
+	if (!node.fa)
+	{
+		node.fa = std::make_unique<FrequencyAnalyzer>(fft_size, size_policy);
+		node.fa->set_window_func(window_func);
+	}
+	return {id};
+}
+
+AnalysisGraph::Handle<AnalysisGraph::Amplitudes> AnalysisGraph::amplitudes(const Handle<Spectrum> input)
+{
+	check_input(input.node, "amplitudes");
+	return {add_node(
+		Kind::Amplitudes,
+		input.node,
+		{},
+		{.param = 0, .min_window = 0, .sample_rate_hz = nodes[input.node].sample_rate_hz})};
+}
+
+AnalysisGraph::Handle<AnalysisGraph::Resampled> AnalysisGraph::resample(
+	const Handle<Amplitudes> input,
+	const int out_size,
+	const float start_freq,
+	const float end_freq,
+	const Interpolator::InterpolationType type)
+{
+	check_input(input.node, "resample");
+	if (out_size <= 0)
+		throw std::invalid_argument{"[AnalysisGraph::resample] out_size must be > 0"};
+
+	const auto id = add_node(
+		Kind::Resample,
+		input.node,
+		{(float)out_size, start_freq, end_freq, (float)type},
+		{.param = out_size, .min_window = 0, .sample_rate_hz = nodes[input.node].sample_rate_hz});
+
+	auto &node = nodes[id];
+	if (!node.plan)
+	{
+		node.plan = std::make_unique<SpectrumResamplePlan>(type);
+		node.grid = {out_size, node.sample_rate_hz, get_transform_size(input), start_freq, end_freq};
+	}
+	return {id};
+}
+
+void AnalysisGraph::compile()
+{
+	// consumers are always declared after their inputs, so walking backwards sees every consumer
+	// of a node before the node itself
+	for (auto &node : nodes)
+		node.window = node.min_window;
+	for (auto it = nodes.rbegin(); it != nodes.rend(); ++it)
+	{
+		if (it->input < 0)
+			continue;
+		auto &input = nodes[it->input];
+		switch (it->kind)
+		{
+		case Kind::Decimate:
+			it->window = std::max(it->window, 1);
+			input.window = std::max(input.window, it->window * it->param);
+			break;
+		case Kind::Fft:
+			input.window = std::max(input.window, it->param);
+			break;
+		default:
+			break;
+		}
+	}
+
+	input_frames = 0;
+	int levels{};
+	for (auto &node : nodes)
+	{
+		levels = std::max(levels, node.level + 1);
+		switch (node.kind)
+		{
+		case Kind::Channel:
+			input_frames = std::max(input_frames, node.window);
+			node.values.assign(node.window, 0);
+			break;
+		case Kind::Decimate:
+			if (!node.dec || node.dec->get_window_size() != node.window)
+				node.dec = std::make_unique<Decimator>(node.param, node.window);
+			break;
+		case Kind::Fft:
+			break;
+		case Kind::Amplitudes:
+			node.values.assign(nodes[node.input].fa->get_output().size(), 0);
+			break;
+		case Kind::Resample:
+			node.plan->set_grid(node.grid);
+			node.values.assign(node.param, 0);
+			break;
+		}
+	}
+
+	// counting sort of the nodes by level
+	level_start.assign(levels + 1, 0);
+	for (const auto &node : nodes)
+		++level_start[node.level + 1];
+	std::partial_sum(level_start.begin(), level_start.end(), level_start.begin());
+	order.resize(nodes.size());
+	auto fill = level_start;
+	for (int i = 0; i < (int)nodes.size(); ++i)
+		order[fill[nodes[i].level]++] = i;
+
+	compiled = true;
+}
+
+void AnalysisGraph::run(const std::span<const float> audio, const int hop)
+{
+	if (!compiled)
+		compile();
+	if (audio.size() < (size_t)input_frames * num_channels)
+		throw std::invalid_argument{"[AnalysisGraph::run] audio has fewer than get_input_frames() frames"};
+
+	this->audio = audio;
+	this->hop = hop;
+
+	for (size_t l = 0; l + 1 < level_start.size(); ++l)
+	{
+		const auto first = level_start[l], count = level_start[l + 1] - first;
+		if (jobs && count > 1)
+			jobs->parallel_for(count, [&](const int i) { execute(nodes[order[first + i]]); });
+		else
+			for (int i = first; i < first + count; ++i)
+				execute(nodes[order[i]]);
+	}
+}
+
+std::span<const float> AnalysisGraph::samples(const int node) const
+{
+	const auto &n = nodes[node];
+	if (n.kind == Kind::Decimate)
+		return n.dec ? n.dec->window() : std::span<const float>{};
+	return n.values;
+}
+
+std::span<const float> AnalysisGraph::get(const Handle<Samples> handle) const
+{
+	return samples(handle.node);
+}
+
+std::span<const std::complex<float>> AnalysisGraph::get(const Handle<Spectrum> handle) const
+{
+	return nodes[handle.node].fa->get_output();
+}
+
+int AnalysisGraph::get_transform_size(const Handle<Spectrum> handle) const
+{
+	return nodes[handle.node].fa->get_transform_size();
+}
+
+void AnalysisGraph::execute(Node &node)
+{
+	switch (node.kind)
+	{
+	case Kind::Channel:
+		util::extract_channel(node.values, audio, num_channels, node.param);
+		break;
+	case Kind::Decimate:
+		node.dec->update(nodes[node.input].values, hop);
+		break;
+	case Kind::Fft:
+		node.fa->copy_to_input(samples(node.input).first(node.param));
+		node.fa->execute_fft();
+		break;
+	case Kind::Amplitudes:
+	{
+		const auto &fa = *nodes[node.input].fa;
+		util::compute_amplitudes(node.values, fa.get_output(), fa.get_fft_size());
+		break;
+	}
+	case Kind::Resample:
+		node.plan->execute(node.values, nodes[node.input].values);
+		break;
+	}
+}
+
+} // namespace avz
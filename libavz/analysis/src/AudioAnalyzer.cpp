@@ -14,24 +14,25 @@ void AudioAnalyzer::execute_fft(FrequencyAnalyzer &fa, std::span<const float> au
 	_amplitudes.clear();
 }
 
-void AudioAnalyzer::compute_amplitudes(const FrequencyAnalyzer &fa)
+void AudioAnalyzer::execute_fft(
+	FrequencyAnalyzer &fa, std::span<const float> interleaved, const int num_channels, const int channel)
 {
-	const auto fft_size = fa.get_fft_size();
-	const auto inv_fft_size = 1.f / fft_size;
-	const auto fft_output_size = fft_size / 2 + 1;
-	_amplitudes.resize(fft_output_size);
+	fa.copy_to_input(interleaved, num_channels, channel);
+	fa.execute_fft();
+	// reset state computed from previous fft output
+	_amplitudes.clear();
+}
 
-	auto *__restrict const out_ptr = _amplitudes.data();
-	const auto *__restrict const in_ptr = fa.get_output().data();
+void AudioAnalyzer::compute_amplitudes(const FrequencyAnalyzer &fa)
+{
+	// zero-padding doesn't add energy, so normalize by the real sample count, not the transform size
+	compute_amplitudes(fa.get_output(), fa.get_fft_size());
+}
 
-#pragma GCC ivdep
-	for (size_t i = 0; i < fft_output_size; ++i)
-	{
-		const auto re = in_ptr[i].real(), im = in_ptr[i].imag();
-		// must divide by fft_size here to counteract the correlation
-		// between fft_size and the average amplitude across the spectrum vector.
-		out_ptr[i] = sqrtf((re * re) + (im * im)) * inv_fft_size;
-	}
+void AudioAnalyzer::compute_amplitudes(std::span<const std::complex<float>> spectrum, const int fft_size)
+{
+	_amplitudes.resize(spectrum.size());
+	util::compute_amplitudes(_amplitudes, spectrum, fft_size);
 }
 
 std::span<const float> AudioAnalyzer::get_amplitudes()
@@ -43,22 +44,29 @@ std::span<const float> AudioAnalyzer::get_amplitudes()
 }
 
 AudioAnalyzer::FrequencyAmplitudePair
-AudioAnalyzer::compute_peak_frequency(const FrequencyAnalyzer &fa, int sample_rate_hz, int from_hz, int to_hz)
+AudioAnalyzer::compute_peak_frequency(const FrequencyAnalyzer &fa, float sample_rate_hz, int from_hz, int to_hz)
 {
 	if (_amplitudes.empty())
 		throw std::logic_error{"[AudioAnalyzer::compute_peak_frequency] computed amplitudes required"};
 
-	assert(from_hz < to_hz);
-	const auto fft_size = fa.get_fft_size();
-
-	const auto start_bin = util::bin_index_from_freq(from_hz, sample_rate_hz, fft_size);
-	const auto end_bin = util::bin_index_from_freq(to_hz, sample_rate_hz, fft_size);
+	const auto transform_size = fa.get_transform_size();
+	const auto idx = util::find_peak_bin(_amplitudes, sample_rate_hz, transform_size, from_hz, to_hz);
+	return {(int)(idx * sample_rate_hz / transform_size), _amplitudes[idx]};
+}
 
-	const auto amps_begin = _amplitudes.begin();
-	const auto max_it = std::ranges::max_element(amps_begin + start_bin, amps_begin + end_bin + 1);
-	const auto idx = std::distance(amps_begin, max_it);
+PeakEstimator::Estimate AudioAnalyzer::estimate_peak_frequency(
+	const FrequencyAnalyzer &fa,
+	const float sample_rate_hz,
+	const int from_hz,
+	const int to_hz,
+	PeakEstimator &estimator,
+	const int hop)
+{
+	if (_amplitudes.empty())
+		throw std::logic_error{"[AudioAnalyzer::estimate_peak_frequency] computed amplitudes required"};
 
-	return {util::freq_from_bin_index(idx, sample_rate_hz, fft_size), *max_it};
+	return estimator.estimate(
+		fa.get_output(), _amplitudes, sample_rate_hz, fa.get_transform_size(), hop, from_hz, to_hz);
 }
 
 } // namespace avz
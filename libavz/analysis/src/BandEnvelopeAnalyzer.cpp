@@ -0,0 +1,173 @@
+#include <avz/analysis/BandEnvelopeAnalyzer.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+
+namespace avz
+{
+
+BandEnvelopeAnalyzer::BandEnvelopeAnalyzer(
+	const float sample_rate_hz, std::span<const Band> bands, const int sections)
+	: sample_rate_hz{sample_rate_hz},
+	  num_bands{(int)bands.size()},
+	  sections{sections}
+{
+	if (bands.empty())
+		throw std::invalid_argument{"[BandEnvelopeAnalyzer] at least one band is required"};
+	if (sample_rate_hz <= 0 || sections <= 0)
+		throw std::invalid_argument{"[BandEnvelopeAnalyzer] sample_rate_hz and sections must be > 0"};
+
+	for (auto *const v : {&b0, &b1, &b2, &a1, &a2})
+		v->resize(sections * num_bands);
+
+	// butterworth designs: analog sections prewarped to the band edges, mapped through the bilinear transform
+	const double c = 2 * sample_rate_hz;
+	const auto prewarp = [&](const double hz) { return c * tan(M_PI * hz / sample_rate_hz); };
+
+	for (int j = 0; j < num_bands; ++j)
+	{
+		const auto [from_hz, to_hz] = bands[j];
+		if (from_hz < 0 || from_hz >= to_hz || to_hz >= sample_rate_hz / 2)
+			throw std::invalid_argument{"[BandEnvelopeAnalyzer] bands must satisfy 0 <= from_hz < to_hz < nyquist"};
+
+		// sets section `s` to the digital counterpart of `num(s) / (s^2 + a s + b)`, where the numerator is
+		// `k s` for a bandpass section and `k` for a lowpass section
+		const auto set_section = [&](const int s, const bool lowpass, const double k, const double a, const double b)
+		{
+			const auto i = s * num_bands + j;
+			const auto d = c * c + a * c + b;
+			if (lowpass)
+				b0[i] = k / d, b1[i] = 2 * k / d, b2[i] = k / d;
+			else
+				b0[i] = k * c / d, b1[i] = 0, b2[i] = -k * c / d;
+			a1[i] = 2 * (b - c * c) / d;
+			a2[i] = (c * c - a * c + b) / d;
+		};
+
+		if (!from_hz)
+		{
+			// order 2 * sections: conjugate pole pairs at angles (2s + 1) * pi / (4 * sections) from the real axis
+			const auto wc = prewarp(to_hz);
+			for (int s = 0; s < sections; ++s)
+				set_section(s, true, wc * wc, 2 * wc * cos((2 * s + 1) * M_PI / (4 * sections)), wc * wc);
+			continue;
+		}
+
+		// lowpass prototype of order `sections` transformed with p -> (s^2 + w0^2) / (bw s):
+		// every prototype pole p becomes the roots of s^2 - p bw s + w0^2, and the gain is 1 at w0
+		const auto w_from = prewarp(from_hz), w_to = prewarp(to_hz);
+		const auto w0_sq = w_from * w_to, bw = w_to - w_from;
+		int s = 0;
+		for (int k = 0; k < (sections + 1) / 2; ++k)
+		{
+			const auto p = std::polar(1.0, M_PI * (2 * k + sections + 1) / (2 * sections));
+			const auto root = std::sqrt(p * p * bw * bw - 4 * w0_sq);
+			const auto r1 = (p * bw + root) / 2.0, r2 = (p * bw - root) / 2.0;
+			if (2 * k + 1 == sections)
+			{
+				// the real prototype pole: its two roots are a conjugate or real pair
+				set_section(s++, false, bw, -(r1 + r2).real(), (r1 * r2).real());
+				continue;
+			}
+			// each root pairs with its conjugate, which comes from the conjugate prototype pole
+			for (const auto r : {r1, r2})
+				set_section(s++, false, bw, -2 * r.real(), std::norm(r));
+		}
+	}
+
+	stage.resize(num_bands);
+	set_attack_release(0.005f, 0.15f);
+	reset();
+}
+
+void BandEnvelopeAnalyzer::set_attack_release(const float attack_sec, const float release_sec)
+{
+	if (attack_sec < 0 || release_sec < 0)
+		throw std::invalid_argument{"[BandEnvelopeAnalyzer::set_attack_release] times must be >= 0"};
+
+	// one-pole smoothing: a time constant of t seconds is 1 - e^(-1 / (t * sample_rate)) per sample
+	const auto coeff = [&](const float t) { return t ? 1 - expf(-1 / (t * sample_rate_hz)) : 1.f; };
+	attack_coeff = coeff(attack_sec);
+	release_coeff = coeff(release_sec);
+}
+
+void BandEnvelopeAnalyzer::reset()
+{
+	z1.assign(sections * num_bands, 0);
+	z2.assign(sections * num_bands, 0);
+	_envelopes.assign(num_bands, 0);
+	primed = false;
+}
+
+void BandEnvelopeAnalyzer::push(std::span<const float> samples, const int num_channels, const int channel)
+{
+	const auto frames = samples.size() / num_channels;
+	const auto nb = num_bands;
+
+	const auto *__restrict const cb0 = b0.data();
+	const auto *__restrict const cb1 = b1.data();
+	const auto *__restrict const cb2 = b2.data();
+	const auto *__restrict const ca1 = a1.data();
+	const auto *__restrict const ca2 = a2.data();
+	auto *__restrict const s1 = z1.data();
+	auto *__restrict const s2 = z2.data();
+	auto *__restrict const v = stage.data();
+	auto *__restrict const env = _envelopes.data();
+	const auto attack = attack_coeff, release = release_coeff;
+
+	for (size_t f = 0; f < frames; ++f)
+	{
+		const auto x = samples[f * num_channels + channel];
+
+#pragma GCC ivdep
+		for (int j = 0; j < nb; ++j)
+			v[j] = x;
+
+		// every band runs the same section at once
+		for (int s = 0; s < sections; ++s)
+		{
+			const auto o = s * nb;
+#pragma GCC ivdep
+			for (int j = 0; j < nb; ++j)
+			{
+				const auto in = v[j];
+				const auto y = cb0[o + j] * in + s1[o + j];
+				s1[o + j] = cb1[o + j] * in - ca1[o + j] * y + s2[o + j];
+				s2[o + j] = cb2[o + j] * in - ca2[o + j] * y;
+				v[j] = y;
+			}
+		}
+
+		// peak follower: fast attack, slow release
+#pragma GCC ivdep
+		for (int j = 0; j < nb; ++j)
+		{
+			const auto level = std::abs(v[j]);
+			const auto k = level > env[j] ? attack : release;
+			env[j] += k * (level - env[j]);
+		}
+	}
+}
+
+void BandEnvelopeAnalyzer::update(
+	std::span<const float> audio, const int hop, const int num_channels, const int channel)
+{
+	assert(hop >= 0);
+
+	if (!primed)
+	{
+		push(audio, num_channels, channel);
+		primed = true;
+		return;
+	}
+
+	// the filters carry on from their state even if the buffer is shorter than the hop
+	const int frames = audio.size() / num_channels;
+	const auto new_frames = std::min(hop, frames);
+	push(audio.subspan((frames - new_frames) * num_channels, new_frames * num_channels), num_channels, channel);
+}
+
+} // namespace avz
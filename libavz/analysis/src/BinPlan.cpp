@@ -0,0 +1,226 @@
+#include <avz/analysis/BinPlan.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+namespace avz
+{
+
+namespace
+{
+
+float hz_to_mel(const float hz)
+{
+	return 2595 * log10f(1 + hz / 700);
+}
+
+// traunmüller's approximation
+float hz_to_bark(const float hz)
+{
+	return 26.81f * hz / (1960 + hz) - 0.53f;
+}
+
+} // namespace
+
+BinPlan::Key BinPlan::normalize(Key key)
+{
+	if (key.scale != BinPacker::Scale::NTH_ROOT)
+		key.nth_root = 0;
+	if (key.scale != BinPacker::Scale::MEL && key.scale != BinPacker::Scale::BARK)
+		key.sample_rate_hz = 0;
+	return key;
+}
+
+BinPlan::BinPlan(const Key &key)
+	: key{normalize(key)}
+{
+	using enum BinPacker::Scale;
+	using enum BinPacker::AccumulationMethod;
+
+	if (key.in_size <= 0 || key.out_size <= 0)
+		throw std::invalid_argument{"[BinPlan] in_size and out_size must be > 0"};
+
+	switch (key.scale)
+	{
+	case LINEAR:
+	case LOG:
+	case NTH_ROOT:
+		if (key.scale == NTH_ROOT && !key.nth_root)
+			throw std::invalid_argument{"[BinPlan] nth_root cannot be zero!"};
+		compile_index_scale();
+		break;
+	case MEL:
+	case BARK:
+		if (key.sample_rate_hz <= 0)
+			throw std::invalid_argument{"[BinPlan] sample_rate_hz must be > 0 for MEL and BARK scales"};
+		if (key.in_size < 2)
+			throw std::invalid_argument{"[BinPlan] in_size must be >= 2 for MEL and BARK scales"};
+		compile_filterbank();
+		break;
+	default:
+		throw std::logic_error{"[BinPlan] default case hit"};
+	}
+
+	if (key.method == SUM)
+		kernel = is_weighted() ? &BinPlan::execute_rows<SUM, true> : &BinPlan::execute_rows<SUM, false>;
+	else
+		kernel = is_weighted() ? &BinPlan::execute_rows<MAX, true> : &BinPlan::execute_rows<MAX, false>;
+}
+
+std::shared_ptr<const BinPlan> BinPlan::get(Key key)
+{
+	static std::mutex mu;
+	static std::map<Key, std::weak_ptr<const BinPlan>> plans;
+
+	key = normalize(key);
+	std::lock_guard lk{mu};
+
+	if (const auto it = plans.find(key); it != plans.end())
+		if (const auto plan = it->second.lock())
+			return plan;
+
+	const auto plan = std::make_shared<const BinPlan>(key);
+	// drop the keys of plans nobody holds anymore, like FftwPlanCache::get
+	std::erase_if(plans, [](const auto &entry) { return entry.second.expired(); });
+	plans[key] = plan;
+	return plan;
+}
+
+void BinPlan::compile_index_scale()
+{
+	const auto [in_size, out_size, scale, nth_root, method, sample_rate_hz] = key;
+
+	// input bin i goes to output bin (f(i) / f(in_size)) * out_size, in double and nudged up so that bins landing
+	// exactly on an output bin's edge (common for LINEAR and NTH_ROOT) go to that bin whatever rounding -ffast-math
+	// picks for the division
+	const auto f = [&](const double i) -> double
+	{
+		switch (scale)
+		{
+		case BinPacker::Scale::LOG:
+			return std::log(i ? i : 1);
+		case BinPacker::Scale::NTH_ROOT:
+			switch (nth_root)
+			{
+			case 1:
+				return i;
+			case 2:
+				return std::sqrt(i);
+			case 3:
+				return std::cbrt(i);
+			default:
+				return std::pow(i, 1. / nth_root);
+			}
+		default:
+			return i;
+		}
+	};
+
+	const auto f_max = f(in_size);
+
+	// output indices are non-decreasing in i, so each row is one contiguous run of input bins
+	std::vector<int> counts(out_size);
+	first_column.assign(out_size, 0);
+	for (int i = 0; i < in_size; ++i)
+	{
+		const auto out_index = std::clamp((int)(f(i) / f_max * out_size + 1e-9), 0, out_size - 1);
+		if (!counts[out_index]++)
+			first_column[out_index] = i;
+	}
+
+	row_offsets.resize(out_size + 1);
+	row_offsets[0] = 0;
+	for (int i = 0; i < out_size; ++i)
+		row_offsets[i + 1] = row_offsets[i] + counts[i];
+}
+
+void BinPlan::compile_filterbank()
+{
+	const auto [in_size, out_size, scale, nth_root, method, sample_rate_hz] = key;
+	const auto to_scale = scale == BinPacker::Scale::MEL ? hz_to_mel : hz_to_bark;
+
+	// input bins are 0..nyquist of a real transform
+	const auto nyquist = sample_rate_hz / 2;
+	std::vector<float> bin_pos(in_size);
+	for (int i = 0; i < in_size; ++i)
+		bin_pos[i] = to_scale(nyquist * i / (in_size - 1));
+
+	// out_size + 2 evenly spaced edges: filter i rises from edge i, peaks at edge i + 1, and falls to edge i + 2
+	const auto lo = to_scale(0), spacing = (to_scale(nyquist) - lo) / (out_size + 1);
+
+	row_offsets.assign(1, 0);
+	first_column.resize(out_size);
+	for (int i = 0; i < out_size; ++i)
+	{
+		const auto left = lo + i * spacing, center = left + spacing, right = center + spacing;
+
+		const auto begin = std::upper_bound(bin_pos.begin(), bin_pos.end(), left);
+		const auto end = std::lower_bound(begin, bin_pos.end(), right);
+
+		if (begin == end)
+		{
+			// filter is narrower than the bin spacing: take the closest bin as-is so low filters don't go dark
+			const auto next = std::lower_bound(bin_pos.begin(), bin_pos.end(), center);
+			auto nearest = next - bin_pos.begin();
+			if (next == bin_pos.end() || (nearest && center - next[-1] < *next - center))
+				--nearest;
+			first_column[i] = nearest;
+			weights.push_back(1);
+		}
+		else
+		{
+			first_column[i] = begin - bin_pos.begin();
+			for (auto it = begin; it != end; ++it)
+				weights.push_back(1 - std::abs(*it - center) / spacing);
+		}
+
+		row_offsets.push_back(weights.size());
+	}
+}
+
+template <BinPacker::AccumulationMethod method, bool weighted>
+void BinPlan::execute_rows(float *__restrict const out, const float *__restrict const in) const
+{
+	const auto out_size = key.out_size;
+	const auto *__restrict const offsets = row_offsets.data();
+	const auto *__restrict const columns = first_column.data();
+	const auto *__restrict const w = weights.data();
+
+	// rows are contiguous, so each inner loop is a plain reduction that -ffast-math lets the compiler vectorize
+	for (int i = 0; i < out_size; ++i)
+	{
+		const auto count = offsets[i + 1] - offsets[i];
+		const auto *__restrict const x = in + columns[i];
+		[[maybe_unused]] const auto *__restrict const wx = w + offsets[i];
+
+		float a{};
+		for (int j = 0; j < count; ++j)
+		{
+			float v;
+			if constexpr (weighted)
+				v = wx[j] * x[j];
+			else
+				v = x[j];
+
+			if constexpr (method == BinPacker::AccumulationMethod::SUM)
+				a += v;
+			else
+				a = std::max(a, v);
+		}
+
+		out[i] = a;
+	}
+}
+
+void BinPlan::execute(std::span<float> out, std::span<const float> in) const
+{
+	assert(out.size() == (size_t)key.out_size);
+	assert(in.size() == (size_t)key.in_size);
+	(this->*kernel)(out.data(), in.data());
+}
+
+} // namespace avz
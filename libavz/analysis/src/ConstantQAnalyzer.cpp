@@ -0,0 +1,195 @@
+#include <avz/analysis/ConstantQAnalyzer.hpp>
+#include <avz/analysis/WindowCache.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+
+namespace avz
+{
+
+ConstantQAnalyzer::ConstantQAnalyzer(
+	const float sample_rate_hz,
+	const float min_freq_hz,
+	const int octaves,
+	const int bins_per_octave,
+	const float sparsity)
+	: sample_rate_hz{sample_rate_hz},
+	  min_freq_hz{min_freq_hz},
+	  octaves{octaves},
+	  bins_per_octave{bins_per_octave}
+{
+	if (sample_rate_hz <= 0 || min_freq_hz <= 0 || octaves <= 0 || bins_per_octave <= 0 || sparsity <= 0)
+		throw std::invalid_argument{"[ConstantQAnalyzer] all arguments must be > 0"};
+
+	// the decimators pass everything below 40% of their output sample rate
+	if (min_freq_hz * exp2f(octaves) > 0.4f * sample_rate_hz)
+		throw std::invalid_argument{"[ConstantQAnalyzer] highest bin must be <= 40% of the sample rate"};
+
+	compute_kernel(sparsity);
+	fft.set_n(fft_size);
+	top.resize(fft_size);
+
+	// each level holds everything it produces while priming, so it can all be passed to the level below
+	for (int k = 1; k < octaves; ++k)
+		levels.emplace_back(2, fft_size << (octaves - 1 - k));
+
+	_amplitudes.reserve(get_bin_count());
+}
+
+float ConstantQAnalyzer::get_bin_frequency(const int i) const
+{
+	return min_freq_hz * exp2f((float)i / bins_per_octave);
+}
+
+float ConstantQAnalyzer::get_q() const
+{
+	return 1 / (exp2f(1.f / bins_per_octave) - 1);
+}
+
+void ConstantQAnalyzer::compute_kernel(const float sparsity)
+{
+	// every octave sees the top octave's bins, scaled down along with its sample rate
+	const double q = get_q();
+	const double top_octave_hz = min_freq_hz * exp2(octaves - 1);
+
+	// the lowest bin of the octave needs the longest window
+	fft_size = std::bit_ceil((unsigned)ceil(q * sample_rate_hz / top_octave_hz));
+	const int n = fft_size, spectrum_size = n / 2 + 1;
+
+	kernel_offsets.assign(1, 0);
+	kernel_first.resize(bins_per_octave);
+	kernel.clear();
+
+	std::vector<std::complex<double>> spectral(spectrum_size);
+	std::vector<float> window;
+
+	for (int j = 0; j < bins_per_octave; ++j)
+	{
+		const auto freq = top_octave_hz * exp2((double)j / bins_per_octave);
+		const int length = std::min(n, (int)ceil(q * sample_rate_hz / freq));
+
+		// temporal kernel, right-aligned in the frame: hann(m) / sum(hann) * e^(-j*2*pi*freq*m / sample_rate)
+		window.resize(length);
+		WindowCache::compute(window, FrequencyAnalyzer::WindowFunction::Hanning);
+		double window_sum{};
+		for (const auto w : window)
+			window_sum += w;
+
+		// sum(x[i] * c[i]) = sum(X[k] * C[k]) / n, where C[k] = sum(c[i] * e^(j*2*pi*k*i / n));
+		// c only has positive-frequency content, so the negative half of the spectrum is dropped
+		const auto start = n - length;
+		double peak{};
+		for (int k = 0; k < spectrum_size; ++k)
+		{
+			std::complex<double> acc;
+			for (int m = 0; m < length; ++m)
+			{
+				const auto phase = 2 * M_PI * (k * (double)(start + m) / n - freq * m / sample_rate_hz);
+				acc += std::polar((double)window[m], phase);
+			}
+			spectral[k] = acc / (window_sum * n);
+			peak = std::max(peak, std::abs(spectral[k]));
+		}
+
+		// keep the contiguous run of bins around the peak
+		const auto significant = [&](const auto &x) { return std::abs(x) >= sparsity * peak; };
+		const auto first = std::ranges::find_if(spectral, significant) - spectral.begin();
+		const auto last =
+			spectrum_size - 1 - (std::find_if(spectral.rbegin(), spectral.rend(), significant) - spectral.rbegin());
+
+		kernel_first[j] = first;
+		for (auto k = first; k <= last; ++k)
+			kernel.emplace_back(spectral[k]);
+		kernel_offsets.push_back(kernel.size());
+	}
+}
+
+void ConstantQAnalyzer::reset()
+{
+	for (auto &level : levels)
+		level.reset();
+	primed = false;
+}
+
+void ConstantQAnalyzer::update(std::span<const float> audio, const int hop, const int num_channels, const int channel)
+{
+	const auto input_window_size = get_input_window_size();
+	assert(audio.size() >= input_window_size * num_channels);
+
+	// the top octave only needs the newest samples
+	for (int i = 0; i < fft_size; ++i)
+		top[i] = audio[(input_window_size - fft_size + i) * num_channels + channel];
+
+	if (levels.empty())
+	{
+		primed = true;
+		return;
+	}
+
+	int produced;
+	if (!primed || hop >= input_window_size)
+	{
+		reset();
+		produced = levels[0].push(audio.first(input_window_size * num_channels), num_channels, channel);
+		primed = true;
+	}
+	else
+		produced = levels[0].push(
+			audio.subspan((input_window_size - hop) * num_channels, hop * num_channels), num_channels, channel);
+
+	// pass each level's new samples down the pyramid
+	for (size_t k = 1; k < levels.size(); ++k)
+	{
+		const auto above = levels[k - 1].window();
+		produced = levels[k].push(above.last(std::min<size_t>(produced, above.size())));
+	}
+}
+
+void ConstantQAnalyzer::compute_amplitudes()
+{
+	if (!primed)
+		throw std::logic_error{"[ConstantQAnalyzer::compute_amplitudes] update required"};
+
+	_amplitudes.resize(get_bin_count());
+	const auto *__restrict const offsets = kernel_offsets.data();
+	const auto *__restrict const first = kernel_first.data();
+	const auto *__restrict const weights = kernel.data();
+
+	for (int k = 0; k < octaves; ++k)
+	{
+		// octave k from the top, analyzed at sample_rate_hz / 2^k
+		const auto samples = k ? levels[k - 1].window().last(fft_size) : std::span<const float>{top};
+		std::ranges::copy(samples, fft.input().begin());
+		fft.execute();
+
+		const auto *__restrict const spectrum = fft.output().data();
+		auto *__restrict const out = _amplitudes.data() + (octaves - 1 - k) * bins_per_octave;
+		for (int j = 0; j < bins_per_octave; ++j)
+		{
+			const auto *__restrict const x = spectrum + first[j];
+			const auto *__restrict const w = weights + offsets[j];
+			const auto count = offsets[j + 1] - offsets[j];
+
+			// complex multiply-add, split into real and imaginary parts so it vectorizes
+			float re{}, im{};
+			for (int i = 0; i < count; ++i)
+			{
+				re += x[i].real() * w[i].real() - x[i].imag() * w[i].imag();
+				im += x[i].real() * w[i].imag() + x[i].imag() * w[i].real();
+			}
+			out[j] = sqrtf(re * re + im * im);
+		}
+	}
+}
+
+std::span<const float> ConstantQAnalyzer::get_amplitudes() const
+{
+	if (_amplitudes.empty())
+		throw std::logic_error{"[ConstantQAnalyzer::get_amplitudes] computed amplitudes required"};
+	return _amplitudes;
+}
+
+} // namespace avz
@@ -0,0 +1,110 @@
+#include <avz/analysis/Decimator.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+
+namespace avz
+{
+
+Decimator::Decimator(const int factor, const int window_size, const int taps_per_phase)
+	: factor{factor},
+	  window_size{window_size}
+{
+	if (factor <= 0 || window_size <= 0 || taps_per_phase <= 0)
+		throw std::invalid_argument{"[Decimator] factor, window_size, and taps_per_phase must be > 0"};
+
+	if (factor == 1)
+		taps = {1};
+	else
+	{
+		// blackman-windowed sinc lowpass, cutoff a bit under the output nyquist (0.5 / factor)
+		const int num_taps = factor * taps_per_phase;
+		const double cutoff = 0.4 / factor;
+		const double center = (num_taps - 1) / 2.;
+		taps.resize(num_taps);
+
+		double sum{};
+		for (int i = 0; i < num_taps; ++i)
+		{
+			const auto x = i - center;
+			const auto sinc = x ? sin(2 * M_PI * cutoff * x) / (M_PI * x) : 2 * cutoff;
+			const auto window =
+				0.42 - 0.5 * cos(2 * M_PI * i / (num_taps - 1)) + 0.08 * cos(4 * M_PI * i / (num_taps - 1));
+			taps[i] = sinc * window;
+			sum += taps[i];
+		}
+
+		// unity gain at DC, so amplitudes match those computed at the original rate
+		for (auto &t : taps)
+			t /= sum;
+	}
+
+	reset();
+}
+
+int Decimator::factor_for(const float input_sample_rate, const float target_sample_rate)
+{
+	return std::max(1, (int)(input_sample_rate / target_sample_rate));
+}
+
+void Decimator::reset()
+{
+	history.assign(taps.size() - 1, 0);
+	next_output = history.size();
+	window_buf.assign(2 * window_size, 0);
+	window_pos = 0;
+	primed = false;
+}
+
+int Decimator::push(std::span<const float> samples, const int num_channels, const int channel)
+{
+	const auto frames = samples.size() / num_channels;
+	const auto old_size = history.size();
+	history.resize(old_size + frames);
+	for (size_t i = 0; i < frames; ++i)
+		history[old_size + i] = samples[i * num_channels + channel];
+
+	const auto num_taps = taps.size();
+	const auto *__restrict const taps_ptr = taps.data();
+
+	// only evaluate the filter at the samples we keep; the taps are symmetric,
+	// so each output is a straight dot product that -ffast-math lets the compiler vectorize
+	int produced{};
+	for (; next_output < history.size(); next_output += factor, ++produced)
+	{
+		const auto *__restrict const in_ptr = history.data() + next_output + 1 - num_taps;
+		float acc{};
+		for (size_t j = 0; j < num_taps; ++j)
+			acc += taps_ptr[j] * in_ptr[j];
+
+		window_buf[window_pos] = window_buf[window_pos + window_size] = acc;
+		if (++window_pos == window_size)
+			window_pos = 0;
+	}
+
+	// keep just enough input for the next output's filter
+	const auto consumed = history.size() - (num_taps - 1);
+	history.erase(history.begin(), history.begin() + consumed);
+	next_output -= consumed;
+	return produced;
+}
+
+void Decimator::update(std::span<const float> audio, const int hop, const int num_channels, const int channel)
+{
+	const auto input_window_size = get_input_window_size();
+	assert(audio.size() >= input_window_size * num_channels);
+
+	if (!primed || hop >= input_window_size)
+	{
+		reset();
+		push(audio.first(input_window_size * num_channels), num_channels, channel);
+		primed = true;
+		return;
+	}
+
+	push(audio.subspan((input_window_size - hop) * num_channels, hop * num_channels), num_channels, channel);
+}
+
+} // namespace avz
@@ -0,0 +1,136 @@
+// only built with the FFTW backend (LIBAVZ_FFT_FFTW)
+#if defined(LIBAVZ_FFT_FFTW)
+
+#include <avz/analysis/FftwPlanCache.hpp>
+
+#include <cassert>
+#include <complex>
+#include <stdexcept>
+
+namespace avz
+{
+
+namespace
+{
+
+// widest simd alignment fftw can ask for, in bytes (avx-512)
+constexpr int max_simd_alignment = 64;
+
+} // namespace
+
+FftwPlanCache &FftwPlanCache::instance()
+{
+	// never destroyed: plans held by other static objects (e.g. a static FrequencyAnalyzer) are released
+	// during static destruction, and their deleter still needs the mutex
+	static auto &cache = *new FftwPlanCache;
+	return cache;
+}
+
+FftwPlanCache::Plan FftwPlanCache::get_r2c(const int n, const int in_alignment, const int out_alignment, unsigned flags)
+{
+	return get({Kind::R2C, n, 1, in_alignment, out_alignment, flags});
+}
+
+FftwPlanCache::Plan FftwPlanCache::get_c2c(const int n, const int in_alignment, const int out_alignment, unsigned flags)
+{
+	return get({Kind::C2C, n, 1, in_alignment, out_alignment, flags});
+}
+
+FftwPlanCache::Plan FftwPlanCache::get_r2c_interleaved(
+	const int n, const int howmany, const int in_alignment, const int out_alignment, unsigned flags)
+{
+	return get({Kind::R2C_INTERLEAVED, n, howmany, in_alignment, out_alignment, flags});
+}
+
+FftwPlanCache::Plan FftwPlanCache::get(const Key &key)
+{
+	std::lock_guard lk{mu};
+
+	if (const auto it = plans.find(key); it != plans.end())
+		if (const auto plan = it->second.lock())
+			return plan;
+
+	auto plan = create_plan(key, key.flags);
+	if (!plan && (key.flags & FFTW_WISDOM_ONLY))
+		plan = create_plan(key, FFTW_ESTIMATE);
+
+	if (!plan)
+		throw std::runtime_error{"[FftwPlanCache::get] fftw planner failed for n=" + std::to_string(key.n)};
+
+	// drop the keys of plans nobody holds anymore, e.g. from windows resized along the way
+	std::erase_if(plans, [](const auto &entry) { return entry.second.expired(); });
+
+	Plan shared{plan, &FftwPlanCache::destroy_plan};
+	plans[key] = shared;
+	return shared;
+}
+
+fftwf_plan FftwPlanCache::create_plan(const Key &key, const unsigned flags)
+{
+	const auto n = key.n, howmany = key.howmany, bins = n / 2 + 1;
+	const auto in_size = (key.kind == Kind::C2C ? sizeof(std::complex<float>) : sizeof(float)) * n * howmany;
+	const auto out_size = (key.kind == Kind::C2C ? n : bins) * sizeof(std::complex<float>) * howmany;
+
+	// planning with anything other than FFTW_ESTIMATE overwrites the arrays,
+	// so plan on scratch buffers with the same alignment as the caller's buffers.
+	// fftwf_alignment_of is below the widest simd alignment, which the extra bytes leave room for.
+	assert(key.in_alignment >= 0 && key.in_alignment < max_simd_alignment);
+	assert(key.out_alignment >= 0 && key.out_alignment < max_simd_alignment);
+	const auto in_buf = (std::byte *)fftwf_malloc(in_size + max_simd_alignment);
+	const auto out_buf = (std::byte *)fftwf_malloc(out_size + max_simd_alignment);
+	const auto in = in_buf + key.in_alignment;
+	const auto out = (fftwf_complex *)(out_buf + key.out_alignment);
+
+	fftwf_plan plan{};
+	switch (key.kind)
+	{
+	case Kind::R2C:
+		plan = fftwf_plan_dft_r2c_1d(n, (float *)in, out, flags);
+		break;
+	case Kind::C2C:
+		plan = fftwf_plan_dft_1d(n, (fftwf_complex *)in, out, FFTW_FORWARD, flags);
+		break;
+	case Kind::R2C_INTERLEAVED:
+		plan = fftwf_plan_many_dft_r2c(1, &n, howmany, (float *)in, nullptr, howmany, 1, out, nullptr, 1, bins, flags);
+		break;
+	}
+
+	fftwf_free(in_buf);
+	fftwf_free(out_buf);
+	return plan;
+}
+
+void FftwPlanCache::set_default_flags(const unsigned flags)
+{
+	std::lock_guard lk{mu};
+	default_flags = flags;
+}
+
+unsigned FftwPlanCache::get_default_flags()
+{
+	std::lock_guard lk{mu};
+	return default_flags;
+}
+
+bool FftwPlanCache::import_wisdom(const std::string &path)
+{
+	std::lock_guard lk{mu};
+	return fftwf_import_wisdom_from_filename(path.c_str());
+}
+
+bool FftwPlanCache::export_wisdom(const std::string &path)
+{
+	std::lock_guard lk{mu};
+	return fftwf_export_wisdom_to_filename(path.c_str());
+}
+
+void FftwPlanCache::destroy_plan(const fftwf_plan plan)
+{
+	// fftwf_destroy_plan is part of the planner, so it must be serialized too
+	std::lock_guard lk{instance().mu};
+	fftwf_destroy_plan(plan);
+}
+
+} // namespace avz
+
+#endif
@@ -1,82 +1,200 @@
+#include <algorithm>
 #include <avz/analysis/FrequencyAnalyzer.hpp>
+#include <avz/analysis/WindowCache.hpp>
+#include <bit>
 #include <cassert>
 #include <cmath>
+#include <stdexcept>
+#include <string>
 
 namespace avz
 {
 
-FrequencyAnalyzer::FrequencyAnalyzer(const int fft_size)
-	: fft_size{fft_size}
+FrequencyAnalyzer::FrequencyAnalyzer(const int fft_size, const SizePolicy size_policy)
+	: fft_size{fft_size},
+	  size_policy{size_policy}
 {
 	set_fft_size(fft_size);
 }
 
 void FrequencyAnalyzer::set_fft_size(const int fft_size)
 {
+	if (fft_size <= 0)
+		throw std::invalid_argument{"[FrequencyAnalyzer::set_fft_size] fft_size must be > 0"};
 	this->fft_size = fft_size;
-	fftw.set_n(fft_size);
+	transform_size = compute_transform_size(fft_size, size_policy);
+	fft.set_n(transform_size, fft_backend);
+
+	// copy_to_input only ever writes the first fft_size samples, so the padding stays zero
+	std::ranges::fill(fft.input().subspan(fft_size), 0);
+
 	compute_window_values();
 }
 
+void FrequencyAnalyzer::set_fft_backend(const fft::Backend backend)
+{
+	if (!fft::is_available(backend))
+		throw std::invalid_argument{
+			std::string{"[FrequencyAnalyzer::set_fft_backend] backend not compiled in: "} + fft::backend_name(backend)};
+	fft_backend = backend;
+	set_fft_size(fft_size);
+}
+
+void FrequencyAnalyzer::set_size_policy(const SizePolicy size_policy)
+{
+	this->size_policy = size_policy;
+	set_fft_size(fft_size);
+}
+
+int FrequencyAnalyzer::compute_transform_size(const int fft_size, const SizePolicy size_policy)
+{
+	if (fft_size <= 0)
+		throw std::invalid_argument{"[FrequencyAnalyzer::compute_transform_size] fft_size must be > 0"};
+	switch (size_policy)
+	{
+	case SizePolicy::Exact:
+		return fft_size;
+	case SizePolicy::PowerOfTwo:
+		return std::bit_ceil((unsigned)fft_size);
+	case SizePolicy::Smooth:
+		// keep it even so that the output has exactly n / 2 + 1 bins with a nyquist bin
+		for (int n = fft_size + (fft_size & 1);; n += 2)
+		{
+			int m = n;
+			for (const int p : {2, 3, 5, 7})
+				while (m % p == 0)
+					m /= p;
+			if (m == 1)
+				return n;
+		}
+	default:
+		throw std::logic_error{"[FrequencyAnalyzer::compute_transform_size] default case hit"};
+	}
+}
+
 void FrequencyAnalyzer::set_window_func(const WindowFunction wf)
 {
 	window_func = wf;
 	compute_window_values();
 }
 
+void FrequencyAnalyzer::set_kaiser_beta(const float beta)
+{
+	if (beta < 0)
+		throw std::invalid_argument{"[FrequencyAnalyzer::set_kaiser_beta] beta must be >= 0"};
+	kaiser_beta = beta;
+	compute_window_values();
+}
+
+void FrequencyAnalyzer::set_pre_emphasis(const float coefficient)
+{
+	if (coefficient < 0 || coefficient > 1)
+		throw std::invalid_argument{"[FrequencyAnalyzer::set_pre_emphasis] coefficient must be in [0, 1]"};
+	pre_emphasis = coefficient;
+}
+
 void FrequencyAnalyzer::copy_to_input(std::span<const float> wavedata)
 {
 	assert(wavedata.size() == fft_size);
+	copy_to_input(wavedata, 1, 0);
+}
 
-	auto *__restrict const out_ptr = fftw.input().data();
-	const auto *__restrict const in_ptr = wavedata.data();
-	const auto *__restrict const win_ptr = window_values.data();
+void FrequencyAnalyzer::copy_to_input(std::span<const float> interleaved, const int num_channels, const int channel)
+{
+	assert(num_channels > 0 && channel >= 0 && channel < num_channels);
+	assert(interleaved.size() >= fft_size * num_channels);
 
-	if (window_func != WindowFunction::None)
-#pragma GCC ivdep
-		for (int i = 0; i < fft_size; ++i)
-			out_ptr[i] = in_ptr[i] * win_ptr[i];
+	const auto *__restrict const in_ptr = interleaved.data() + channel;
+	if (num_channels == 1)
+		fused_copy_to_input([in_ptr](const int i) { return in_ptr[i]; });
 	else
-#pragma GCC ivdep
-		for (int i = 0; i < fft_size; ++i)
-			out_ptr[i] = in_ptr[i];
+		fused_copy_to_input([in_ptr, num_channels](const int i) { return in_ptr[i * num_channels]; });
 }
 
-void FrequencyAnalyzer::compute_window_values()
+void FrequencyAnalyzer::copy_to_input(std::span<const float> interleaved, const StereoMix mix)
 {
-	if (window_func == WindowFunction::None)
-		return;
-
-	window_values.resize(fft_size);
+	assert(interleaved.size() >= fft_size * 2);
 
-	if (window_func == WindowFunction::Hanning)
-		apply_hanning_window();
-	else if (window_func == WindowFunction::Blackman)
-		apply_blackman_window();
-	else if (window_func == WindowFunction::Hamming)
-		apply_hamming_window();
+	const auto *__restrict const in_ptr = interleaved.data();
+	switch (mix)
+	{
+	case StereoMix::Mid:
+		fused_copy_to_input([in_ptr](const int i) { return 0.5f * (in_ptr[2 * i] + in_ptr[2 * i + 1]); });
+		break;
+	case StereoMix::Side:
+		fused_copy_to_input([in_ptr](const int i) { return 0.5f * (in_ptr[2 * i] - in_ptr[2 * i + 1]); });
+		break;
+	default:
+		throw std::logic_error{"[FrequencyAnalyzer::copy_to_input] default case hit"};
+	}
 }
 
-void FrequencyAnalyzer::apply_hanning_window()
+template <typename Sample>
+void FrequencyAnalyzer::fused_copy_to_input(const Sample sample)
 {
-#pragma GCC ivdep
-	for (int i = 0; i < fft_size; ++i)
-		window_values[i] = 0.5f * (1 - cos(2 * M_PI * i / (fft_size - 1)));
+	if (pre_emphasis)
+	{
+		const auto a = pre_emphasis;
+		// the sample before the first one is taken to be equal to it
+		window_to_input((1 - a) * sample(0), [&](const int i) { return sample(i) - a * sample(i - 1); });
+	}
+	else
+		window_to_input(sample(0), sample);
 }
 
-void FrequencyAnalyzer::apply_hamming_window()
+template <typename Sample>
+void FrequencyAnalyzer::window_to_input(const float x0, const Sample x)
 {
+	auto *__restrict const out_ptr = fft.input().data();
+	const auto *__restrict const win_ptr = window_values ? window_values->data() : nullptr;
+
+	const bool windowed = window_func != WindowFunction::None;
+
+	// the mean has to be known before anything can be written, which costs an extra read-only pass.
+	// weighting it by the window makes the windowed DC bin exactly zero.
+	float mean{};
+	if (dc_removal && windowed)
+	{
+		float sum{x0 * win_ptr[0]}, window_sum{win_ptr[0]};
+#pragma GCC ivdep
+		for (int i = 1; i < fft_size; ++i)
+		{
+			sum += x(i) * win_ptr[i];
+			window_sum += win_ptr[i];
+		}
+		mean = sum / window_sum;
+	}
+	else if (dc_removal)
+	{
+		float sum{x0};
+#pragma GCC ivdep
+		for (int i = 1; i < fft_size; ++i)
+			sum += x(i);
+		mean = sum / fft_size;
+	}
+
+	if (windowed)
+	{
+		out_ptr[0] = (x0 - mean) * win_ptr[0];
+#pragma GCC ivdep
+		for (int i = 1; i < fft_size; ++i)
+			out_ptr[i] = (x(i) - mean) * win_ptr[i];
+	}
+	else
+	{
+		out_ptr[0] = x0 - mean;
 #pragma GCC ivdep
-	for (int i = 0; i < fft_size; ++i)
-		window_values[i] = 0.54f - 0.46f * cos(2 * M_PI * i / (fft_size - 1));
+		for (int i = 1; i < fft_size; ++i)
+			out_ptr[i] = x(i) - mean;
+	}
 }
 
-void FrequencyAnalyzer::apply_blackman_window()
+void FrequencyAnalyzer::compute_window_values()
 {
-#pragma GCC ivdep
-	for (int i = 0; i < fft_size; ++i)
-		window_values[i] =
-			0.42f - 0.5f * cos(2 * M_PI * i / (fft_size - 1)) + 0.08f * cos(4 * M_PI * i / (fft_size - 1));
+	if (window_func == WindowFunction::None)
+		window_values.reset();
+	else
+		window_values = WindowCache::instance().get(window_func, fft_size, kaiser_beta);
 }
 
 } // namespace avz
@@ -1,8 +1,38 @@
 #include <avz/analysis/Interpolator.hpp>
 
+#include <stdexcept>
+
 namespace avz
 {
 
+void Interpolator::reserve(const size_t size)
+{
+	spline.reserve(size);
+	for (auto *const v : {&m_spline_x, &m_spline_y, &zero_x, &zero_y})
+		v->reserve(size);
+}
+
+void Interpolator::update_spline_type()
+{
+	switch (type)
+	{
+	case InterpolationType::LINEAR:
+		spline.set_type(Spline::Type::LINEAR);
+		break;
+	case InterpolationType::CSPLINE:
+		spline.set_type(Spline::Type::NATURAL);
+		break;
+	case InterpolationType::CSPLINE_HERMITE:
+		spline.set_type(Spline::Type::HERMITE);
+		break;
+	case InterpolationType::MONOTONE:
+		spline.set_type(Spline::Type::MONOTONE);
+		break;
+	default:
+		throw std::logic_error{"[Interpolator::update_spline_type] default case hit"};
+	}
+}
+
 void Interpolator::interpolate(std::span<float> range)
 {
 	const auto size = range.size();
@@ -10,36 +40,40 @@ void Interpolator::interpolate(std::span<float> range)
 	// separate the nonzero values (y's) and their indices (x's)
 	m_spline_x.clear();
 	m_spline_y.clear();
-	zero_indices.clear();
+	zero_x.clear();
 	for (size_t i = 0; i < size; ++i)
 	{
 		if (!range[i])
 		{
-			zero_indices.emplace_back(i);
+			zero_x.emplace_back(i);
 			continue;
 		}
 		m_spline_x.emplace_back(i);
 		m_spline_y.emplace_back(range[i]);
 	}
 
-	spline.set_points(m_spline_x, m_spline_y, (tk::spline::spline_type)type);
+	if (zero_x.empty())
+	{
+		// nothing to fill in, but don't leave the previous spectrum's spline behind for `sample`
+		spline.set_points({}, {});
+		return;
+	}
+
+	// when the same bins are empty as last frame, the spline reuses its factorization
+	update_spline_type();
+	spline.set_points(m_spline_x, m_spline_y);
 
 	// fill in the gaps
-	for (const auto zero_index : zero_indices)
-		range[zero_index] = spline(zero_index);
+	zero_y.resize(zero_x.size());
+	spline.sample_sorted(zero_x, zero_y);
+	for (size_t i = 0; i < zero_x.size(); ++i)
+		range[(size_t)zero_x[i]] = zero_y[i];
 }
 
 void Interpolator::set_values(std::span<const float> values)
 {
-	m_spline_x.clear();
-	m_spline_y.clear();
-	for (size_t i = 0; i < values.size(); ++i)
-	{
-		m_spline_x.emplace_back(i);
-		m_spline_y.emplace_back(values[i]);
-	}
-
-	spline.set_points(m_spline_x, m_spline_y, (tk::spline::spline_type)type);
+	update_spline_type();
+	spline.set_values(values);
 }
 
 } // namespace avz
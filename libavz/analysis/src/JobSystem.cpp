@@ -0,0 +1,321 @@
+#include <avz/analysis/JobSystem.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+namespace avz
+{
+
+namespace
+{
+
+// failed steal attempts before an idle thread goes to sleep
+constexpr int spin_count = 64;
+
+std::atomic<unsigned> next_system_id{};
+
+// the context of the calling thread in the system with id `cached_system`
+thread_local unsigned cached_system{~0u};
+thread_local void *cached_context{};
+
+} // namespace
+
+// Chase-Lev deque (Le et al., "Correct and Efficient Work-Stealing for Weak Memory Models") of pointers into `jobs`.
+// Job storage is handed out by its own cursor rather than by deque index: a job popped back by its owner is still
+// running when the owner pushes the jobs it forks, and those must not need its storage.
+struct alignas(64) JobSystem::Context
+{
+	alignas(64) std::atomic<int64_t> top{};
+	alignas(64) std::atomic<int64_t> bottom{};
+	std::array<std::atomic<Job *>, queue_capacity> slots{};
+	std::array<Job, queue_capacity> jobs;
+
+	// owner only: where the search for free job storage starts
+	unsigned next_job{};
+
+	// the external thread that claimed this context, unused for workers
+	std::atomic<std::thread::id> owner{};
+
+	// owner only
+	bool push(Job *const job)
+	{
+		const auto b = bottom.load(std::memory_order_relaxed);
+		const auto t = top.load(std::memory_order_acquire);
+		if (b - t >= queue_capacity)
+			return false;
+		slots[b % queue_capacity].store(job, std::memory_order_release);
+		std::atomic_thread_fence(std::memory_order_release);
+		bottom.store(b + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+	// owner only
+	Job *pop()
+	{
+		const auto b = bottom.load(std::memory_order_relaxed) - 1;
+		bottom.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		auto t = top.load(std::memory_order_relaxed);
+
+		if (t > b)
+		{
+			// empty
+			bottom.store(b + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		auto *job = slots[b % queue_capacity].load(std::memory_order_relaxed);
+		if (t == b)
+		{
+			// last job: race the thieves for it
+			if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				job = nullptr;
+			bottom.store(b + 1, std::memory_order_relaxed);
+		}
+		return job;
+	}
+
+	// any thread
+	Job *steal()
+	{
+		auto t = top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const auto b = bottom.load(std::memory_order_acquire);
+		if (t >= b)
+			return nullptr;
+
+		auto *const job = slots[t % queue_capacity].load(std::memory_order_acquire);
+		if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			return nullptr;
+		return job;
+	}
+};
+
+JobSystem::JobSystem(int num_threads)
+	: id{next_system_id++}
+{
+	if (num_threads < 0)
+		throw std::invalid_argument{"[JobSystem] num_threads must be >= 0"};
+	if (!num_threads)
+		num_threads = std::max(1u, std::thread::hardware_concurrency());
+
+	num_workers = num_threads - 1;
+	contexts = std::make_unique<Context[]>(num_workers + max_external_threads);
+	for (int i = 0; i < num_workers; ++i)
+		workers.emplace_back(&JobSystem::worker_loop, this, i);
+}
+
+JobSystem::~JobSystem()
+{
+	stopping = true;
+	++epoch;
+	epoch.notify_all();
+	workers.clear();
+}
+
+JobSystem &JobSystem::instance()
+{
+	static JobSystem system;
+	return system;
+}
+
+JobSystem::Context *JobSystem::current_context()
+{
+	if (cached_system == id)
+		return static_cast<Context *>(cached_context);
+
+	// workers cache their context when they start, so this is an external thread
+	const auto self = std::this_thread::get_id();
+	const auto external = contexts.get() + num_workers;
+	Context *claimed{};
+	for (int i = 0; i < max_external_threads && !claimed; ++i)
+		if (external[i].owner.load(std::memory_order_relaxed) == self)
+			claimed = external + i;
+	for (int i = 0; i < max_external_threads && !claimed; ++i)
+	{
+		// contexts of exited threads stay claimed, but a new thread may be given the same id
+		std::thread::id unowned;
+		if (external[i].owner.compare_exchange_strong(unowned, self))
+			claimed = external + i;
+	}
+
+	if (claimed)
+	{
+		cached_system = id;
+		cached_context = claimed;
+	}
+	return claimed;
+}
+
+JobSystem::Job *JobSystem::acquire_job()
+{
+	auto *const context = current_context();
+	if (!context)
+		return nullptr;
+
+	// storage is free once the job last stored there has finished; jobs usually finish roughly in the order
+	// they were submitted, so the storage after the last one handed out is almost always free
+	for (int i = 0; i < queue_capacity; ++i)
+	{
+		auto &job = context->jobs[context->next_job++ % queue_capacity];
+		if (!job.busy.load(std::memory_order_acquire))
+			return &job;
+	}
+	return nullptr;
+}
+
+void JobSystem::submit(Job *const job)
+{
+	job->group->pending.fetch_add(1, std::memory_order_relaxed);
+	job->busy.store(true, std::memory_order_relaxed);
+	if (!static_cast<Context *>(cached_context)->push(job))
+	{
+		execute(job);
+		return;
+	}
+
+	// a thread about to sleep either sees the job or sees the new epoch
+	++epoch;
+	if (sleepers.load())
+		epoch.notify_one();
+}
+
+void JobSystem::run_inline(TaskGroup &group, void (*const invoke)(const void *), const void *const f)
+{
+	try
+	{
+		invoke(f);
+	}
+	catch (...)
+	{
+		if (!group.failed.exchange(true))
+			group.error = std::current_exception();
+	}
+}
+
+void JobSystem::execute(Job *const job)
+{
+	auto &group = *job->group;
+	run_inline(group, job->invoke, job->storage);
+	job->busy.store(false, std::memory_order_release);
+
+	// the waiting thread may destroy the group as soon as this reaches 0, so wake it through the epoch
+	if (group.pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		++epoch;
+		if (sleepers.load())
+			epoch.notify_all();
+	}
+}
+
+JobSystem::Job *JobSystem::find_job(Context *const self)
+{
+	if (self)
+		if (auto *const job = self->pop())
+			return job;
+
+	// steal, starting after our own context so thieves spread out
+	const auto count = num_workers + max_external_threads;
+	const auto start = self ? (int)(self - contexts.get()) + 1 : 0;
+	for (int i = 0; i < count; ++i)
+	{
+		auto &victim = contexts[(start + i) % count];
+		if (&victim != self)
+			if (auto *const job = victim.steal())
+				return job;
+	}
+	return nullptr;
+}
+
+void JobSystem::sleep(const unsigned seen)
+{
+	++sleepers;
+	epoch.wait(seen);
+	--sleepers;
+}
+
+JobSystem::TaskGroup::~TaskGroup()
+{
+	if (auto *const s = system.load(std::memory_order_relaxed); s && !done())
+		s->join(*this);
+}
+
+void JobSystem::wait(TaskGroup &group)
+{
+	join(group);
+	if (group.failed.load(std::memory_order_acquire))
+	{
+		group.failed = false;
+		std::rethrow_exception(std::exchange(group.error, nullptr));
+	}
+}
+
+void JobSystem::join(TaskGroup &group)
+{
+	auto *const self = current_context();
+	for (int spins = 0; !group.done();)
+	{
+		if (auto *const job = find_job(self))
+		{
+			execute(job);
+			spins = 0;
+			continue;
+		}
+		if (++spins < spin_count)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		// read the epoch before checking again, so a job or completion in between wakes us immediately
+		const auto seen = epoch.load();
+		if (group.done())
+			break;
+		if (auto *const job = find_job(self))
+		{
+			execute(job);
+			continue;
+		}
+		sleep(seen);
+		spins = 0;
+	}
+}
+
+void JobSystem::worker_loop(const int index)
+{
+	cached_system = id;
+	cached_context = &contexts[index];
+	auto *const self = &contexts[index];
+
+	for (int spins = 0; !stopping.load(std::memory_order_relaxed);)
+	{
+		if (auto *const job = find_job(self))
+		{
+			execute(job);
+			spins = 0;
+			continue;
+		}
+		if (++spins < spin_count)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		const auto seen = epoch.load();
+		if (stopping)
+			break;
+		if (auto *const job = find_job(self))
+		{
+			execute(job);
+			continue;
+		}
+		sleep(seen);
+		spins = 0;
+	}
+}
+
+} // namespace avz
@@ -0,0 +1,148 @@
+#include <avz/analysis/LogSpectrumRemapper.hpp>
+
+#include <algorithm>
+
+namespace avz
+{
+
+LogSpectrumRemapper::LogSpectrumRemapper(
+	const BinPacker::Scale scale, const BinPacker::AccumulationMethod am, const Interpolator::InterpolationType type)
+	: type{type}
+{
+	packer.set_scale(scale);
+	packer.set_accum_method(am);
+}
+
+void LogSpectrumRemapper::set_scale(const BinPacker::Scale scale)
+{
+	packer.set_scale(scale);
+}
+
+void LogSpectrumRemapper::set_nth_root(const int nth_root)
+{
+	packer.set_nth_root(nth_root);
+}
+
+void LogSpectrumRemapper::set_accum_method(const BinPacker::AccumulationMethod am)
+{
+	packer.set_accum_method(am);
+}
+
+void LogSpectrumRemapper::set_interp_type(const Interpolator::InterpolationType type)
+{
+	if (type == this->type)
+		return;
+	this->type = type;
+	// gap weights depend on the type, so force a recompile
+	plan.reset();
+}
+
+void LogSpectrumRemapper::compile_gaps()
+{
+	const auto out_size = plan->get_key().out_size;
+
+	std::vector<int> filled;
+	for (int i = 0; i < out_size; ++i)
+		if (!plan->is_row_empty(i))
+			filled.push_back(i);
+
+	gaps.clear();
+	if (filled.empty())
+		return;
+
+	for (int row = 0; row < out_size; ++row)
+	{
+		if (!plan->is_row_empty(row))
+			continue;
+
+		// first filled row after this gap
+		const auto p = std::upper_bound(filled.begin(), filled.end(), row) - filled.begin();
+
+		if (p == 0 || p == (ptrdiff_t)filled.size())
+		{
+			// before the first or after the last filled row: hold its value
+			const auto src = filled[p ? p - 1 : 0];
+			gaps.push_back({row, {src, src, src, src}, {1, 0, 0, 0}});
+			continue;
+		}
+
+		// the gap lies between filled rows x1 and x2, with optional outer neighbours x0 and x3
+		const auto x1 = filled[p - 1], x2 = filled[p];
+		const bool has_x0 = p >= 2, has_x3 = p + 1 < (ptrdiff_t)filled.size();
+		const auto x0 = has_x0 ? filled[p - 2] : x1, x3 = has_x3 ? filled[p + 1] : x2;
+		const float h = x2 - x1, t = (row - x1) / h;
+
+		Gap gap{row, {x0, x1, x2, x3}, {}};
+		auto &w = gap.weights;
+
+		if (type == Interpolator::InterpolationType::LINEAR)
+			w = {0, 1 - t, t, 0};
+		else
+		{
+			// every quantity below is linear in the 4 neighbour values, so track it as a vector of their weights
+			using Vec = std::array<float, 4>;
+			const auto axpy = [](Vec &y, const float a, const Vec &x)
+			{
+				for (int j = 0; j < 4; ++j)
+					y[j] += a * x[j];
+			};
+
+			const Vec s1{0, -1 / h, 1 / h, 0};
+
+			// slopes of the parabolas through each end of the gap and its neighbours, or the secant at the edges
+			Vec m1 = s1, m2 = s1;
+			if (has_x0)
+			{
+				const float h0 = x1 - x0;
+				const Vec s0{-1 / h0, 1 / h0, 0, 0};
+				m1 = {};
+				axpy(m1, h / (h0 + h), s0);
+				axpy(m1, h0 / (h0 + h), s1);
+			}
+			if (has_x3)
+			{
+				const float h2 = x3 - x2;
+				const Vec s2{0, 0, -1 / h2, 1 / h2};
+				m2 = {};
+				axpy(m2, h2 / (h + h2), s1);
+				axpy(m2, h / (h + h2), s2);
+			}
+
+			// cubic hermite basis
+			const auto t2 = t * t, t3 = t2 * t;
+			w = {0, 2 * t3 - 3 * t2 + 1, -2 * t3 + 3 * t2, 0};
+			axpy(w, h * (t3 - 2 * t2 + t), m1);
+			axpy(w, h * (t3 - t2), m2);
+		}
+
+		gaps.push_back(gap);
+	}
+}
+
+void LogSpectrumRemapper::remap(std::span<float> out, std::span<const float> in)
+{
+	if (out.empty())
+		return;
+
+	if (in.empty())
+	{
+		std::ranges::fill(out, 0);
+		return;
+	}
+
+	if (auto current = packer.get_plan(out.size(), in.size()); current != plan)
+	{
+		plan = std::move(current);
+		compile_gaps();
+	}
+
+	// filled rows first, then gaps, which only read filled rows
+	plan->execute(out, in);
+
+	auto *__restrict const out_ptr = out.data();
+	for (const auto &[row, src, w] : gaps)
+		out_ptr[row] =
+			w[0] * out_ptr[src[0]] + w[1] * out_ptr[src[1]] + w[2] * out_ptr[src[2]] + w[3] * out_ptr[src[3]];
+}
+
+} // namespace avz
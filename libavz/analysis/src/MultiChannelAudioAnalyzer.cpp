@@ -1,6 +1,7 @@
 #include <avz/analysis/MultiChannelAudioAnalyzer.hpp>
 #include <avz/analysis/util.hpp>
 
+#include <algorithm>
 #include <stdexcept>
 
 namespace avz
@@ -11,55 +12,184 @@ MultiChannelAudioAnalyzer::MultiChannelAudioAnalyzer(int num_channels)
 {
 	if (num_channels <= 0)
 		throw std::invalid_argument{"[MultiChannelAudioAnalyzer] num_channels must be > 0"};
+}
+
+void MultiChannelAudioAnalyzer::execute_fft(const FrequencyAnalyzer &fa, std::span<const float> interleaved_audio)
+{
+	assert(interleaved_audio.size() >= fa.get_fft_size() * num_channels);
 
-	analyzers.resize(num_channels);
+	fft_size = fa.get_fft_size();
+	bins = fa.get_transform_size() / 2 + 1;
+
+	if (num_channels == 2 && packed_stereo)
+		execute_packed_stereo_fft(fa, interleaved_audio);
+	else
+		execute_batched_fft(fa, interleaved_audio);
+
+	// reset state computed from previous fft output
+	_amplitudes.clear();
 }
 
-void MultiChannelAudioAnalyzer::execute_fft(FrequencyAnalyzer &fa, std::span<const float> interleaved_audio)
+void MultiChannelAudioAnalyzer::execute_batched_fft(
+	const FrequencyAnalyzer &fa, std::span<const float> interleaved_audio)
 {
-	const int window_size = fa.get_fft_size();
-	assert(interleaved_audio.size() == window_size * num_channels);
+	const int n = fa.get_transform_size();
+	const auto samples = fft_size * num_channels;
 
-	// Extract each channel and run FFT
-	for (int ch = 0; ch < num_channels; ++ch)
+	if (batch_fft.size() != n || batch_fft.num_channels() != num_channels)
+		batch_fft.set_n(n, num_channels);
+
+	// zero-padding, if any
+	std::ranges::fill(batch_fft.input().subspan(samples), 0);
+
+	// window every channel in one pass, keeping the samples interleaved for the batched plan
+	window_channels(fa, interleaved_audio.data(), batch_fft.input().data());
+
+	batch_fft.execute();
+	spectra = batch_fft.output();
+}
+
+void MultiChannelAudioAnalyzer::execute_packed_stereo_fft(
+	const FrequencyAnalyzer &fa, std::span<const float> interleaved_audio)
+{
+	const int n = fa.get_transform_size();
+
+	if (stereo_fft.size() != n)
+		stereo_fft.set_n(n);
+
+	// zero-padding, if any
+	std::ranges::fill(stereo_fft.input().subspan(fft_size), std::complex<float>{});
+
+	// z[i] = l[i] + j * r[i], windowed: complex values are laid out like interleaved stereo
+	auto *const z = stereo_fft.input().data();
+	window_channels(fa, interleaved_audio.data(), reinterpret_cast<float *>(z));
+
+	stereo_fft.execute();
+
+	// the spectrum of a real signal is conjugate-symmetric, so with Zc = conj(Z[n - k]):
+	// L[k] = (Z[k] + Zc) / 2
+	// R[k] = (Z[k] - Zc) / 2j
+	stereo_spectra.resize(2 * bins);
+	const auto *__restrict const out = stereo_fft.output().data();
+	auto *__restrict const left = stereo_spectra.data();
+	auto *__restrict const right = stereo_spectra.data() + bins;
+	for (int k = 0; k < bins; ++k)
 	{
-		// Copy channel data (deinterleave)
-		float buf[window_size];
-		std::span channel_audio{buf, static_cast<size_t>(window_size)};
-		util::extract_channel(channel_audio, interleaved_audio, num_channels, ch);
-		analyzers[ch].execute_fft(fa, channel_audio);
+		const auto zk = out[k];
+		const auto zc = std::conj(out[k ? n - k : 0]);
+		const auto sum = zk + zc, diff = zk - zc;
+		left[k] = {0.5f * sum.real(), 0.5f * sum.imag()};
+		right[k] = {0.5f * diff.imag(), -0.5f * diff.real()};
 	}
+
+	spectra = stereo_spectra;
 }
 
-void MultiChannelAudioAnalyzer::compute_amplitudes(FrequencyAnalyzer &fa)
+void MultiChannelAudioAnalyzer::window_channels(
+	const FrequencyAnalyzer &fa, const float *__restrict const in, float *__restrict const out)
 {
-	for (int ch = 0; ch < num_channels; ++ch)
-		analyzers[ch].compute_amplitudes(fa);
+	const auto nc = num_channels;
+	const auto window = fa.get_window();
+	const auto *__restrict const w = window.data();
+	const auto a = fa.get_pre_emphasis();
+
+	if (!fa.get_dc_removal() && !a)
+	{
+		if (window.empty())
+			std::copy_n(in, fft_size * nc, out);
+		else
+			for (int i = 0; i < fft_size; ++i)
+#pragma GCC ivdep
+				for (int ch = 0; ch < nc; ++ch)
+					out[i * nc + ch] = in[i * nc + ch] * w[i];
+		return;
+	}
+
+	// the same as FrequencyAnalyzer::copy_to_input for each channel: the sample before the first one is taken to be
+	// equal to it, and the mean is weighted by the window
+	const auto sample = [&](const int i, const int ch) { return in[i * nc + ch] - a * in[(i ? i - 1 : 0) * nc + ch]; };
+
+	channel_means.assign(nc, 0);
+	auto *__restrict const mean = channel_means.data();
+	if (fa.get_dc_removal())
+	{
+		float window_sum{};
+		for (int i = 0; i < fft_size; ++i)
+		{
+			const auto wi = window.empty() ? 1.f : w[i];
+			window_sum += wi;
+#pragma GCC ivdep
+			for (int ch = 0; ch < nc; ++ch)
+				mean[ch] += sample(i, ch) * wi;
+		}
+		for (int ch = 0; ch < nc; ++ch)
+			mean[ch] /= window_sum;
+	}
+
+	for (int i = 0; i < fft_size; ++i)
+	{
+		const auto wi = window.empty() ? 1.f : w[i];
+#pragma GCC ivdep
+		for (int ch = 0; ch < nc; ++ch)
+			out[i * nc + ch] = (sample(i, ch) - mean[ch]) * wi;
+	}
+}
+
+void MultiChannelAudioAnalyzer::compute_amplitudes()
+{
+	if (spectra.empty())
+		throw std::logic_error{"[MultiChannelAudioAnalyzer::compute_amplitudes] execute_fft required"};
+
+	// zero-padding doesn't add energy, so normalize by the real sample count, not the transform size
+	_amplitudes.resize(spectra.size());
+	util::compute_amplitudes(_amplitudes, spectra, fft_size);
 }
 
-AudioAnalyzer &MultiChannelAudioAnalyzer::operator[](int channel)
+std::span<const float> MultiChannelAudioAnalyzer::get_amplitudes(const int channel) const
 {
 	if (channel < 0 || channel >= num_channels)
-		throw std::out_of_range{"Invalid channel index"};
-	return analyzers[channel];
+		throw std::out_of_range{"[MultiChannelAudioAnalyzer::get_amplitudes] invalid channel index"};
+	return get_amplitudes().subspan(channel * bins, bins);
+}
+
+std::span<const float> MultiChannelAudioAnalyzer::get_amplitudes() const
+{
+	if (_amplitudes.empty())
+		throw std::logic_error{"[MultiChannelAudioAnalyzer::get_amplitudes] computed amplitudes required"};
+	return _amplitudes;
 }
 
-const AudioAnalyzer &MultiChannelAudioAnalyzer::operator[](int channel) const
+std::span<const std::complex<float>> MultiChannelAudioAnalyzer::get_spectrum(const int channel) const
 {
 	if (channel < 0 || channel >= num_channels)
-		throw std::out_of_range{"Invalid channel index"};
-	return analyzers[channel];
+		throw std::out_of_range{"[MultiChannelAudioAnalyzer::get_spectrum] invalid channel index"};
+	if (spectra.empty())
+		throw std::logic_error{"[MultiChannelAudioAnalyzer::get_spectrum] execute_fft required"};
+	return spectra.subspan(channel * bins, bins);
+}
+
+AudioAnalyzer::FrequencyAmplitudePair MultiChannelAudioAnalyzer::compute_peak_frequency(
+	const FrequencyAnalyzer &fa,
+	const int channel,
+	const float sample_rate_hz,
+	const int from_hz,
+	const int to_hz) const
+{
+	const auto amps = get_amplitudes(channel);
+	const auto transform_size = fa.get_transform_size();
+	const auto idx = util::find_peak_bin(amps, sample_rate_hz, transform_size, from_hz, to_hz);
+	return {(int)(idx * sample_rate_hz / transform_size), amps[idx]};
 }
 
 AudioAnalyzer::FrequencyAmplitudePair MultiChannelAudioAnalyzer::compute_averaged_peak_frequency(
-	const FrequencyAnalyzer &fa, int sample_rate_hz, int from_hz, int to_hz)
+	const FrequencyAnalyzer &fa, float sample_rate_hz, int from_hz, int to_hz) const
 {
 	float total_freq = 0.f;
 	float total_amp = 0.f;
 
-	for (auto &analyzer : analyzers)
+	for (int ch = 0; ch < num_channels; ++ch)
 	{
-		auto [freq, amp] = analyzer.compute_peak_frequency(fa, sample_rate_hz, from_hz, to_hz);
+		auto [freq, amp] = compute_peak_frequency(fa, ch, sample_rate_hz, from_hz, to_hz);
 		total_freq += freq;
 		total_amp += amp;
 	}
@@ -67,4 +197,28 @@ AudioAnalyzer::FrequencyAmplitudePair MultiChannelAudioAnalyzer::compute_average
 	return {static_cast<int>(total_freq / num_channels), total_amp / num_channels};
 }
 
+PeakEstimator::Estimate MultiChannelAudioAnalyzer::estimate_averaged_peak_frequency(
+	const FrequencyAnalyzer &fa,
+	const float sample_rate_hz,
+	const int from_hz,
+	const int to_hz,
+	std::span<PeakEstimator> estimators,
+	const int hop) const
+{
+	if ((int)estimators.size() != num_channels)
+		throw std::invalid_argument{
+			"[MultiChannelAudioAnalyzer::estimate_averaged_peak_frequency] need one estimator per channel"};
+
+	PeakEstimator::Estimate total{};
+	for (int ch = 0; ch < num_channels; ++ch)
+	{
+		const auto [freq, amp] = estimators[ch].estimate(
+			get_spectrum(ch), get_amplitudes(ch), sample_rate_hz, fa.get_transform_size(), hop, from_hz, to_hz);
+		total.frequency_hz += freq;
+		total.amplitude += amp;
+	}
+
+	return {total.frequency_hz / num_channels, total.amplitude / num_channels};
+}
+
 } // namespace avz
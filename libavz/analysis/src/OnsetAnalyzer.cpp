@@ -0,0 +1,143 @@
+#include <avz/analysis/OnsetAnalyzer.hpp>
+#include <avz/analysis/PeakEstimator.hpp>
+#include <avz/analysis/simd.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace avz
+{
+
+namespace
+{
+
+// time constant of the running mean flux behind the adaptive threshold
+constexpr float mean_time_sec = 0.5f;
+
+// listeners favor tempos around 120 bpm; the autocorrelation of a steady beat also peaks at
+// multiples of its period, so this prior settles which of them is reported
+constexpr float preferred_bpm = 120, prior_octaves = 1;
+
+} // namespace
+
+OnsetAnalyzer::OnsetAnalyzer(
+	const float frame_rate_hz, const float min_bpm, const float max_bpm, const float tempo_memory_sec)
+	: frame_rate_hz{frame_rate_hz}
+{
+	if (frame_rate_hz <= 0 || tempo_memory_sec <= 0)
+		throw std::invalid_argument{"[OnsetAnalyzer] frame_rate_hz and tempo_memory_sec must be > 0"};
+	if (min_bpm <= 0 || min_bpm >= max_bpm)
+		throw std::invalid_argument{"[OnsetAnalyzer] tempo range must satisfy 0 < min_bpm < max_bpm"};
+
+	min_lag = std::max(1, (int)floorf(60 * frame_rate_hz / max_bpm));
+	max_lag = (int)ceilf(60 * frame_rate_hz / min_bpm);
+	if (max_lag - min_lag < 2)
+		throw std::invalid_argument{"[OnsetAnalyzer] tempo range spans fewer than 3 lags at this frame rate"};
+
+	mean_decay = expf(-1 / (mean_time_sec * frame_rate_hz));
+	acf_decay = expf(-1 / (tempo_memory_sec * frame_rate_hz));
+
+	const auto lags = max_lag - min_lag + 1;
+	lag_weights.resize(lags);
+	for (int i = 0; i < lags; ++i)
+	{
+		const auto octaves = log2f(60 * frame_rate_hz / (min_lag + i) / preferred_bpm) / prior_octaves;
+		lag_weights[i] = expf(-0.5f * octaves * octaves);
+	}
+	scores.resize(lags);
+
+	set_min_interval(0.1f);
+	reset();
+}
+
+void OnsetAnalyzer::set_threshold(const float multiplier, const float offset)
+{
+	threshold_multiplier = multiplier;
+	threshold_offset = offset;
+}
+
+void OnsetAnalyzer::set_min_interval(const float seconds)
+{
+	min_interval = std::max(1, (int)lroundf(seconds * frame_rate_hz));
+}
+
+void OnsetAnalyzer::reset()
+{
+	prev_amplitudes.clear();
+	flux[0] = flux[1] = threshold = flux_sum = frame_weight = 0;
+	frames_since_onset = min_interval;
+	onset = false;
+	novelty.assign(2 * max_lag, 0);
+	novelty_pos = 0;
+	acf.assign(max_lag - min_lag + 1, 0);
+	energy = tempo_bpm = tempo_confidence = 0;
+}
+
+bool OnsetAnalyzer::process(std::span<const float> amplitudes)
+{
+	onset = false;
+	if (prev_amplitudes.size() != amplitudes.size())
+	{
+		prev_amplitudes.assign(amplitudes.begin(), amplitudes.end());
+		return false;
+	}
+
+	const auto new_flux = amplitudes.empty() ? 0 : simd::spectral_flux(amplitudes, prev_amplitudes) / amplitudes.size();
+	std::ranges::copy(amplitudes, prev_amplitudes.begin());
+
+	// the previous frame is an onset if its flux beat both neighbours and its own threshold
+	++frames_since_onset;
+	if (flux[0] > threshold && flux[0] >= flux[1] && flux[0] > new_flux && frames_since_onset > min_interval)
+	{
+		onset = true;
+		frames_since_onset = 0;
+	}
+
+	// compare against the mean of earlier frames, so a sudden onset doesn't raise its own threshold
+	const auto mean = frame_weight ? flux_sum / frame_weight : new_flux;
+	threshold = mean * threshold_multiplier + threshold_offset;
+	flux[1] = flux[0];
+	flux[0] = new_flux;
+
+	update_tempo(std::max(new_flux - mean, 0.f));
+	flux_sum = mean_decay * flux_sum + new_flux;
+	frame_weight = mean_decay * frame_weight + 1;
+
+	return onset;
+}
+
+void OnsetAnalyzer::update_tempo(const float x)
+{
+	// the novelty value `l` frames ago is at novelty_pos + max_lag - l, so the lag window runs backwards from `past`
+	const auto lags = (int)acf.size();
+	const auto *__restrict const past = novelty.data() + novelty_pos + max_lag - min_lag;
+	auto *__restrict const a = acf.data();
+	const auto decay = acf_decay;
+#pragma GCC ivdep
+	for (int i = 0; i < lags; ++i)
+		a[i] = decay * a[i] + x * past[-i];
+	energy = decay * energy + x * x;
+
+	novelty[novelty_pos] = novelty[novelty_pos + max_lag] = x;
+	if (++novelty_pos == max_lag)
+		novelty_pos = 0;
+
+	if (energy <= 0)
+		return;
+
+	for (int i = 0; i < lags; ++i)
+		scores[i] = std::max(a[i], 0.f) * lag_weights[i];
+	const auto best = (int)std::distance(scores.begin(), std::ranges::max_element(scores));
+	if (scores[best] <= 0)
+	{
+		tempo_bpm = tempo_confidence = 0;
+		return;
+	}
+
+	const auto [lag, _] = PeakEstimator::interpolate(scores, best, PeakEstimator::Interpolation::Quadratic);
+	tempo_bpm = 60 * frame_rate_hz / (min_lag + lag);
+	tempo_confidence = std::min(a[best] / energy, 1.f);
+}
+
+} // namespace avz
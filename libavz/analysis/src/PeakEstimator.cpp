@@ -0,0 +1,103 @@
+#include <avz/analysis/PeakEstimator.hpp>
+#include <avz/analysis/util.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace avz
+{
+
+PeakEstimator::PeakEstimator(const Interpolation interpolation, const bool phase_vocoder)
+	: interpolation{interpolation},
+	  phase_vocoder{phase_vocoder}
+{
+}
+
+void PeakEstimator::set_phase_vocoder(const bool enabled)
+{
+	phase_vocoder = enabled;
+	reset();
+}
+
+void PeakEstimator::reset()
+{
+	prev_spectrum.clear();
+	prev_transform_size = 0;
+}
+
+std::pair<float, float>
+PeakEstimator::interpolate(std::span<const float> amplitudes, const int peak_bin, Interpolation interpolation)
+{
+	assert(peak_bin >= 0 && peak_bin < (int)amplitudes.size());
+	const auto b = amplitudes[peak_bin];
+
+	// both neighbours are needed
+	if (interpolation == Interpolation::None || peak_bin == 0 || peak_bin == (int)amplitudes.size() - 1)
+		return {peak_bin, b};
+
+	auto a = amplitudes[peak_bin - 1], c = amplitudes[peak_bin + 1];
+
+	// the log of a silent bin is undefined; fall back to the plain parabola
+	const bool gaussian = interpolation == Interpolation::Gaussian && a > 0 && b > 0 && c > 0;
+	if (gaussian)
+	{
+		a = logf(a);
+		c = logf(c);
+	}
+	const auto y = gaussian ? logf(b) : b;
+
+	const auto denom = a - 2 * y + c;
+	if (denom >= 0)
+		// not a strict maximum (e.g. a flat top), nothing to refine
+		return {peak_bin, b};
+
+	const auto delta = std::clamp(0.5f * (a - c) / denom, -0.5f, 0.5f);
+	const auto peak = y - 0.25f * (a - c) * delta;
+	return {peak_bin + delta, gaussian ? expf(peak) : peak};
+}
+
+PeakEstimator::Estimate PeakEstimator::estimate(
+	std::span<const std::complex<float>> spectrum,
+	std::span<const float> amplitudes,
+	const float sample_rate_hz,
+	const int transform_size,
+	const int hop,
+	const int from_hz,
+	const int to_hz)
+{
+	const auto peak_bin = util::find_peak_bin(amplitudes, sample_rate_hz, transform_size, from_hz, to_hz);
+	auto [bin, amplitude] = interpolate(amplitudes, peak_bin, interpolation);
+	const auto bin_size = sample_rate_hz / transform_size;
+	auto frequency_hz = bin * bin_size;
+
+	if (!phase_vocoder)
+		return {frequency_hz, amplitude};
+
+	assert(spectrum.size() == amplitudes.size());
+
+	// the tracked range, clamped like find_peak_bin does
+	const auto last_bin = (int)amplitudes.size() - 1;
+	const auto first = std::min((int)(from_hz / bin_size), last_bin);
+	const auto last = std::min((int)(to_hz / bin_size), last_bin);
+
+	const auto prev_index = peak_bin - prev_first_bin;
+	if (hop > 0 && prev_transform_size == transform_size && prev_index >= 0 && prev_index < (int)prev_spectrum.size()
+		&& std::abs(prev_spectrum[prev_index]) > 0 && std::abs(spectrum[peak_bin]) > 0)
+	{
+		// a tone at f advances 2*pi*f*hop/sample_rate radians in phase per hop; predict the advance
+		// from the interpolated estimate, and read the remaining offset from the (wrapped) prediction error
+		const auto advance = std::arg(spectrum[peak_bin]) - std::arg(prev_spectrum[prev_index]);
+		const auto predicted = 2 * M_PI * frequency_hz * hop / sample_rate_hz;
+		const auto error = std::remainder(advance - predicted, 2 * M_PI);
+		frequency_hz += error * sample_rate_hz / (2 * M_PI * hop);
+	}
+
+	prev_spectrum.assign(spectrum.begin() + first, spectrum.begin() + last + 1);
+	prev_first_bin = first;
+	prev_transform_size = transform_size;
+
+	return {frequency_hz, amplitude};
+}
+
+} // namespace avz
@@ -0,0 +1,241 @@
+#include <avz/analysis/SlidingDftAnalyzer.hpp>
+#include <avz/analysis/util.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+
+namespace avz
+{
+
+namespace
+{
+
+// window functions as a sum of cosines: w[n] = a0 - a1 * cos(2*pi*n/N) + a2 * cos(4*pi*n/N)
+struct CosineSum
+{
+	double a0, a1, a2;
+};
+
+CosineSum cosine_sum_of(const FrequencyAnalyzer::WindowFunction wf)
+{
+	switch (wf)
+	{
+	case FrequencyAnalyzer::WindowFunction::None:
+		return {1, 0, 0};
+	case FrequencyAnalyzer::WindowFunction::Hanning:
+		return {0.5, 0.5, 0};
+	case FrequencyAnalyzer::WindowFunction::Hamming:
+		return {0.54, 0.46, 0};
+	case FrequencyAnalyzer::WindowFunction::Blackman:
+		return {0.42, 0.5, 0.08};
+	default:
+		throw std::logic_error{"[SlidingDftAnalyzer] unsupported window function"};
+	}
+}
+
+} // namespace
+
+SlidingDftAnalyzer::SlidingDftAnalyzer(
+	const int window_size, const int sample_rate_hz, const int from_hz, const int to_hz)
+	: window_size{window_size},
+	  sample_rate_hz{sample_rate_hz},
+	  reanchor_interval{window_size}
+{
+	if (window_size < 4)
+		throw std::invalid_argument{"[SlidingDftAnalyzer] window_size must be >= 4"};
+	if (from_hz < 0 || from_hz >= to_hz)
+		throw std::invalid_argument{"[SlidingDftAnalyzer] frequency range must satisfy 0 <= from_hz < to_hz"};
+
+	const auto nyquist_bin = window_size / 2;
+	first_bin = util::bin_index_from_freq(from_hz, sample_rate_hz, window_size);
+	last_bin = std::min(util::bin_index_from_freq(to_hz, sample_rate_hz, window_size), nyquist_bin);
+	if (first_bin > last_bin)
+		throw std::invalid_argument{"[SlidingDftAnalyzer] frequency range is above nyquist"};
+
+	// the window kernels reach 2 bins to each side; anything outside [0, nyquist]
+	// is mirrored back into the tracked range using the symmetry of a real signal's spectrum
+	first_tracked = std::max(0, first_bin - 2);
+	last_tracked = std::min(nyquist_bin, last_bin + 2);
+
+	const auto tracked = last_tracked - first_tracked + 1;
+	bins_re.assign(tracked, 0);
+	bins_im.assign(tracked, 0);
+	twiddles_re.resize(tracked);
+	twiddles_im.resize(tracked);
+	for (int i = 0; i < tracked; ++i)
+	{
+		const auto w = 2 * M_PI * (first_tracked + i) / window_size;
+		twiddles_re[i] = cos(w);
+		twiddles_im[i] = sin(w);
+	}
+
+	history.assign(window_size, 0);
+}
+
+void SlidingDftAnalyzer::set_reanchor_interval(const int samples)
+{
+	if (samples <= 0)
+		throw std::invalid_argument{"[SlidingDftAnalyzer::set_reanchor_interval] samples must be > 0"};
+	reanchor_interval = samples;
+}
+
+void SlidingDftAnalyzer::prime(std::span<const float> window, const int num_channels, const int channel)
+{
+	assert(window.size() >= window_size * num_channels);
+	util::extract_channel(history, window, num_channels, channel);
+	history_pos = 0;
+	reanchor();
+	primed = true;
+}
+
+void SlidingDftAnalyzer::push(std::span<const float> samples, const int num_channels, const int channel)
+{
+	const auto frames = samples.size() / num_channels;
+	const auto tracked = bins_re.size();
+
+	auto *__restrict const re = bins_re.data();
+	auto *__restrict const im = bins_im.data();
+	const auto *__restrict const tw_re = twiddles_re.data();
+	const auto *__restrict const tw_im = twiddles_im.data();
+
+	for (size_t f = 0; f < frames; ++f)
+	{
+		const float x = samples[f * num_channels + channel];
+		const double delta = x - history[history_pos];
+		history[history_pos] = x;
+		if (++history_pos == window_size)
+			history_pos = 0;
+
+		// X_k <- (X_k + x_new - x_old) * e^(j*2*pi*k/N)
+#pragma GCC ivdep
+		for (size_t k = 0; k < tracked; ++k)
+		{
+			const auto r = re[k] + delta, i = im[k];
+			re[k] = r * tw_re[k] - i * tw_im[k];
+			im[k] = r * tw_im[k] + i * tw_re[k];
+		}
+
+		if (++samples_since_anchor >= reanchor_interval)
+			reanchor();
+	}
+}
+
+void SlidingDftAnalyzer::update(std::span<const float> audio, const int hop, const int num_channels, const int channel)
+{
+	assert(audio.size() >= window_size * num_channels);
+
+	if (!primed || hop >= window_size)
+	{
+		prime(audio, num_channels, channel);
+		return;
+	}
+
+	push(audio.subspan((window_size - hop) * num_channels, hop * num_channels), num_channels, channel);
+}
+
+void SlidingDftAnalyzer::reanchor()
+{
+	// goertzel over the whole history, oldest sample first, for every tracked bin at once
+	const auto tracked = bins_re.size();
+	std::fill(bins_re.begin(), bins_re.end(), 0);
+	std::fill(bins_im.begin(), bins_im.end(), 0);
+
+	// reuse the bin storage for the goertzel state: re = s[n-1], im = s[n-2]
+	auto *__restrict const s1 = bins_re.data();
+	auto *__restrict const s2 = bins_im.data();
+	const auto *__restrict const tw_re = twiddles_re.data();
+
+	for (int n = 0; n < window_size; ++n)
+	{
+		const double x = history[(history_pos + n) % window_size];
+#pragma GCC ivdep
+		for (size_t k = 0; k < tracked; ++k)
+		{
+			const auto s0 = x + 2 * tw_re[k] * s1[k] - s2[k];
+			s2[k] = s1[k];
+			s1[k] = s0;
+		}
+	}
+
+	// X_k = e^(j*w) * s[N-1] - s[N-2]
+	for (size_t k = 0; k < tracked; ++k)
+	{
+		const auto last = s1[k], second_last = s2[k];
+		bins_re[k] = twiddles_re[k] * last - second_last;
+		bins_im[k] = twiddles_im[k] * last;
+	}
+
+	samples_since_anchor = 0;
+}
+
+void SlidingDftAnalyzer::compute_amplitudes()
+{
+	const auto [a0, a1, a2] = cosine_sum_of(window_func);
+	const auto inv_window_size = 1.f / window_size;
+
+	const auto raw = [&](int k) -> std::complex<double>
+	{
+		bool mirrored{};
+		if (k < 0)
+			k = -k, mirrored = true;
+		else if (k > window_size / 2)
+			k = window_size - k, mirrored = true;
+		const std::complex<double> x{bins_re[k - first_tracked], bins_im[k - first_tracked]};
+		return mirrored ? std::conj(x) : x;
+	};
+
+	_amplitudes.resize(last_bin - first_bin + 1);
+	for (int k = first_bin; k <= last_bin; ++k)
+	{
+		auto x = a0 * raw(k) - 0.5 * a1 * (raw(k - 1) + raw(k + 1));
+		if (a2)
+			x += 0.5 * a2 * (raw(k - 2) + raw(k + 2));
+		_amplitudes[k - first_bin] = std::abs(x) * inv_window_size;
+	}
+}
+
+std::span<const float> SlidingDftAnalyzer::get_amplitudes() const
+{
+	if (_amplitudes.empty())
+		throw std::logic_error{"[SlidingDftAnalyzer::get_amplitudes] computed amplitudes required"};
+	return _amplitudes;
+}
+
+std::pair<int, int> SlidingDftAnalyzer::bin_range(const int from_hz, const int to_hz) const
+{
+	assert(from_hz < to_hz);
+	const auto start = std::clamp(util::bin_index_from_freq(from_hz, sample_rate_hz, window_size), first_bin, last_bin);
+	const auto end = std::clamp(util::bin_index_from_freq(to_hz, sample_rate_hz, window_size), first_bin, last_bin);
+	return {start - first_bin, end - first_bin};
+}
+
+AudioAnalyzer::FrequencyAmplitudePair
+SlidingDftAnalyzer::compute_peak_frequency(const int from_hz, const int to_hz) const
+{
+	if (_amplitudes.empty())
+		throw std::logic_error{"[SlidingDftAnalyzer::compute_peak_frequency] computed amplitudes required"};
+
+	const auto [start, end] = bin_range(from_hz, to_hz);
+	const auto amps_begin = _amplitudes.begin();
+	const auto max_it = std::max_element(amps_begin + start, amps_begin + end + 1);
+	const auto idx = first_bin + std::distance(amps_begin, max_it);
+
+	return {util::freq_from_bin_index(idx, sample_rate_hz, window_size), *max_it};
+}
+
+float SlidingDftAnalyzer::compute_band_energy(const int from_hz, const int to_hz) const
+{
+	if (_amplitudes.empty())
+		throw std::logic_error{"[SlidingDftAnalyzer::compute_band_energy] computed amplitudes required"};
+
+	const auto [start, end] = bin_range(from_hz, to_hz);
+	float energy{};
+	for (int i = start; i <= end; ++i)
+		energy += _amplitudes[i] * _amplitudes[i];
+	return energy;
+}
+
+} // namespace avz
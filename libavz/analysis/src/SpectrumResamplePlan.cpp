@@ -0,0 +1,120 @@
+#include <avz/analysis/SpectrumResamplePlan.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+
+namespace avz
+{
+
+SpectrumResamplePlan::SpectrumResamplePlan(const Interpolator::InterpolationType type)
+	: type{type}
+{
+}
+
+SpectrumResamplePlan::SpectrumResamplePlan(const Grid &grid, const Interpolator::InterpolationType type)
+	: type{type}
+{
+	set_grid(grid);
+}
+
+void SpectrumResamplePlan::set_grid(const Grid &grid)
+{
+	if (!first_bin.empty() && grid == this->grid)
+		return;
+
+	if (grid.out_size <= 0 || grid.sample_rate_hz <= 0)
+		throw std::invalid_argument{"[SpectrumResamplePlan::set_grid] out_size and sample_rate_hz must be > 0"};
+	if (grid.fft_size < 6)
+		throw std::invalid_argument{"[SpectrumResamplePlan::set_grid] fft_size must be >= 6"};
+
+	this->grid = grid;
+	compile();
+}
+
+void SpectrumResamplePlan::set_interp_type(const Interpolator::InterpolationType type)
+{
+	if (type == this->type)
+		return;
+	this->type = type;
+	if (!first_bin.empty())
+		compile();
+}
+
+void SpectrumResamplePlan::compile()
+{
+	in_size = grid.fft_size / 2 + 1;
+
+	const float bin_size = grid.sample_rate_hz / grid.fft_size;
+	const float bin_pos_start = grid.start_freq / bin_size;
+	const float bin_pos_end = grid.end_freq / bin_size;
+	const float bin_pos_step = (bin_pos_end - bin_pos_start) / std::max(1, grid.out_size - 1);
+
+	first_bin.resize(grid.out_size);
+	weights.resize(grid.out_size);
+
+	for (int i = 0; i < grid.out_size; ++i)
+	{
+		const auto x = std::clamp(bin_pos_start + i * bin_pos_step, 0.f, (float)(in_size - 1));
+		const int k = std::min((int)x, in_size - 2);
+		const auto t = x - k;
+
+		// weights of bins k - 1, k, k + 1, k + 2
+		using Vec = std::array<float, 4>;
+		Vec w;
+		if (type == Interpolator::InterpolationType::LINEAR)
+			w = {0, 1 - t, t, 0};
+		else
+		{
+			const auto axpy = [](Vec &y, const float a, const Vec &x)
+			{
+				for (int j = 0; j < 4; ++j)
+					y[j] += a * x[j];
+			};
+
+			// tangents (p[k + 1] - p[k - 1]) / 2 (catmull-rom), or the secant at the first and last bin,
+			// like `Spline::Type::HERMITE` on evenly spaced knots
+			const Vec secant{0, -1, 1, 0};
+			const auto m0 = k == 0 ? secant : Vec{-0.5f, 0, 0.5f, 0};
+			const auto m1 = k + 1 == in_size - 1 ? secant : Vec{0, -0.5f, 0, 0.5f};
+
+			// cubic hermite basis
+			const auto t2 = t * t, t3 = t2 * t;
+			w = {0, 2 * t3 - 3 * t2 + 1, -2 * t3 + 3 * t2, 0};
+			axpy(w, t3 - 2 * t2 + t, m0);
+			axpy(w, t3 - t2, m1);
+		}
+
+		// at the edges, fold the taps that fall outside the spectrum onto the nearest bin,
+		// keeping all 4 taps inside [base, base + 4)
+		const auto base = std::clamp(k - 1, 0, in_size - 4);
+		auto &row = weights[i];
+		row = {};
+		for (int j = 0; j < 4; ++j)
+			row[std::clamp(k - 1 + j, 0, in_size - 1) - base] += w[j];
+		first_bin[i] = base;
+	}
+}
+
+void SpectrumResamplePlan::execute(std::span<float> out, std::span<const float> in_amps) const
+{
+	if (first_bin.empty())
+		throw std::logic_error{"[SpectrumResamplePlan::execute] set_grid required"};
+	assert(out.size() == (size_t)grid.out_size);
+	assert(in_amps.size() >= (size_t)in_size);
+
+	auto *__restrict const out_ptr = out.data();
+	const auto *__restrict const in_ptr = in_amps.data();
+	const auto *__restrict const first = first_bin.data();
+	const auto *__restrict const w = weights.data();
+
+#pragma GCC ivdep
+	for (int i = 0; i < grid.out_size; ++i)
+	{
+		const auto *__restrict const x = in_ptr + first[i];
+		out_ptr[i] = w[i][0] * x[0] + w[i][1] * x[1] + w[i][2] * x[2] + w[i][3] * x[3];
+	}
+}
+
+} // namespace avz
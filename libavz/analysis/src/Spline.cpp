@@ -0,0 +1,253 @@
+#include <avz/analysis/Spline.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace avz
+{
+
+void Spline::reserve(const size_t n)
+{
+	for (auto *const v : {&x, &y, &b, &c, &d, &factored_x, &upper, &inv_pivot, &scratch})
+		v->reserve(n);
+}
+
+void Spline::set_points(std::span<const float> x, std::span<const float> y)
+{
+	assert(x.size() == y.size());
+	assert(std::ranges::is_sorted(x));
+	this->x.assign(x.begin(), x.end());
+	this->y.assign(y.begin(), y.end());
+	uniform = false;
+	fit();
+}
+
+void Spline::set_values(std::span<const float> values)
+{
+	const auto n = values.size();
+	if (!uniform || x.size() != n)
+	{
+		x.resize(n);
+		for (size_t i = 0; i < n; ++i)
+			x[i] = i;
+		uniform = true;
+	}
+	y.assign(values.begin(), values.end());
+	fit();
+}
+
+void Spline::fit()
+{
+	const auto n = x.size();
+	b.resize(n);
+	c.resize(n);
+	d.resize(n);
+
+	if (n < 2)
+	{
+		std::ranges::fill(b, 0);
+		std::ranges::fill(c, 0);
+		std::ranges::fill(d, 0);
+		return;
+	}
+
+	// secants, stored in b until the type-specific fit replaces them with slopes
+	{
+		const auto *__restrict const xp = x.data();
+		const auto *__restrict const yp = y.data();
+		auto *__restrict const s = b.data();
+#pragma GCC ivdep
+		for (size_t i = 0; i < n - 1; ++i)
+			s[i] = (yp[i + 1] - yp[i]) / (xp[i + 1] - xp[i]);
+	}
+
+	switch (type)
+	{
+	case Type::LINEAR:
+		std::ranges::fill(c, 0);
+		std::ranges::fill(d, 0);
+		b[n - 1] = b[n - 2];
+		break;
+	case Type::NATURAL:
+		fit_natural();
+		break;
+	case Type::HERMITE:
+	case Type::MONOTONE:
+		compute_slopes();
+		fit_hermite(scratch);
+		break;
+	}
+}
+
+void Spline::fit_natural()
+{
+	// with c[i] = half the second derivative at x[i], and c[0] = c[n - 1] = 0, for 0 < i < n - 1:
+	// h[i - 1] * c[i - 1] + 2 * (h[i - 1] + h[i]) * c[i] + h[i] * c[i + 1] = 3 * (s[i] - s[i - 1])
+	const auto n = x.size();
+	const auto *__restrict const xp = x.data();
+
+	if (factored_x != x)
+	{
+		// forward elimination of the matrix alone: only the right-hand side changes while x stays the same
+		upper.resize(n);
+		inv_pivot.resize(n);
+		upper[0] = 0;
+		for (size_t i = 1; i < n - 1; ++i)
+		{
+			const auto h0 = xp[i] - xp[i - 1], h1 = xp[i + 1] - xp[i];
+			inv_pivot[i] = 1 / (2 * (h0 + h1) - h0 * upper[i - 1]);
+			upper[i] = h1 * inv_pivot[i];
+		}
+		factored_x.assign(x.begin(), x.end());
+	}
+
+	scratch.resize(n);
+	auto *__restrict const rhs = scratch.data();
+	const auto *__restrict const s = b.data();
+#pragma GCC ivdep
+	for (size_t i = 1; i < n - 1; ++i)
+		rhs[i] = 3 * (s[i] - s[i - 1]);
+
+	// forward substitution, then back substitution
+	auto *__restrict const cp = c.data();
+	cp[0] = cp[n - 1] = 0;
+	for (size_t i = 1; i < n - 1; ++i)
+		cp[i] = (rhs[i] - (xp[i] - xp[i - 1]) * cp[i - 1]) * inv_pivot[i];
+	for (size_t i = n - 2; i > 0; --i)
+		cp[i] -= upper[i] * cp[i + 1];
+
+	auto *__restrict const bp = b.data();
+	auto *__restrict const dp = d.data();
+#pragma GCC ivdep
+	for (size_t i = 0; i < n - 1; ++i)
+	{
+		const auto h = xp[i + 1] - xp[i];
+		bp[i] -= h * (2 * cp[i] + cp[i + 1]) / 3;
+		dp[i] = (cp[i + 1] - cp[i]) / (3 * h);
+	}
+
+	// slope at the last knot, for extending the spline past it
+	const auto h = xp[n - 1] - xp[n - 2];
+	bp[n - 1] = bp[n - 2] + h * (2 * cp[n - 2] + 3 * h * dp[n - 2]);
+	dp[n - 1] = 0;
+}
+
+void Spline::compute_slopes()
+{
+	const auto n = x.size();
+	const auto *__restrict const xp = x.data();
+	const auto *__restrict const s = b.data();
+	scratch.resize(n);
+	auto *__restrict const m = scratch.data();
+
+	m[0] = s[0];
+	m[n - 1] = s[n - 2];
+
+	if (type == Type::HERMITE)
+	{
+		// slope of the parabola through each knot and its two neighbours
+#pragma GCC ivdep
+		for (size_t i = 1; i < n - 1; ++i)
+		{
+			const auto h0 = xp[i] - xp[i - 1], h1 = xp[i + 1] - xp[i];
+			m[i] = (h1 * s[i - 1] + h0 * s[i]) / (h0 + h1);
+		}
+		return;
+	}
+
+	// fritsch-carlson: flat at local extrema, averaged secants elsewhere...
+#pragma GCC ivdep
+	for (size_t i = 1; i < n - 1; ++i)
+		m[i] = s[i - 1] * s[i] <= 0 ? 0 : (s[i - 1] + s[i]) / 2;
+
+	// ...then scaled down wherever the cubic would overshoot
+	for (size_t i = 0; i < n - 1; ++i)
+	{
+		if (!s[i])
+		{
+			m[i] = m[i + 1] = 0;
+			continue;
+		}
+		const auto alpha = m[i] / s[i], beta = m[i + 1] / s[i];
+		const auto r = alpha * alpha + beta * beta;
+		if (r > 9)
+		{
+			const auto tau = 3 / sqrtf(r);
+			m[i] = tau * alpha * s[i];
+			m[i + 1] = tau * beta * s[i];
+		}
+	}
+}
+
+void Spline::fit_hermite(std::span<const float> slopes)
+{
+	const auto n = x.size();
+	const auto *__restrict const xp = x.data();
+	const auto *__restrict const m = slopes.data();
+	auto *__restrict const bp = b.data();
+	auto *__restrict const cp = c.data();
+	auto *__restrict const dp = d.data();
+
+#pragma GCC ivdep
+	for (size_t i = 0; i < n - 1; ++i)
+	{
+		const auto h = xp[i + 1] - xp[i], s = bp[i];
+		bp[i] = m[i];
+		cp[i] = (3 * s - 2 * m[i] - m[i + 1]) / h;
+		dp[i] = (m[i] + m[i + 1] - 2 * s) / (h * h);
+	}
+
+	bp[n - 1] = m[n - 1];
+	cp[n - 1] = dp[n - 1] = 0;
+}
+
+float Spline::eval(const size_t segment, const float X) const
+{
+	const auto dx = X - x[segment];
+
+	// extend linearly before the first knot
+	if (dx < 0)
+		return y[segment] + b[segment] * dx;
+
+	return y[segment] + dx * (b[segment] + dx * (c[segment] + dx * d[segment]));
+}
+
+float Spline::operator()(const float X) const
+{
+	const auto n = x.size();
+	if (!n)
+		return 0;
+
+	size_t segment;
+	if (uniform)
+		segment = std::clamp(floorf(X), 0.f, (float)(n - 1));
+	else
+	{
+		const auto it = std::upper_bound(x.begin(), x.end(), X);
+		segment = it == x.begin() ? 0 : it - x.begin() - 1;
+	}
+
+	return eval(segment, X);
+}
+
+void Spline::sample_sorted(std::span<const float> xs, std::span<float> out) const
+{
+	assert(xs.size() == out.size());
+	const auto n = x.size();
+	if (!n)
+	{
+		std::ranges::fill(out, 0);
+		return;
+	}
+
+	size_t segment{};
+	for (size_t i = 0; i < xs.size(); ++i)
+	{
+		while (segment + 1 < n && x[segment + 1] <= xs[i])
+			++segment;
+		out[i] = eval(segment, xs[i]);
+	}
+}
+
+} // namespace avz
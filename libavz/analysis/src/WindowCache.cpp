@@ -0,0 +1,175 @@
+#include <avz/analysis/WindowCache.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+
+namespace avz
+{
+
+namespace
+{
+
+// the cosine recurrence below computes this many consecutive angles at once
+constexpr int lanes = 8;
+
+// the lanes are recomputed exactly this often, so rounding error in the rotation can't accumulate
+constexpr int reseed_interval = 1024;
+
+// w[n] = sum_k coeffs[k] * cos(k * 2*pi*n / (N - 1))
+void cosine_sum(std::span<float> out, std::span<const double> coeffs)
+{
+	const int size = out.size();
+	if (size == 1)
+	{
+		out[0] = 1;
+		return;
+	}
+
+	const auto theta = 2 * M_PI / (size - 1);
+	const auto step_c = cos(lanes * theta), step_s = sin(lanes * theta);
+
+	// lane j holds cos/sin of (base + j) * theta
+	std::array<double, lanes> c, s, w;
+
+	for (int base = 0; base < size; base += lanes)
+	{
+		if (base % reseed_interval == 0)
+			for (int j = 0; j < lanes; ++j)
+			{
+				c[j] = cos((base + j) * theta);
+				s[j] = sin((base + j) * theta);
+			}
+
+		// cos(k * x) from cos(x) with the chebyshev recurrence:
+		// cos((k + 1) * x) = 2 * cos(x) * cos(k * x) - cos((k - 1) * x)
+#pragma GCC ivdep
+		for (int j = 0; j < lanes; ++j)
+		{
+			double prev = 1, cur = c[j];
+			w[j] = coeffs[0] + coeffs[1] * cur;
+			for (size_t k = 2; k < coeffs.size(); ++k)
+			{
+				const auto next = 2 * c[j] * cur - prev;
+				prev = cur;
+				cur = next;
+				w[j] += coeffs[k] * cur;
+			}
+		}
+
+		const auto count = std::min(lanes, size - base);
+		for (int j = 0; j < count; ++j)
+			out[base + j] = w[j];
+
+		// rotate every lane forward by lanes * theta
+#pragma GCC ivdep
+		for (int j = 0; j < lanes; ++j)
+		{
+			const auto cj = c[j], sj = s[j];
+			c[j] = cj * step_c - sj * step_s;
+			s[j] = sj * step_c + cj * step_s;
+		}
+	}
+}
+
+// zeroth-order modified bessel function of the first kind
+double bessel_i0(const double x)
+{
+	const auto half_x = x / 2;
+	double sum = 1, term = 1;
+	for (int k = 1; term > 1e-12 * sum; ++k)
+	{
+		term *= (half_x / k) * (half_x / k);
+		sum += term;
+	}
+	return sum;
+}
+
+void kaiser(std::span<float> out, const float beta)
+{
+	const int size = out.size();
+	if (size == 1)
+	{
+		out[0] = 1;
+		return;
+	}
+
+	const auto inv_i0_beta = 1 / bessel_i0(beta);
+	for (int i = 0; i < size; ++i)
+	{
+		const auto r = 2. * i / (size - 1) - 1;
+		out[i] = bessel_i0(beta * sqrt(std::max(0., 1 - r * r))) * inv_i0_beta;
+	}
+}
+
+} // namespace
+
+WindowCache &WindowCache::instance()
+{
+	static WindowCache cache;
+	return cache;
+}
+
+WindowCache::Table
+WindowCache::get(const FrequencyAnalyzer::WindowFunction window_func, const int size, float kaiser_beta)
+{
+	if (window_func != FrequencyAnalyzer::WindowFunction::Kaiser)
+		kaiser_beta = 0;
+
+	if (size <= 0)
+		throw std::invalid_argument{"[WindowCache::get] size must be > 0"};
+
+	const Key key{window_func, size, kaiser_beta};
+	std::lock_guard lk{mu};
+
+	if (const auto it = tables.find(key); it != tables.end())
+		if (const auto table = it->second.lock())
+			return table;
+
+	auto values = std::make_shared<aligned_vector<float>>(size);
+	compute(*values, window_func, kaiser_beta);
+
+	Table table = std::move(values);
+	// drop the keys of tables nobody holds anymore, like FftwPlanCache::get
+	std::erase_if(tables, [](const auto &entry) { return entry.second.expired(); });
+	tables[key] = table;
+	return table;
+}
+
+void WindowCache::compute(
+	std::span<float> out, const FrequencyAnalyzer::WindowFunction window_func, const float kaiser_beta)
+{
+	using enum FrequencyAnalyzer::WindowFunction;
+
+	if (out.empty())
+		throw std::invalid_argument{"[WindowCache::compute] size must be > 0"};
+
+	switch (window_func)
+	{
+	case Hanning:
+		cosine_sum(out, std::array{0.5, -0.5});
+		break;
+	case Hamming:
+		cosine_sum(out, std::array{0.54, -0.46});
+		break;
+	case Blackman:
+		cosine_sum(out, std::array{0.42, -0.5, 0.08});
+		break;
+	case BlackmanHarris:
+		cosine_sum(out, std::array{0.35875, -0.48829, 0.14128, -0.01168});
+		break;
+	case FlatTop:
+		cosine_sum(out, std::array{0.21557895, -0.41663158, 0.277263158, -0.083578947, 0.006947368});
+		break;
+	case Kaiser:
+		kaiser(out, kaiser_beta);
+		break;
+	case None:
+		throw std::invalid_argument{"[WindowCache::compute] WindowFunction::None has no table"};
+	default:
+		throw std::logic_error{"[WindowCache::compute] default case hit"};
+	}
+}
+
+} // namespace avz
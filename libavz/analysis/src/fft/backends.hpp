@@ -0,0 +1,23 @@
+#pragma once
+
+// Internal to avz-analysis: plan factories of the backends compiled in with the LIBAVZ_FFT_* options.
+
+#include <avz/analysis/fft.hpp>
+
+namespace avz::fft
+{
+
+#if defined(LIBAVZ_FFT_FFTW)
+std::shared_ptr<const Plan> create_fftw_plan(Kind kind, int n, int howmany);
+#endif
+
+#if defined(LIBAVZ_FFT_POCKETFFT)
+std::shared_ptr<const Plan> create_pocketfft_plan(Kind kind, int n, int howmany);
+#endif
+
+#if defined(LIBAVZ_FFT_PFFFT)
+bool pffft_supports(Kind kind, int n);
+std::shared_ptr<const Plan> create_pffft_plan(Kind kind, int n, int howmany);
+#endif
+
+} // namespace avz::fft
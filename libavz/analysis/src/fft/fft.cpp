@@ -0,0 +1,188 @@
+#include "backends.hpp"
+
+#include <atomic>
+#include <compare>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+namespace avz::fft
+{
+
+namespace
+{
+
+// order of preference when no backend is asked for, or the requested one can't perform a transform
+constexpr Backend backends[]{Backend::Fftw, Backend::PocketFft, Backend::Pffft};
+
+// function-local, so that analyzers constructed during static initialization see the detected backend
+std::atomic<Backend> &default_backend()
+{
+	static std::atomic<Backend> backend{detect_backend()};
+	return backend;
+}
+
+// the parameters are unused if no backend is compiled in
+std::shared_ptr<const Plan> create_plan(
+	const Backend backend,
+	[[maybe_unused]] const Kind kind,
+	[[maybe_unused]] const int n,
+	[[maybe_unused]] const int howmany)
+{
+	switch (backend)
+	{
+#if defined(LIBAVZ_FFT_FFTW)
+	case Backend::Fftw:
+		return create_fftw_plan(kind, n, howmany);
+#endif
+#if defined(LIBAVZ_FFT_POCKETFFT)
+	case Backend::PocketFft:
+		return create_pocketfft_plan(kind, n, howmany);
+#endif
+#if defined(LIBAVZ_FFT_PFFFT)
+	case Backend::Pffft:
+		return create_pffft_plan(kind, n, howmany);
+#endif
+	default:
+		return nullptr;
+	}
+}
+
+// plans of every backend but FFTW, whose plans FftwPlanCache already shares
+std::shared_ptr<const Plan> get_cached_plan(const Backend backend, const Kind kind, const int n, const int howmany)
+{
+	struct Key
+	{
+		Backend backend;
+		Kind kind;
+		int n, howmany;
+		auto operator<=>(const Key &) const = default;
+	};
+
+	static std::mutex mu;
+	static std::map<Key, std::weak_ptr<const Plan>> plans;
+
+	const Key key{backend, kind, n, howmany};
+	std::lock_guard lk{mu};
+
+	if (const auto it = plans.find(key); it != plans.end())
+		if (auto plan = it->second.lock())
+			return plan;
+
+	auto plan = create_plan(backend, kind, n, howmany);
+	if (plan)
+	{
+		// drop the keys of plans nobody holds anymore, like FftwPlanCache::get
+		std::erase_if(plans, [](const auto &entry) { return entry.second.expired(); });
+		plans[key] = plan;
+	}
+	return plan;
+}
+
+} // namespace
+
+Backend detect_backend()
+{
+#if defined(LIBAVZ_FFT_DEFAULT)
+	return backend_from_name(LIBAVZ_FFT_DEFAULT);
+#else
+	for (const auto backend : backends)
+		if (is_available(backend))
+			return backend;
+	throw std::logic_error{"[avz::fft::detect_backend] no backend compiled in"};
+#endif
+}
+
+Backend get_default_backend()
+{
+	return default_backend().load(std::memory_order_relaxed);
+}
+
+void set_default_backend(const Backend backend)
+{
+	if (!is_available(backend))
+		throw std::invalid_argument{
+			std::string{"[avz::fft::set_default_backend] backend not compiled in: "} + backend_name(backend)};
+	default_backend().store(backend, std::memory_order_relaxed);
+}
+
+bool is_available(const Backend backend)
+{
+	switch (backend)
+	{
+#if defined(LIBAVZ_FFT_FFTW)
+	case Backend::Fftw:
+		return true;
+#endif
+#if defined(LIBAVZ_FFT_POCKETFFT)
+	case Backend::PocketFft:
+		return true;
+#endif
+#if defined(LIBAVZ_FFT_PFFFT)
+	case Backend::Pffft:
+		return true;
+#endif
+	default:
+		return false;
+	}
+}
+
+// `kind` only matters to PFFFT
+bool supports(const Backend backend, [[maybe_unused]] const Kind kind, const int n)
+{
+	if (!is_available(backend) || n <= 0)
+		return false;
+#if defined(LIBAVZ_FFT_PFFFT)
+	if (backend == Backend::Pffft)
+		return pffft_supports(kind, n);
+#endif
+	return true;
+}
+
+const char *backend_name(const Backend backend)
+{
+	switch (backend)
+	{
+	case Backend::Fftw:
+		return "fftw";
+	case Backend::PocketFft:
+		return "pocketfft";
+	case Backend::Pffft:
+		return "pffft";
+	default:
+		return "unknown";
+	}
+}
+
+Backend backend_from_name(const std::string_view name)
+{
+	for (const auto backend : backends)
+		if (name == backend_name(backend))
+			return backend;
+	throw std::invalid_argument{"[avz::fft::backend_from_name] unknown backend: " + std::string{name}};
+}
+
+std::shared_ptr<const Plan> get_plan(const Kind kind, const int n, const int howmany, const Backend backend)
+{
+	if (n <= 0 || howmany <= 0)
+		throw std::invalid_argument{"[avz::fft::get_plan] n and howmany must be > 0"};
+
+	const auto get = [&](const Backend b) -> std::shared_ptr<const Plan>
+	{
+		if (!supports(b, kind, n))
+			return nullptr;
+		return b == Backend::Fftw ? create_plan(b, kind, n, howmany) : get_cached_plan(b, kind, n, howmany);
+	};
+
+	if (auto plan = get(backend))
+		return plan;
+	for (const auto fallback : backends)
+		if (fallback != backend)
+			if (auto plan = get(fallback))
+				return plan;
+
+	throw std::runtime_error{"[avz::fft::get_plan] no backend can transform n=" + std::to_string(n)};
+}
+
+} // namespace avz::fft
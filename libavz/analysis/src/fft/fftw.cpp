@@ -0,0 +1,66 @@
+#include "backends.hpp"
+
+#if defined(LIBAVZ_FFT_FFTW)
+
+#include <avz/analysis/FftwPlanCache.hpp>
+
+namespace avz::fft
+{
+
+namespace
+{
+
+class FftwPlan final : public Plan
+{
+	Kind kind;
+	FftwPlanCache::Plan plan;
+
+public:
+	FftwPlan(const Kind kind, FftwPlanCache::Plan plan)
+		: kind{kind},
+		  plan{std::move(plan)}
+	{
+	}
+
+	void execute(const float *const in, float *const out, float *) const override
+	{
+		// shared plans must be executed with the new-array interface,
+		// which takes non-const pointers even though the input is preserved
+		if (kind == Kind::C2C)
+			fftwf_execute_dft(plan.get(), (fftwf_complex *)in, (fftwf_complex *)out);
+		else
+			fftwf_execute_dft_r2c(plan.get(), (float *)in, (fftwf_complex *)out);
+	}
+
+	Backend get_backend() const override { return Backend::Fftw; }
+};
+
+} // namespace
+
+std::shared_ptr<const Plan> create_fftw_plan(const Kind kind, const int n, const int howmany)
+{
+	// FftwPlanCache shares the underlying plans, and picks up changes to the default planner flags
+	auto &cache = FftwPlanCache::instance();
+	const auto flags = cache.get_default_flags();
+
+	// every buffer is aligned to simd_alignment, so fftwf_alignment_of is 0 for all of them
+	FftwPlanCache::Plan plan;
+	switch (kind)
+	{
+	case Kind::R2C:
+		plan = cache.get_r2c(n, 0, 0, flags);
+		break;
+	case Kind::C2C:
+		plan = cache.get_c2c(n, 0, 0, flags);
+		break;
+	case Kind::R2C_INTERLEAVED:
+		plan = cache.get_r2c_interleaved(n, howmany, 0, 0, flags);
+		break;
+	}
+
+	return std::make_shared<const FftwPlan>(kind, std::move(plan));
+}
+
+} // namespace avz::fft
+
+#endif
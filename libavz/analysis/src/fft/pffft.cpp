@@ -0,0 +1,103 @@
+#include "backends.hpp"
+
+#if defined(LIBAVZ_FFT_PFFFT)
+
+#include <pffft.h>
+
+#include <algorithm>
+
+namespace avz::fft
+{
+
+namespace
+{
+
+class PffftPlan final : public Plan
+{
+	Kind kind;
+	int n, howmany;
+	std::unique_ptr<PFFFT_Setup, decltype(&pffft_destroy_setup)> setup;
+
+public:
+	PffftPlan(const Kind kind, const int n, const int howmany)
+		: kind{kind},
+		  n{n},
+		  howmany{howmany},
+		  setup{pffft_new_setup(n, kind == Kind::C2C ? PFFFT_COMPLEX : PFFFT_REAL), &pffft_destroy_setup}
+	{
+	}
+
+	bool valid() const { return setup != nullptr; }
+
+	void execute(const float *const in, float *const out, float *const work) const override
+	{
+		switch (kind)
+		{
+		case Kind::C2C:
+			pffft_transform_ordered(setup.get(), in, out, work, PFFFT_FORWARD);
+			break;
+		case Kind::R2C:
+			pffft_transform_ordered(setup.get(), in, out, work, PFFFT_FORWARD);
+			unpack(out, out);
+			break;
+		case Kind::R2C_INTERLEAVED:
+		{
+			// rows after the first aren't aligned, so each channel is gathered and transformed in the work buffer
+			const auto row_size = 2 * (n / 2 + 1);
+			for (int t = 0; t < howmany; ++t)
+			{
+				for (int i = 0; i < n; ++i)
+					work[i] = in[i * howmany + t];
+				pffft_transform_ordered(setup.get(), work, work, work + n, PFFFT_FORWARD);
+				unpack(out + t * row_size, work);
+			}
+			break;
+		}
+		}
+	}
+
+	Backend get_backend() const override { return Backend::Pffft; }
+
+	size_t get_work_size() const override
+	{
+		// pffft needs n floats of scratch (2n for complex), plus a gather buffer for interleaved input
+		return kind == Kind::R2C ? n : 2 * n;
+	}
+
+private:
+	// ordered real output is r0, r(n/2), r1, i1, r2, i2, ...; move the nyquist bin to the end.
+	// `out` may alias `packed`
+	void unpack(float *const out, const float *const packed) const
+	{
+		const auto nyquist = packed[1];
+		if (out != packed)
+			std::copy(packed + 2, packed + n, out + 2);
+		out[0] = packed[0];
+		out[1] = 0;
+		out[n] = nyquist;
+		out[n + 1] = 0;
+	}
+};
+
+} // namespace
+
+bool pffft_supports(const Kind kind, int n)
+{
+	// pffft's simd layout needs real sizes to be multiples of 32, and complex ones of 16
+	if (n <= 0 || n % (kind == Kind::C2C ? 16 : 32))
+		return false;
+	for (const int p : {2, 3, 5})
+		while (n % p == 0)
+			n /= p;
+	return n == 1;
+}
+
+std::shared_ptr<const Plan> create_pffft_plan(const Kind kind, const int n, const int howmany)
+{
+	auto plan = std::make_shared<const PffftPlan>(kind, n, howmany);
+	return plan->valid() ? plan : nullptr;
+}
+
+} // namespace avz::fft
+
+#endif
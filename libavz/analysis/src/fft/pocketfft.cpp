@@ -0,0 +1,85 @@
+#include "backends.hpp"
+
+#if defined(LIBAVZ_FFT_POCKETFFT)
+
+// plans are executed on the calling thread, like every other backend
+#define POCKETFFT_NO_MULTITHREADING
+#include <pocketfft_hdronly.h>
+
+#include <algorithm>
+
+namespace avz::fft
+{
+
+namespace
+{
+
+class PocketFftRealPlan final : public Plan
+{
+	int n, howmany;
+	pocketfft::detail::pocketfft_r<float> plan;
+
+public:
+	PocketFftRealPlan(const int n, const int howmany)
+		: n{n},
+		  howmany{howmany},
+		  plan{(size_t)n}
+	{
+	}
+
+	void execute(const float *const in, float *const out, float *) const override
+	{
+		const auto row_size = 2 * (n / 2 + 1);
+		for (int t = 0; t < howmany; ++t)
+		{
+			// the transform is in-place and packs its output as r0, r1, i1, r2, i2, ...
+			// so starting it one float into the row lines bins 1 and up with their complex slots
+			auto *const row = out + t * row_size;
+			for (int i = 0; i < n; ++i)
+				row[i + 1] = in[i * howmany + t];
+			plan.exec(row + 1, 1.f, true);
+
+			// the imaginary parts of dc and nyquist are implied zeros
+			row[0] = row[1];
+			row[1] = 0;
+			if (n % 2 == 0)
+				row[n + 1] = 0;
+		}
+	}
+
+	Backend get_backend() const override { return Backend::PocketFft; }
+};
+
+class PocketFftComplexPlan final : public Plan
+{
+	int n;
+	pocketfft::detail::pocketfft_c<float> plan;
+
+public:
+	PocketFftComplexPlan(const int n)
+		: n{n},
+		  plan{(size_t)n}
+	{
+	}
+
+	void execute(const float *const in, float *const out, float *) const override
+	{
+		std::copy(in, in + 2 * n, out);
+		plan.exec((pocketfft::detail::cmplx<float> *)out, 1.f, true);
+	}
+
+	Backend get_backend() const override { return Backend::PocketFft; }
+};
+
+} // namespace
+
+std::shared_ptr<const Plan> create_pocketfft_plan(const Kind kind, const int n, const int howmany)
+{
+	if (kind == Kind::C2C)
+		return std::make_shared<const PocketFftComplexPlan>(n);
+	return std::make_shared<const PocketFftRealPlan>(n, howmany);
+}
+
+} // namespace avz::fft
+
+#endif
@@ -0,0 +1,107 @@
+// compiled with -mavx2 -mfma (see CMakeLists.txt), only called after checking the CPU supports them
+#include "kernels.hpp"
+
+#if defined(LIBAVZ_SIMD_X86)
+
+#include <immintrin.h>
+
+namespace avz::simd
+{
+
+namespace
+{
+
+// |c|^2 of 8 consecutive complex numbers
+inline __m256 norm8(const float *const in)
+{
+	const auto a = _mm256_loadu_ps(in), b = _mm256_loadu_ps(in + 8);
+	// hadd pairs re^2 + im^2 within each 128-bit lane: [c0 c1 c4 c5 | c2 c3 c6 c7]
+	const auto h = _mm256_hadd_ps(_mm256_mul_ps(a, a), _mm256_mul_ps(b, b));
+	return _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(h), _MM_SHUFFLE(3, 1, 2, 0)));
+}
+
+void magnitude(float *const out, const float *const in, const size_t n, const float scale)
+{
+	const auto s = _mm256_set1_ps(scale);
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8)
+		_mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_sqrt_ps(norm8(in + 2 * i)), s));
+	scalar_kernels.magnitude(out + i, in + 2 * i, n - i, scale);
+}
+
+void power(float *const out, const float *const in, const size_t n, const float scale)
+{
+	const auto s = _mm256_set1_ps(scale);
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8)
+		_mm256_storeu_ps(out + i, _mm256_mul_ps(norm8(in + 2 * i), s));
+	scalar_kernels.power(out + i, in + 2 * i, n - i, scale);
+}
+
+float magnitude_max(float *const out, const float *const in, const size_t n, const float scale)
+{
+	const auto s = _mm256_set1_ps(scale);
+	auto vmax = _mm256_setzero_ps();
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8)
+	{
+		const auto m = _mm256_mul_ps(_mm256_sqrt_ps(norm8(in + 2 * i)), s);
+		_mm256_storeu_ps(out + i, m);
+		vmax = _mm256_max_ps(vmax, m);
+	}
+
+	auto m4 = _mm_max_ps(_mm256_castps256_ps128(vmax), _mm256_extractf128_ps(vmax, 1));
+	m4 = _mm_max_ps(m4, _mm_movehl_ps(m4, m4));
+	m4 = _mm_max_ss(m4, _mm_shuffle_ps(m4, m4, 1));
+	const auto tail_max = scalar_kernels.magnitude_max(out + i, in + 2 * i, n - i, scale);
+	const auto head_max = _mm_cvtss_f32(m4);
+	return head_max > tail_max ? head_max : tail_max;
+}
+
+void log2_scaled(float *const out, const float *const in, const size_t n, const float multiplier, const float floor)
+{
+	const auto vfloor = _mm256_set1_ps(floor), vmul = _mm256_set1_ps(multiplier), one = _mm256_set1_ps(1);
+	const auto mantissa_mask = _mm256_set1_epi32(0x7fffff), exponent_bias = _mm256_set1_epi32(127);
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8)
+	{
+		const auto bits = _mm256_castps_si256(_mm256_max_ps(_mm256_loadu_ps(in + i), vfloor));
+		// inputs are clamped to a positive floor, so the sign bit is clear
+		const auto exponent = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), exponent_bias));
+		const auto mantissa = _mm256_or_si256(_mm256_and_si256(bits, mantissa_mask), _mm256_castps_si256(one));
+		const auto t = _mm256_sub_ps(_mm256_castsi256_ps(mantissa), one);
+
+		auto p = _mm256_set1_ps(log2_coeffs[4]);
+		p = _mm256_fmadd_ps(p, t, _mm256_set1_ps(log2_coeffs[3]));
+		p = _mm256_fmadd_ps(p, t, _mm256_set1_ps(log2_coeffs[2]));
+		p = _mm256_fmadd_ps(p, t, _mm256_set1_ps(log2_coeffs[1]));
+		p = _mm256_fmadd_ps(p, t, _mm256_set1_ps(log2_coeffs[0]));
+		_mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_fmadd_ps(t, p, exponent), vmul));
+	}
+	scalar_kernels.log2_scaled(out + i, in + i, n - i, multiplier, floor);
+}
+
+float rectified_diff_sum(const float *const curr, const float *const prev, const size_t n)
+{
+	const auto zero = _mm256_setzero_ps();
+	auto vsum = zero;
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8)
+	{
+		const auto diff = _mm256_sub_ps(_mm256_loadu_ps(curr + i), _mm256_loadu_ps(prev + i));
+		vsum = _mm256_add_ps(vsum, _mm256_max_ps(diff, zero));
+	}
+
+	auto s4 = _mm_add_ps(_mm256_castps256_ps128(vsum), _mm256_extractf128_ps(vsum, 1));
+	s4 = _mm_add_ps(s4, _mm_movehl_ps(s4, s4));
+	s4 = _mm_add_ss(s4, _mm_shuffle_ps(s4, s4, 1));
+	return _mm_cvtss_f32(s4) + scalar_kernels.rectified_diff_sum(curr + i, prev + i, n - i);
+}
+
+} // namespace
+
+const Kernels avx2_kernels{magnitude, power, magnitude_max, log2_scaled, rectified_diff_sum};
+
+} // namespace avz::simd
+
+#endif
@@ -0,0 +1,100 @@
+// compiled with -mavx512f (see CMakeLists.txt), only called after checking the CPU supports it
+#include "kernels.hpp"
+
+#if defined(LIBAVZ_SIMD_X86)
+
+#include <immintrin.h>
+
+namespace avz::simd
+{
+
+namespace
+{
+
+// |c|^2 of 16 consecutive complex numbers
+inline __m512 norm16(const float *const in)
+{
+	const auto even = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+	const auto odd = _mm512_setr_epi32(1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31);
+	const auto a = _mm512_loadu_ps(in), b = _mm512_loadu_ps(in + 16);
+	const auto re = _mm512_permutex2var_ps(a, even, b), im = _mm512_permutex2var_ps(a, odd, b);
+	return _mm512_fmadd_ps(re, re, _mm512_mul_ps(im, im));
+}
+
+void magnitude(float *const out, const float *const in, const size_t n, const float scale)
+{
+	const auto s = _mm512_set1_ps(scale);
+	size_t i = 0;
+	for (; i + 16 <= n; i += 16)
+		_mm512_storeu_ps(out + i, _mm512_mul_ps(_mm512_sqrt_ps(norm16(in + 2 * i)), s));
+	scalar_kernels.magnitude(out + i, in + 2 * i, n - i, scale);
+}
+
+void power(float *const out, const float *const in, const size_t n, const float scale)
+{
+	const auto s = _mm512_set1_ps(scale);
+	size_t i = 0;
+	for (; i + 16 <= n; i += 16)
+		_mm512_storeu_ps(out + i, _mm512_mul_ps(norm16(in + 2 * i), s));
+	scalar_kernels.power(out + i, in + 2 * i, n - i, scale);
+}
+
+float magnitude_max(float *const out, const float *const in, const size_t n, const float scale)
+{
+	const auto s = _mm512_set1_ps(scale);
+	auto vmax = _mm512_setzero_ps();
+	size_t i = 0;
+	for (; i + 16 <= n; i += 16)
+	{
+		const auto m = _mm512_mul_ps(_mm512_sqrt_ps(norm16(in + 2 * i)), s);
+		_mm512_storeu_ps(out + i, m);
+		vmax = _mm512_max_ps(vmax, m);
+	}
+	const auto tail_max = scalar_kernels.magnitude_max(out + i, in + 2 * i, n - i, scale);
+	const auto head_max = _mm512_reduce_max_ps(vmax);
+	return head_max > tail_max ? head_max : tail_max;
+}
+
+void log2_scaled(float *const out, const float *const in, const size_t n, const float multiplier, const float floor)
+{
+	const auto vfloor = _mm512_set1_ps(floor), vmul = _mm512_set1_ps(multiplier), one = _mm512_set1_ps(1);
+	const auto mantissa_mask = _mm512_set1_epi32(0x7fffff), exponent_bias = _mm512_set1_epi32(127);
+	size_t i = 0;
+	for (; i + 16 <= n; i += 16)
+	{
+		const auto bits = _mm512_castps_si512(_mm512_max_ps(_mm512_loadu_ps(in + i), vfloor));
+		// inputs are clamped to a positive floor, so the sign bit is clear
+		const auto exponent = _mm512_cvtepi32_ps(_mm512_sub_epi32(_mm512_srli_epi32(bits, 23), exponent_bias));
+		const auto mantissa = _mm512_or_si512(_mm512_and_si512(bits, mantissa_mask), _mm512_castps_si512(one));
+		const auto t = _mm512_sub_ps(_mm512_castsi512_ps(mantissa), one);
+
+		auto p = _mm512_set1_ps(log2_coeffs[4]);
+		p = _mm512_fmadd_ps(p, t, _mm512_set1_ps(log2_coeffs[3]));
+		p = _mm512_fmadd_ps(p, t, _mm512_set1_ps(log2_coeffs[2]));
+		p = _mm512_fmadd_ps(p, t, _mm512_set1_ps(log2_coeffs[1]));
+		p = _mm512_fmadd_ps(p, t, _mm512_set1_ps(log2_coeffs[0]));
+		_mm512_storeu_ps(out + i, _mm512_mul_ps(_mm512_fmadd_ps(t, p, exponent), vmul));
+	}
+	scalar_kernels.log2_scaled(out + i, in + i, n - i, multiplier, floor);
+}
+
+float rectified_diff_sum(const float *const curr, const float *const prev, const size_t n)
+{
+	const auto zero = _mm512_setzero_ps();
+	auto vsum = zero;
+	size_t i = 0;
+	for (; i + 16 <= n; i += 16)
+	{
+		const auto diff = _mm512_sub_ps(_mm512_loadu_ps(curr + i), _mm512_loadu_ps(prev + i));
+		vsum = _mm512_add_ps(vsum, _mm512_max_ps(diff, zero));
+	}
+	return _mm512_reduce_add_ps(vsum) + scalar_kernels.rectified_diff_sum(curr + i, prev + i, n - i);
+}
+
+} // namespace
+
+const Kernels avx512_kernels{magnitude, power, magnitude_max, log2_scaled, rectified_diff_sum};
+
+} // namespace avz::simd
+
+#endif
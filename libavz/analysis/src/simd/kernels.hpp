@@ -0,0 +1,38 @@
+#pragma once
+
+// Internal to avz-analysis: the kernel table each instruction set implements.
+// Kept free of standard library includes, because ISA-specific translation units must not emit
+// inline functions that the linker could pick over the generic versions.
+
+#include <cstddef>
+
+namespace avz::simd
+{
+
+struct Kernels
+{
+	// `in` points to interleaved (re, im) pairs
+	void (*magnitude)(float *out, const float *in, size_t n, float scale);
+	void (*power)(float *out, const float *in, size_t n, float scale);
+	float (*magnitude_max)(float *out, const float *in, size_t n, float scale);
+
+	// out[i] = log2(max(in[i], floor)) * multiplier
+	void (*log2_scaled)(float *out, const float *in, size_t n, float multiplier, float floor);
+
+	// sum of max(curr[i] - prev[i], 0)
+	float (*rectified_diff_sum)(const float *curr, const float *prev, size_t n);
+};
+
+// log2(m) for m in [1, 2) as t * (c0 + t * (c1 + ...)) with t = m - 1; least-squares fit, max error 1.7e-5
+inline constexpr float log2_coeffs[]{
+	1.4418798957878247f, -0.7088652175626536f, 0.41524555989079964f, -0.19351652402739944f, 0.04526829237128238f};
+
+extern const Kernels scalar_kernels;
+#if defined(LIBAVZ_SIMD_X86)
+extern const Kernels avx2_kernels;
+extern const Kernels avx512_kernels;
+#elif defined(LIBAVZ_SIMD_NEON)
+extern const Kernels neon_kernels;
+#endif
+
+} // namespace avz::simd
@@ -0,0 +1,93 @@
+// NEON is part of the aarch64 baseline, so this needs no extra compile flags
+#include "kernels.hpp"
+
+#if defined(LIBAVZ_SIMD_NEON)
+
+#include <arm_neon.h>
+
+namespace avz::simd
+{
+
+namespace
+{
+
+// |c|^2 of 4 consecutive complex numbers
+inline float32x4_t norm4(const float *const in)
+{
+	// vld2q deinterleaves into re and im
+	const auto c = vld2q_f32(in);
+	return vfmaq_f32(vmulq_f32(c.val[0], c.val[0]), c.val[1], c.val[1]);
+}
+
+void magnitude(float *const out, const float *const in, const size_t n, const float scale)
+{
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+		vst1q_f32(out + i, vmulq_n_f32(vsqrtq_f32(norm4(in + 2 * i)), scale));
+	scalar_kernels.magnitude(out + i, in + 2 * i, n - i, scale);
+}
+
+void power(float *const out, const float *const in, const size_t n, const float scale)
+{
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+		vst1q_f32(out + i, vmulq_n_f32(norm4(in + 2 * i), scale));
+	scalar_kernels.power(out + i, in + 2 * i, n - i, scale);
+}
+
+float magnitude_max(float *const out, const float *const in, const size_t n, const float scale)
+{
+	auto vmax = vdupq_n_f32(0);
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		const auto m = vmulq_n_f32(vsqrtq_f32(norm4(in + 2 * i)), scale);
+		vst1q_f32(out + i, m);
+		vmax = vmaxq_f32(vmax, m);
+	}
+	const auto tail_max = scalar_kernels.magnitude_max(out + i, in + 2 * i, n - i, scale);
+	const auto head_max = vmaxvq_f32(vmax);
+	return head_max > tail_max ? head_max : tail_max;
+}
+
+void log2_scaled(float *const out, const float *const in, const size_t n, const float multiplier, const float floor)
+{
+	const auto vfloor = vdupq_n_f32(floor), one = vdupq_n_f32(1);
+	const auto mantissa_mask = vdupq_n_u32(0x7fffff), exponent_bias = vdupq_n_s32(127);
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		const auto bits = vreinterpretq_u32_f32(vmaxq_f32(vld1q_f32(in + i), vfloor));
+		// inputs are clamped to a positive floor, so the sign bit is clear
+		const auto exponent =
+			vcvtq_f32_s32(vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(bits, 23)), exponent_bias));
+		const auto mantissa = vorrq_u32(vandq_u32(bits, mantissa_mask), vreinterpretq_u32_f32(one));
+		const auto t = vsubq_f32(vreinterpretq_f32_u32(mantissa), one);
+
+		auto p = vdupq_n_f32(log2_coeffs[4]);
+		p = vfmaq_f32(vdupq_n_f32(log2_coeffs[3]), p, t);
+		p = vfmaq_f32(vdupq_n_f32(log2_coeffs[2]), p, t);
+		p = vfmaq_f32(vdupq_n_f32(log2_coeffs[1]), p, t);
+		p = vfmaq_f32(vdupq_n_f32(log2_coeffs[0]), p, t);
+		vst1q_f32(out + i, vmulq_n_f32(vfmaq_f32(exponent, t, p), multiplier));
+	}
+	scalar_kernels.log2_scaled(out + i, in + i, n - i, multiplier, floor);
+}
+
+float rectified_diff_sum(const float *const curr, const float *const prev, const size_t n)
+{
+	const auto zero = vdupq_n_f32(0);
+	auto vsum = zero;
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+		vsum = vaddq_f32(vsum, vmaxq_f32(vsubq_f32(vld1q_f32(curr + i), vld1q_f32(prev + i)), zero));
+	return vaddvq_f32(vsum) + scalar_kernels.rectified_diff_sum(curr + i, prev + i, n - i);
+}
+
+} // namespace
+
+const Kernels neon_kernels{magnitude, power, magnitude_max, log2_scaled, rectified_diff_sum};
+
+} // namespace avz::simd
+
+#endif
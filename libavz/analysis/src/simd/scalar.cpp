@@ -0,0 +1,73 @@
+#include "kernels.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+namespace avz::simd
+{
+
+namespace
+{
+
+void magnitude(float *const __restrict out, const float *const __restrict in, const size_t n, const float scale)
+{
+	for (size_t i = 0; i < n; ++i)
+	{
+		const auto re = in[2 * i], im = in[2 * i + 1];
+		out[i] = sqrtf(re * re + im * im) * scale;
+	}
+}
+
+void power(float *const __restrict out, const float *const __restrict in, const size_t n, const float scale)
+{
+	for (size_t i = 0; i < n; ++i)
+	{
+		const auto re = in[2 * i], im = in[2 * i + 1];
+		out[i] = (re * re + im * im) * scale;
+	}
+}
+
+float magnitude_max(float *const __restrict out, const float *const __restrict in, const size_t n, const float scale)
+{
+	float max{};
+	for (size_t i = 0; i < n; ++i)
+	{
+		const auto re = in[2 * i], im = in[2 * i + 1];
+		out[i] = sqrtf(re * re + im * im) * scale;
+		max = std::max(max, out[i]);
+	}
+	return max;
+}
+
+// out may alias in
+void log2_scaled(float *const out, const float *const in, const size_t n, const float multiplier, const float floor)
+{
+	for (size_t i = 0; i < n; ++i)
+	{
+		// split into exponent and mantissa in [1, 2)
+		const auto bits = std::bit_cast<uint32_t>(std::max(in[i], floor));
+		const auto exponent = (float)((int)((bits >> 23) & 0xff) - 127);
+		const auto t = std::bit_cast<float>((bits & 0x7fffff) | 0x3f800000) - 1;
+
+		auto p = log2_coeffs[4];
+		for (int k = 3; k >= 0; --k)
+			p = p * t + log2_coeffs[k];
+		out[i] = (exponent + t * p) * multiplier;
+	}
+}
+
+float rectified_diff_sum(const float *const __restrict curr, const float *const __restrict prev, const size_t n)
+{
+	float sum{};
+	for (size_t i = 0; i < n; ++i)
+		sum += std::max(curr[i] - prev[i], 0.f);
+	return sum;
+}
+
+} // namespace
+
+const Kernels scalar_kernels{magnitude, power, magnitude_max, log2_scaled, rectified_diff_sum};
+
+} // namespace avz::simd
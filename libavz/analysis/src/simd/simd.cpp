@@ -0,0 +1,143 @@
+#include "kernels.hpp"
+#include <avz/analysis/simd.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace avz::simd
+{
+
+namespace
+{
+
+bool is_supported(const Isa isa)
+{
+	switch (isa)
+	{
+	case Isa::Scalar:
+		return true;
+#if defined(LIBAVZ_SIMD_X86)
+	case Isa::Avx2:
+		return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+	case Isa::Avx512:
+		return __builtin_cpu_supports("avx512f");
+#elif defined(LIBAVZ_SIMD_NEON)
+	case Isa::Neon:
+		return true;
+#endif
+	default:
+		return false;
+	}
+}
+
+const Kernels &kernels_of(const Isa isa)
+{
+	switch (isa)
+	{
+#if defined(LIBAVZ_SIMD_X86)
+	case Isa::Avx2:
+		return avx2_kernels;
+	case Isa::Avx512:
+		return avx512_kernels;
+#elif defined(LIBAVZ_SIMD_NEON)
+	case Isa::Neon:
+		return neon_kernels;
+#endif
+	default:
+		return scalar_kernels;
+	}
+}
+
+// written once at startup (or by set_isa), read by every kernel call.
+// Isa::Scalar is zero, so kernels called during static initialization before this is set are still safe.
+std::atomic<Isa> active_isa{detect_isa()};
+
+inline const Kernels &active()
+{
+	return kernels_of(active_isa.load(std::memory_order_relaxed));
+}
+
+} // namespace
+
+Isa detect_isa()
+{
+#if defined(LIBAVZ_SIMD_X86)
+	// required when called during static initialization
+	__builtin_cpu_init();
+#endif
+	for (const auto isa : {Isa::Avx512, Isa::Avx2, Isa::Neon})
+		if (is_supported(isa))
+			return isa;
+	return Isa::Scalar;
+}
+
+Isa get_isa()
+{
+	return active_isa.load(std::memory_order_relaxed);
+}
+
+void set_isa(const Isa isa)
+{
+	if (!is_supported(isa))
+		throw std::invalid_argument{std::string{"[avz::simd::set_isa] unsupported instruction set: "} + isa_name(isa)};
+	active_isa.store(isa, std::memory_order_relaxed);
+}
+
+const char *isa_name(const Isa isa)
+{
+	switch (isa)
+	{
+	case Isa::Scalar:
+		return "scalar";
+	case Isa::Neon:
+		return "neon";
+	case Isa::Avx2:
+		return "avx2";
+	case Isa::Avx512:
+		return "avx512";
+	default:
+		return "unknown";
+	}
+}
+
+void magnitude(std::span<float> out, std::span<const std::complex<float>> in, const float scale)
+{
+	assert(out.size() == in.size());
+	active().magnitude(out.data(), (const float *)in.data(), in.size(), scale);
+}
+
+void power(std::span<float> out, std::span<const std::complex<float>> in, const float scale)
+{
+	assert(out.size() == in.size());
+	active().power(out.data(), (const float *)in.data(), in.size(), scale);
+}
+
+float magnitude_max(std::span<float> out, std::span<const std::complex<float>> in, const float scale)
+{
+	assert(out.size() == in.size());
+	return active().magnitude_max(out.data(), (const float *)in.data(), in.size(), scale);
+}
+
+void amplitude_to_db(std::span<float> out, std::span<const float> in, const float min_db)
+{
+	assert(out.size() == in.size());
+	// 20 * log10(x) = 20 * log10(2) * log2(x)
+	active().log2_scaled(out.data(), in.data(), in.size(), 20 * log10f(2), powf(10, min_db / 20));
+}
+
+void power_to_db(std::span<float> out, std::span<const float> in, const float min_db)
+{
+	assert(out.size() == in.size());
+	active().log2_scaled(out.data(), in.data(), in.size(), 10 * log10f(2), powf(10, min_db / 10));
+}
+
+float spectral_flux(std::span<const float> curr, std::span<const float> prev)
+{
+	assert(curr.size() == prev.size());
+	return active().rectified_diff_sum(curr.data(), prev.data(), curr.size());
+}
+
+} // namespace avz::simd
@@ -1,12 +1,16 @@
+#include <avz/analysis/simd.hpp>
 #include <avz/analysis/util.hpp>
 
+#include <algorithm>
+#include <cassert>
+
 namespace avz::util
 {
 
 void resample_spectrum(
 	std::span<float> spectrum,
 	std::span<const float> in_amps,
-	int sample_rate_hz,
+	float sample_rate_hz,
 	int fft_size,
 	float start_freq,
 	float end_freq,
@@ -14,20 +18,30 @@ void resample_spectrum(
 {
 	interpolator.set_values(in_amps);
 
-	const float bin_size = (float)sample_rate_hz / fft_size;
+	const float bin_size = sample_rate_hz / fft_size;
 	const float bin_pos_start = (start_freq / bin_size);
 	const float bin_pos_end = (end_freq / bin_size);
 	const float bin_pos_step = (bin_pos_end - bin_pos_start) / std::max(1.0f, (float)spectrum.size() - 1.0f);
 
-	float current_bin_pos = bin_pos_start;
 	const auto out_size = spectrum.size();
 
+	// positions aren't accumulated, so rounding error doesn't build up across the spectrum
 #pragma GCC ivdep
 	for (size_t i = 0; i < out_size; ++i)
-	{
-		spectrum[i] = interpolator.sample(current_bin_pos);
-		current_bin_pos += bin_pos_step;
-	}
+		spectrum[i] = interpolator.sample(bin_pos_start + i * bin_pos_step);
+}
+
+void resample_spectrum(
+	std::span<float> spectrum,
+	std::span<const float> in_amps,
+	const float sample_rate_hz,
+	const int fft_size,
+	const float start_freq,
+	const float end_freq,
+	SpectrumResamplePlan &plan)
+{
+	plan.set_grid({(int)spectrum.size(), sample_rate_hz, fft_size, start_freq, end_freq});
+	plan.execute(spectrum, in_amps);
 }
 
 void extract_channel(std::span<float> out, std::span<const float> in, int num_channels, int channel)
@@ -45,4 +59,33 @@ void extract_channel(std::span<float> out, std::span<const float> in, int num_ch
 		out_ptr[i] = in_ptr[i * num_channels + channel];
 }
 
+void compute_amplitudes(std::span<float> out, std::span<const std::complex<float>> spectrum, const int fft_size)
+{
+	assert(out.size() == spectrum.size());
+
+	// must divide by fft_size here to counteract the correlation
+	// between fft_size and the average amplitude across the spectrum vector.
+	simd::magnitude(out, spectrum, 1.f / fft_size);
+}
+
+int find_peak_bin(
+	std::span<const float> amplitudes,
+	const float sample_rate_hz,
+	const int transform_size,
+	const int from_hz,
+	const int to_hz)
+{
+	assert(from_hz < to_hz);
+	assert(!amplitudes.empty());
+
+	// the sample rate may be fractional after decimation
+	const auto bin_size = sample_rate_hz / transform_size;
+	const auto last_bin = (int)amplitudes.size() - 1;
+	const auto start_bin = std::min((int)(from_hz / bin_size), last_bin);
+	const auto end_bin = std::min((int)(to_hz / bin_size), last_bin);
+
+	const auto begin = amplitudes.begin();
+	return std::distance(begin, std::ranges::max_element(begin + start_bin, begin + end_bin + 1));
+}
+
 } // namespace avz::util
@@ -1,6 +1,11 @@
 #pragma once
 
+#include <avz/media/AudioRingBuffer.hpp>
 #include <avz/media/FfmpegPopenEncoder.hpp>
 #include <avz/media/FfmpegPopenMedia.hpp>
 #include <avz/media/FfprobeMetadata.hpp>
+#if defined(LIBAVZ_MEDIA_LIBAV)
+#include <avz/media/LibavMedia.hpp>
+#endif
+#include <avz/media/MappedPcmMedia.hpp>
 #include <avz/media/Media.hpp>
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <span>
+
+namespace avz
+{
+
+/**
+ * Fixed-capacity single-producer single-consumer ring buffer of audio samples.
+ *
+ * The storage is mapped into memory twice, back to back, so any run of up to `capacity()` samples starting
+ * anywhere in the first mapping is contiguous: the producer can decode straight into `write_region()`, and
+ * the consumer gets its whole window from `read_region()` without copying, even across the wrap-around.
+ * Consuming is an index bump.
+ *
+ * One thread may write (`write_region`, `commit`) while another reads (`read_region`, `consume`).
+ */
+class AudioRingBuffer
+{
+	float *data{};
+	size_t _capacity{};
+
+	// total samples ever committed and consumed; the buffer holds write_pos - read_pos samples
+	alignas(64) std::atomic<size_t> write_pos{};
+	alignas(64) std::atomic<size_t> read_pos{};
+
+public:
+	/**
+	 * @param min_capacity minimum samples the buffer must hold; rounded up to a power of two that fills whole
+	 * memory pages
+	 * @throws `std::runtime_error` if the mirrored mapping can't be created
+	 */
+	explicit AudioRingBuffer(size_t min_capacity);
+	~AudioRingBuffer();
+
+	AudioRingBuffer(const AudioRingBuffer &) = delete;
+	AudioRingBuffer &operator=(const AudioRingBuffer &) = delete;
+
+	inline size_t capacity() const { return _capacity; }
+
+	/**
+	 * Number of samples available to the consumer.
+	 */
+	inline size_t size() const
+	{
+		return write_pos.load(std::memory_order_acquire) - read_pos.load(std::memory_order_acquire);
+	}
+
+	/**
+	 * Contiguous free space the producer can write into, `capacity() - size()` samples.
+	 */
+	inline std::span<float> write_region()
+	{
+		const auto w = write_pos.load(std::memory_order_relaxed);
+		const auto r = read_pos.load(std::memory_order_acquire);
+		return {data + (w & (_capacity - 1)), _capacity - (w - r)};
+	}
+
+	/**
+	 * Make the first `samples` samples of `write_region()` available to the consumer.
+	 */
+	inline void commit(const size_t samples)
+	{
+		write_pos.store(write_pos.load(std::memory_order_relaxed) + samples, std::memory_order_release);
+	}
+
+	/**
+	 * Every sample available to the consumer, oldest first, contiguous.
+	 */
+	inline std::span<const float> read_region() const
+	{
+		const auto r = read_pos.load(std::memory_order_relaxed);
+		const auto w = write_pos.load(std::memory_order_acquire);
+		return {data + (r & (_capacity - 1)), w - r};
+	}
+
+	/**
+	 * Drop the oldest `samples` samples, at most `size()`.
+	 */
+	inline void consume(const size_t samples)
+	{
+		read_pos.store(read_pos.load(std::memory_order_relaxed) + samples, std::memory_order_release);
+	}
+
+	/**
+	 * Drop every sample. Only safe while neither side is in use.
+	 */
+	inline void clear() { read_pos.store(write_pos.load()); }
+};
+
+} // namespace avz
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <atomic>
+#include <avz/media/AudioRingBuffer.hpp>
 #include <avz/media/FfprobeMetadata.hpp>
 #include <avz/media/Media.hpp>
+#include <memory>
+#include <thread>
 
 namespace avz
 {
@@ -21,9 +25,34 @@ private:
 	FILE *audio{}, *video{};
 	FfprobeMetadata metadata;
 	std::optional<std::vector<std::byte>> _attached_pic;
+	bool audio_read{};
 
-	void init_audio(float start_time_sec = {});
-	void init_video();
+	// prefetch mode: a reader thread keeps `prefetched` filled from the audio pipe
+	std::unique_ptr<AudioRingBuffer> prefetched;
+	std::jthread reader;
+	// bumped by the reader after each read and when it finishes, and by the renderer after consuming or stopping
+	std::atomic<unsigned> reader_events{}, render_events{};
+	std::atomic<bool> reader_done{}, stop_reader{};
+	std::atomic<size_t> underruns{};
+	// whether a whole window was read since the reader was last (re)started; waiting before that isn't an underrun
+	bool prefetch_primed{};
+#ifdef _WIN32
+	// _read can't time out, so stop_prefetch cancels it through the reader's thread id; 0 when no reader runs
+	std::atomic<unsigned long> reader_thread_id{};
+#endif
+
+	void init_audio(double start_time_sec = {});
+	void init_video(double start_time_sec = {});
+	void reader_loop();
+	void stop_prefetch();
+
+protected:
+	/**
+	 * Restarts `ffmpeg` with an input-side `-ss`, so it seeks with the container's index and decodes from
+	 * there. The old processes are closed in the background. `ffprobe` metadata is kept.
+	 * @throws `std::runtime_error` if the new `ffmpeg` process can't be started
+	 */
+	void seek_source(double seconds) override;
 
 public:
 	/**
@@ -34,7 +63,34 @@ public:
 	FfmpegPopenMedia(const std::string &url, float start_time_sec = {});
 	~FfmpegPopenMedia();
 
+	/**
+	 * Start a reader thread that keeps up to `seconds` of decoded audio ahead of `read_audio_samples`, reading the
+	 * pipe in large blocks. A stall in `ffmpeg` then only reaches the caller once the prefetched audio runs out.
+	 * @throws `std::invalid_argument` if `seconds` is not positive
+	 * @throws `std::logic_error` if there is no audio stream, audio was already read, or prefetching already started
+	 */
+	void start_prefetch(float seconds);
+
+	inline bool is_prefetching() const { return (bool)prefetched; }
+
+	/**
+	 * Get how full the prefetch buffer is, from 0 to 1. Always 0 without prefetching.
+	 */
+	float get_prefetch_fill() const;
+
+	/**
+	 * Get the number of prefetched samples not yet read.
+	 */
+	inline size_t get_prefetched_samples() const { return prefetched ? prefetched->size() : 0; }
+
+	/**
+	 * Get the number of reads that found the prefetch buffer empty and had to wait for the reader thread,
+	 * not counting waits while the first `read_audio` after starting to prefetch or seeking fills its window.
+	 */
+	inline size_t get_underruns() const { return underruns; }
+
 	size_t read_audio_samples(float *buf, int samples) override;
+	std::optional<std::span<const float>> read_audio(int frames) override;
 	bool read_video_frame(std::vector<std::byte> &buf) override;
 
 	inline int audio_sample_rate() const override { return metadata.getAudioSampleRate(); }
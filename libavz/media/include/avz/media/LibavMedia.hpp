@@ -0,0 +1,94 @@
+#pragma once
+
+#include <avz/media/Media.hpp>
+#include <cstdint>
+#include <deque>
+#include <memory>
+
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libswresample/swresample.h>
+#include <libswscale/swscale.h>
+}
+
+namespace avz
+{
+
+/**
+ * Implementation of `Media` decoding in-process with libavformat/libavcodec,
+ * converting audio to interleaved floats with libswresample and video frames
+ * to RGBA with libswscale. Unlike `FfmpegPopenMedia`, no process or pipe sits
+ * between the decoder and the caller: audio is converted straight into the
+ * buffer passed to `read_audio_samples`, and seeking is sample-accurate.
+ */
+class LibavMedia : public Media
+{
+	template <typename T, auto free_fn>
+	struct Deleter
+	{
+		void operator()(T *p) const { free_fn(&p); }
+	};
+
+	template <typename T, auto free_fn>
+	using Ptr = std::unique_ptr<T, Deleter<T, free_fn>>;
+
+	Ptr<AVFormatContext, avformat_close_input> format;
+	Ptr<AVCodecContext, avcodec_free_context> audio_decoder, video_decoder;
+	Ptr<SwrContext, swr_free> resampler;
+	Ptr<AVFrame, av_frame_free> audio_frame, video_frame;
+	std::unique_ptr<SwsContext, decltype(&sws_freeContext)> scaler{nullptr, sws_freeContext};
+
+	const unsigned scaled_width{}, scaled_height{};
+	AVStream *audio_stream{}, *video_stream{};
+	std::optional<std::vector<std::byte>> _attached_pic;
+
+	// packets demuxed while looking for the other stream's packets
+	std::deque<Ptr<AVPacket, av_packet_free>> audio_packets, video_packets;
+	bool demuxer_eof{}, audio_flushed{}, video_flushed{};
+
+	// `audio_frame` is decoded but not converted yet: flushing the resampler it replaces filled the caller's buffer
+	bool audio_frame_pending{};
+
+	// after a seek: decoded frames before these timestamps (in their stream's time base) are dropped
+	int64_t audio_skip_until{AV_NOPTS_VALUE}, video_skip_until{AV_NOPTS_VALUE};
+
+	static Ptr<AVCodecContext, avcodec_free_context> open_decoder(const AVStream *stream);
+	Ptr<AVPacket, av_packet_free> next_packet(const AVStream *stream);
+	bool decode_frame(AVCodecContext *decoder, const AVStream *stream, AVFrame *frame, bool &flushed);
+	bool skip_audio_before_seek();
+	void init_resampler();
+	bool resampler_accepts_frame() const;
+	std::string tag(const char *key) const;
+
+protected:
+	/**
+	 * Seeks are sample-accurate: decoding restarts at the last keyframe before `seconds`,
+	 * and decoded frames are trimmed up to it.
+	 * @throws `std::runtime_error` if the demuxer can't seek
+	 */
+	void seek_source(double seconds) override;
+
+public:
+	/**
+	 * Open the media at the provided URL. Optionally provide the desired video size
+	 * for video frames to be scaled to; video is only decoded if both are nonzero.
+	 * @throws `std::runtime_error` if the media can't be opened or has no decodable audio stream
+	 */
+	LibavMedia(const std::string &url, unsigned scaled_width, unsigned scaled_height, float start_time_sec = {});
+	LibavMedia(const std::string &url, float start_time_sec = {});
+
+	size_t read_audio_samples(float *buf, int samples) override;
+	bool read_video_frame(std::vector<std::byte> &buf) override;
+
+	inline int audio_sample_rate() const override { return audio_stream->codecpar->sample_rate; }
+	inline int audio_channels() const override { return audio_stream->codecpar->ch_layout.nb_channels; }
+	inline bool has_video_stream() const override { return video_stream; }
+	int video_framerate() const override;
+	inline const std::optional<std::vector<std::byte>> &attached_pic() const override { return _attached_pic; }
+	inline std::string title() const override { return tag("title"); }
+	inline std::string artist() const override { return tag("artist"); }
+};
+
+} // namespace avz
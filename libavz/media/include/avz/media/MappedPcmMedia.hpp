@@ -0,0 +1,92 @@
+#pragma once
+
+#include <avz/media/Media.hpp>
+#include <filesystem>
+
+namespace avz
+{
+
+/**
+ * Implementation of `Media` for uncompressed 32-bit float audio, memory-mapped
+ * from a WAV file (plain RIFF, or RF64 for files over 4 GiB) or a raw `f32le` file.
+ * `read_audio` returns spans pointing straight into the mapping, so reading
+ * and consuming audio never copies or decodes anything, and seeking is instant.
+ *
+ * Anything else `ffmpeg` can decode can be opened through a decode cache: `cache`
+ * decodes a file once into a float WAV file, which later runs map directly.
+ */
+class MappedPcmMedia : public Media
+{
+	const std::byte *mapping{};
+	size_t mapping_size{};
+
+	// only used if the file's sample data isn't aligned for floats
+	std::vector<float> aligned_copy;
+
+	std::span<const float> samples;
+	size_t position{};
+	int sample_rate{}, channels{};
+	std::string _title, _artist;
+	std::optional<std::vector<std::byte>> _attached_pic;
+
+	void map(const std::filesystem::path &path);
+	void parse_wav();
+
+public:
+	/**
+	 * Map a WAV file of 32-bit float samples, e.g. one returned by `cache`.
+	 * Title and artist come from its `LIST`/`INFO` chunk.
+	 * @throws `std::runtime_error` if the file can't be mapped or isn't a 32-bit float WAV file
+	 */
+	explicit MappedPcmMedia(const std::filesystem::path &path);
+
+	/**
+	 * Map a headerless file of interleaved 32-bit little-endian float samples.
+	 * @throws `std::invalid_argument` if `sample_rate` or `channels` is not positive
+	 * @throws `std::runtime_error` if the file can't be mapped
+	 */
+	MappedPcmMedia(const std::filesystem::path &path, int sample_rate, int channels);
+
+	~MappedPcmMedia();
+
+	MappedPcmMedia(const MappedPcmMedia &) = delete;
+	MappedPcmMedia &operator=(const MappedPcmMedia &) = delete;
+
+	/**
+	 * Get the directory `cache` uses by default: `$XDG_CACHE_HOME/avz`, `~/.cache/avz`,
+	 * or `%LOCALAPPDATA%\avz` on Windows.
+	 */
+	static std::filesystem::path default_cache_dir();
+
+	/**
+	 * Get the decode cache file for the local file `path`, decoding it with `ffmpeg` first if there is none.
+	 * Cache files are keyed by the file's absolute path, size and modification time, so a changed file is decoded
+	 * again. They keep the title, artist and attached picture. Open the result with `MappedPcmMedia{path}`.
+	 * @throws `std::invalid_argument` if `path` isn't an existing file
+	 * @throws `std::runtime_error` if decoding fails, or the cache file can't be written
+	 */
+	static std::filesystem::path
+	cache(const std::filesystem::path &path, const std::filesystem::path &cache_dir = default_cache_dir());
+
+	size_t read_audio_samples(float *buf, int samples) override;
+	bool read_video_frame(std::vector<std::byte> &buf) override;
+
+	/**
+	 * Returns a span into the mapping, valid for the lifetime of this object.
+	 */
+	std::optional<std::span<const float>> read_audio(int frames) override;
+	void consume_audio(int frames) override;
+
+	inline int audio_sample_rate() const override { return sample_rate; }
+	inline int audio_channels() const override { return channels; }
+	inline bool has_video_stream() const override { return false; }
+	inline int video_framerate() const override { return 0; }
+	inline const std::optional<std::vector<std::byte>> &attached_pic() const override { return _attached_pic; }
+	inline std::string title() const override { return _title; }
+	inline std::string artist() const override { return _artist; }
+
+protected:
+	void seek_source(double seconds) override;
+};
+
+} // namespace avz
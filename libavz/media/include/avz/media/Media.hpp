@@ -1,5 +1,7 @@
 #pragma once
 
+#include <avz/media/AudioRingBuffer.hpp>
+#include <memory>
 #include <optional>
 #include <span>
 #include <string>
@@ -15,7 +17,8 @@ namespace avz
  */
 class Media
 {
-	std::vector<float> _audio_buffer;
+	// created by the first `read_audio`, and replaced by a larger one if a read needs more room
+	std::unique_ptr<AudioRingBuffer> _audio_buffer;
 
 public:
 	const std::string url;
@@ -47,8 +50,11 @@ public:
 	 * Erase the first `frames` audio frames from the buffer. This is
 	 * used in tandem with `read_audio` to "move" the audio buffer
 	 * forward by the `frames` you have already used.
+	 * Only moves the start of the ring buffer, nothing is copied.
+	 * Implementations that hold all of their audio in memory may override
+	 * this together with `read_audio`.
 	 */
-	void consume_audio(const int frames);
+	virtual void consume_audio(const int frames);
 
 	/**
 	 * Attempts to buffer `frames` audio frames from the underlying source.
@@ -56,11 +62,29 @@ public:
 	 * the amount of `frames` requested.
 	 * Otherwise returns an empty optional.
 	 *
+	 * The span points into the ring buffer, which `read_audio_samples` writes
+	 * into directly; it stays valid until the next call to `read_audio`.
+	 *
 	 * NOTE: You must call `consume_audio` to erase the audio you no longer
 	 * need from the buffer, otherwise this method will keep returning the
 	 * same audio without reading new data from the implementation.
 	 */
-	std::optional<std::span<const float>> read_audio(int frames);
+	virtual std::optional<std::span<const float>> read_audio(int frames);
+
+	/**
+	 * Move to `seconds` from the start of the media. All buffered audio is
+	 * dropped, so the next `read_audio` returns audio starting at `seconds`,
+	 * and the next `read_video_frame` returns the frame shown at `seconds`.
+	 * @throws `std::invalid_argument` if `seconds` is negative
+	 */
+	void seek(double seconds);
+
+protected:
+	/**
+	 * Move the underlying source to `seconds`, which is not negative.
+	 * Called by `seek`, which then drops the buffered audio.
+	 */
+	virtual void seek_source(double seconds) = 0;
 };
 
 } // namespace avz
@@ -0,0 +1,157 @@
+#include <avz/media/AudioRingBuffer.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace avz
+{
+
+namespace
+{
+
+#ifdef _WIN32
+
+std::string last_error()
+{
+	return std::to_string(GetLastError());
+}
+
+size_t allocation_granularity()
+{
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwAllocationGranularity;
+}
+
+// windows can't map over a reservation, so free a reservation of both halves and map into its place,
+// retrying if another thread took the address in between
+float *map_mirrored(const size_t bytes)
+{
+	const auto mapping = CreateFileMappingW(
+		INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, (DWORD)((uint64_t)bytes >> 32), (DWORD)bytes, nullptr);
+	if (!mapping)
+		throw std::runtime_error{"[AudioRingBuffer] CreateFileMapping: error " + last_error()};
+
+	for (int attempt = 0; attempt < 16; ++attempt)
+	{
+		const auto base = (char *)VirtualAlloc(nullptr, 2 * bytes, MEM_RESERVE, PAGE_NOACCESS);
+		if (!base)
+			break;
+		VirtualFree(base, 0, MEM_RELEASE);
+
+		const auto first = MapViewOfFileEx(mapping, FILE_MAP_ALL_ACCESS, 0, 0, bytes, base);
+		const auto second = first ? MapViewOfFileEx(mapping, FILE_MAP_ALL_ACCESS, 0, 0, bytes, base + bytes) : nullptr;
+		if (first && second)
+		{
+			// the views keep the mapping alive
+			CloseHandle(mapping);
+			return (float *)base;
+		}
+		if (first)
+			UnmapViewOfFile(first);
+	}
+
+	const auto error = last_error();
+	CloseHandle(mapping);
+	throw std::runtime_error{"[AudioRingBuffer] MapViewOfFileEx: error " + error};
+}
+
+void unmap_mirrored(float *const data, const size_t bytes)
+{
+	UnmapViewOfFile(data);
+	UnmapViewOfFile((char *)data + bytes);
+}
+
+#else
+
+size_t allocation_granularity()
+{
+	return sysconf(_SC_PAGESIZE);
+}
+
+int create_shared_memory()
+{
+#ifdef __linux__
+	return memfd_create("avz-audio-ring", MFD_CLOEXEC);
+#else
+	// no memfd: create a named object and unlink it right away, the descriptor keeps it alive
+	static std::atomic<unsigned> counter;
+	const auto name = "/avz-audio-ring-" + std::to_string(getpid()) + '-' + std::to_string(counter++);
+	const auto fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+	if (fd != -1)
+		shm_unlink(name.c_str());
+	return fd;
+#endif
+}
+
+// reserve both halves, then map the same memory over each of them
+float *map_mirrored(const size_t bytes)
+{
+	const auto fd = create_shared_memory();
+	if (fd == -1)
+		throw std::runtime_error{std::string{"[AudioRingBuffer] shared memory: "} + strerror(errno)};
+
+	if (ftruncate(fd, bytes) == -1)
+	{
+		const auto error = errno;
+		close(fd);
+		throw std::runtime_error{std::string{"[AudioRingBuffer] ftruncate: "} + strerror(error)};
+	}
+
+	const auto base = (char *)mmap(nullptr, 2 * bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (base == MAP_FAILED)
+	{
+		const auto error = errno;
+		close(fd);
+		throw std::runtime_error{std::string{"[AudioRingBuffer] mmap: "} + strerror(error)};
+	}
+
+	for (const auto half : {base, base + bytes})
+		if (mmap(half, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED)
+		{
+			const auto error = errno;
+			munmap(base, 2 * bytes);
+			close(fd);
+			throw std::runtime_error{std::string{"[AudioRingBuffer] mmap: "} + strerror(error)};
+		}
+
+	// the mappings keep the memory alive
+	close(fd);
+	return (float *)base;
+}
+
+void unmap_mirrored(float *const data, const size_t bytes)
+{
+	munmap(data, 2 * bytes);
+}
+
+#endif
+
+} // namespace
+
+AudioRingBuffer::AudioRingBuffer(const size_t min_capacity)
+{
+	// a power of two, so positions wrap with a mask, and a multiple of the granularity, so the halves can be mapped
+	const auto bytes = std::bit_ceil(std::max(min_capacity * sizeof(float), allocation_granularity()));
+	data = map_mirrored(bytes);
+	_capacity = bytes / sizeof(float);
+}
+
+AudioRingBuffer::~AudioRingBuffer()
+{
+	unmap_mirrored(data, _capacity * sizeof(float));
+}
+
+} // namespace avz
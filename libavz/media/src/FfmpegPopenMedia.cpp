@@ -1,13 +1,88 @@
 #include "util.hpp"
+#include <algorithm>
 #include <avz/media/FfmpegPopenMedia.hpp>
+#include <chrono>
+#include <condition_variable>
 #include <cstring>
 #include <iostream>
+#include <mutex>
 #include <sstream>
+#include <utility>
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <poll.h>
+#include <unistd.h>
+#endif
 
 namespace avz
 {
 
-void FfmpegPopenMedia::init_audio(float start_time_sec)
+namespace
+{
+
+// closes pipes on a background thread: pclose waits for ffmpeg to exit, which can take a while if ffmpeg is
+// blocked on its input (e.g. a slow stream), and a seek shouldn't wait for that
+class PipeReaper
+{
+	std::mutex mu;
+	std::condition_variable cv;
+	std::vector<FILE *> pipes;
+	bool stopping{};
+	std::thread worker{[this] { loop(); }};
+
+public:
+	static PipeReaper &instance()
+	{
+		static PipeReaper reaper;
+		return reaper;
+	}
+
+	~PipeReaper()
+	{
+		{
+			std::lock_guard lk{mu};
+			stopping = true;
+		}
+		cv.notify_one();
+		worker.join();
+	}
+
+	void reap(FILE *const pipe)
+	{
+		{
+			std::lock_guard lk{mu};
+			pipes.emplace_back(pipe);
+		}
+		cv.notify_one();
+	}
+
+private:
+	void loop()
+	{
+		std::unique_lock lk{mu};
+		while (true)
+		{
+			cv.wait(lk, [this] { return pipes.size() || stopping; });
+			// pipes reaped before exiting are still closed
+			if (pipes.empty())
+				return;
+			const auto closing = std::move(pipes);
+			pipes.clear();
+			lk.unlock();
+			for (const auto pipe : closing)
+				if (pclose(pipe) == -1)
+					perror("[FfmpegPopenMedia] pclose");
+			lk.lock();
+		}
+	}
+};
+
+} // namespace
+
+void FfmpegPopenMedia::init_audio(const double start_time_sec)
 {
 	std::ostringstream ss;
 	ss << "ffmpeg -v warning ";
@@ -15,8 +90,10 @@ void FfmpegPopenMedia::init_audio(float start_time_sec)
 	if (url.contains("http"))
 		ss << "-reconnect 1 ";
 
+	// input-side, so ffmpeg seeks in the input instead of decoding up to the start time;
+	// to the microsecond, as the default precision would round long start times
 	if (start_time_sec != 0)
-		ss << "-ss " << start_time_sec << ' ';
+		ss << "-ss " << std::fixed << start_time_sec << ' ';
 	ss << "-i \"" << url << "\" ";
 	ss << "-c:a pcm_f32le -f f32le - ";
 
@@ -26,7 +103,7 @@ void FfmpegPopenMedia::init_audio(float start_time_sec)
 		throw std::runtime_error{std::string{"[FfmpegPopenMedia::init_audio] popen: "} + strerror(errno)};
 }
 
-void FfmpegPopenMedia::init_video()
+void FfmpegPopenMedia::init_video(const double start_time_sec)
 {
 	std::ostringstream ss;
 	ss << "ffmpeg -v warning -hwaccel auto ";
@@ -34,6 +111,9 @@ void FfmpegPopenMedia::init_video()
 	if (url.contains("http"))
 		ss << "-reconnect 1 ";
 
+	if (start_time_sec != 0)
+		ss << "-ss " << std::fixed << start_time_sec << ' ';
+
 	ss << "-i \"" << url << "\" ";
 
 	// from the ffmpeg docs: ’V’ only matches video streams which
@@ -118,7 +198,7 @@ FfmpegPopenMedia::FfmpegPopenMedia(
 	_attached_pic = getAttachedPicture(url);
 	init_audio(start_time_sec);
 	if (has_video_stream() && scaled_width && scaled_height)
-		init_video();
+		init_video(start_time_sec);
 }
 
 FfmpegPopenMedia::FfmpegPopenMedia(const std::string &url, float start_time_sec)
@@ -131,17 +211,186 @@ FfmpegPopenMedia::FfmpegPopenMedia(const std::string &url, float start_time_sec)
 
 FfmpegPopenMedia::~FfmpegPopenMedia()
 {
+	// the reader uses the audio pipe
+	stop_prefetch();
 	if (audio && pclose(audio) == -1)
 		perror("[FfmpegPopenMedia::~FfmpegPopenMedia] audio: pclose");
 	if (video && pclose(video) == -1)
 		perror("[FfmpegPopenMedia::~FfmpegPopenMedia] video: pclose");
 }
 
+void FfmpegPopenMedia::start_prefetch(const float seconds)
+{
+	if (seconds <= 0)
+		throw std::invalid_argument{"[FfmpegPopenMedia::start_prefetch] seconds must be > 0"};
+	if (!audio)
+		throw std::logic_error{"[FfmpegPopenMedia::start_prefetch] no audio stream"};
+	// the reader bypasses stdio, which may already hold buffered audio
+	if (audio_read || prefetched)
+		throw std::logic_error{"[FfmpegPopenMedia::start_prefetch] audio was already read"};
+
+	prefetched = std::make_unique<AudioRingBuffer>(seconds * audio_sample_rate() * audio_channels());
+	reader = std::jthread{&FfmpegPopenMedia::reader_loop, this};
+}
+
+void FfmpegPopenMedia::stop_prefetch()
+{
+	if (!reader.joinable())
+		return;
+	stop_reader = true;
+	++render_events;
+	render_events.notify_one();
+#ifdef _WIN32
+	// a blocking _read only returns once ffmpeg writes or exits, so cancel it until the reader notices `stop_reader`.
+	// the reader may not have entered _read yet when it is cancelled, hence the retries
+	while (!reader_done)
+	{
+		if (const auto id = reader_thread_id.load())
+			if (const auto thread = OpenThread(THREAD_TERMINATE, FALSE, id))
+			{
+				CancelSynchronousIo(thread);
+				CloseHandle(thread);
+			}
+		std::this_thread::sleep_for(std::chrono::milliseconds{10});
+	}
+#endif
+	reader.join();
+}
+
+void FfmpegPopenMedia::seek_source(const double seconds)
+{
+	// the reader uses the audio pipe
+	stop_prefetch();
+
+	// whatever the old processes decoded, and stdio buffered, goes with their pipes
+	if (audio)
+		PipeReaper::instance().reap(std::exchange(audio, nullptr));
+	init_audio(seconds);
+
+	if (video)
+	{
+		PipeReaper::instance().reap(std::exchange(video, nullptr));
+		init_video(seconds);
+	}
+
+	if (prefetched)
+	{
+		prefetched->clear();
+		prefetch_primed = false;
+		stop_reader = reader_done = false;
+		reader = std::jthread{&FfmpegPopenMedia::reader_loop, this};
+	}
+}
+
+float FfmpegPopenMedia::get_prefetch_fill() const
+{
+	return prefetched ? (float)prefetched->size() / prefetched->capacity() : 0;
+}
+
+void FfmpegPopenMedia::reader_loop()
+{
+	// large reads keep the number of syscalls per frame low
+	constexpr size_t block_bytes = 1 << 16;
+
+	const auto fd = fileno(audio);
+
+	// bytes of an incomplete sample at the start of the write region, committed once the rest arrives
+	size_t partial_bytes{};
+
+#ifdef _WIN32
+	reader_thread_id = GetCurrentThreadId();
+#endif
+
+	while (!stop_reader)
+	{
+		const auto seen = render_events.load();
+		const auto region = prefetched->write_region();
+		if (region.empty())
+		{
+			// full: wait for the renderer to consume something
+			render_events.wait(seen);
+			continue;
+		}
+
+#ifdef _WIN32
+		const auto bytes = _read(
+			fd,
+			(char *)region.data() + partial_bytes,
+			(unsigned)std::min(region.size_bytes() - partial_bytes, block_bytes));
+#else
+		// wake up regularly to notice `stop_reader` even if ffmpeg stalls
+		pollfd pfd{fd, POLLIN, 0};
+		if (poll(&pfd, 1, 100) == 0)
+			continue;
+		const auto bytes =
+			read(fd, (char *)region.data() + partial_bytes, std::min(region.size_bytes() - partial_bytes, block_bytes));
+#endif
+		if (bytes < 0)
+		{
+			// a cancelled read fails too
+			if (errno == EINTR || stop_reader)
+				continue;
+			perror("[FfmpegPopenMedia::reader_loop] read");
+			break;
+		}
+		if (!bytes)
+			break;
+
+		partial_bytes += bytes;
+		prefetched->commit(partial_bytes / sizeof(float));
+		partial_bytes %= sizeof(float);
+		++reader_events;
+		reader_events.notify_one();
+	}
+
+#ifdef _WIN32
+	// thread ids are reused once the thread is joined
+	reader_thread_id = 0;
+#endif
+	reader_done = true;
+	++reader_events;
+	reader_events.notify_one();
+}
+
 size_t FfmpegPopenMedia::read_audio_samples(float *const buf, const int samples)
 {
 	if (!audio)
 		throw std::logic_error{"[FfmpegPopenMedia::read_audio_samples] no audio stream"};
-	return fread(buf, sizeof(float), samples, audio);
+	audio_read = true;
+
+	if (!prefetched)
+		return fread(buf, sizeof(float), samples, audio);
+
+	for (bool waited{};;)
+	{
+		// everything the reader committed before finishing is visible once `reader_done` is
+		const auto seen = reader_events.load();
+		const bool done = reader_done;
+		const auto available = prefetched->read_region();
+		if (available.size())
+		{
+			const auto count = std::min(available.size(), (size_t)samples);
+			std::copy_n(available.begin(), count, buf);
+			prefetched->consume(count);
+			++render_events;
+			render_events.notify_one();
+			return count;
+		}
+		if (done)
+			return 0;
+
+		if (!waited && prefetch_primed)
+			++underruns;
+		waited = true;
+		reader_events.wait(seen);
+	}
+}
+
+std::optional<std::span<const float>> FfmpegPopenMedia::read_audio(const int frames)
+{
+	const auto audio = Media::read_audio(frames);
+	prefetch_primed = (bool)prefetched;
+	return audio;
 }
 
 bool FfmpegPopenMedia::read_video_frame(std::vector<std::byte> &buf)
@@ -0,0 +1,432 @@
+#if defined(LIBAVZ_MEDIA_LIBAV)
+
+#include <avz/media/LibavMedia.hpp>
+
+#include <cmath>
+#include <iostream>
+#include <span>
+#include <stdexcept>
+
+extern "C"
+{
+#include <libavutil/channel_layout.h>
+#include <libavutil/opt.h>
+}
+
+namespace avz
+{
+
+namespace
+{
+
+std::string error_string(const int err)
+{
+	char buf[AV_ERROR_MAX_STRING_SIZE];
+	av_strerror(err, buf, sizeof(buf));
+	return buf;
+}
+
+// `layout`, or the default layout for its channel count if it has no channel order (e.g. some .wav files);
+// uninit the result
+AVChannelLayout ordered_layout(const AVChannelLayout &layout)
+{
+	AVChannelLayout ordered{};
+	if (layout.order == AV_CHANNEL_ORDER_UNSPEC)
+		av_channel_layout_default(&ordered, layout.nb_channels);
+	else
+		av_channel_layout_copy(&ordered, &layout);
+	return ordered;
+}
+
+} // namespace
+
+LibavMedia::LibavMedia(
+	const std::string &url, const unsigned scaled_width, const unsigned scaled_height, const float start_time_sec)
+	: Media{url},
+	  audio_frame{av_frame_alloc()},
+	  video_frame{av_frame_alloc()},
+	  scaled_width{scaled_width},
+	  scaled_height{scaled_height}
+{
+	if (!audio_frame || !video_frame)
+		throw std::bad_alloc{};
+
+	AVDictionary *options{};
+	if (url.contains("http"))
+	{
+		avformat_network_init();
+		av_dict_set(&options, "reconnect", "1", 0);
+	}
+
+	AVFormatContext *ctx{};
+	const auto opened = avformat_open_input(&ctx, url.c_str(), nullptr, &options);
+	av_dict_free(&options);
+	if (opened < 0)
+		throw std::runtime_error{"[LibavMedia] avformat_open_input: " + error_string(opened)};
+	format.reset(ctx);
+
+	if (const auto err = avformat_find_stream_info(ctx, nullptr); err < 0)
+		throw std::runtime_error{"[LibavMedia] avformat_find_stream_info: " + error_string(err)};
+
+	for (const auto stream : std::span{ctx->streams, ctx->nb_streams})
+	{
+		if (stream->disposition & AV_DISPOSITION_ATTACHED_PIC)
+		{
+			// only the cover art, no need to decode it
+			if (!_attached_pic)
+			{
+				const auto data = (const std::byte *)stream->attached_pic.data;
+				_attached_pic.emplace(data, data + stream->attached_pic.size);
+			}
+			continue;
+		}
+		if (stream->codecpar->codec_type == AVMEDIA_TYPE_VIDEO && !video_stream)
+			video_stream = stream;
+	}
+
+	const auto audio_index = av_find_best_stream(ctx, AVMEDIA_TYPE_AUDIO, -1, -1, nullptr, 0);
+	if (audio_index < 0)
+		// fatal error: audio visualizers need audio...
+		throw std::runtime_error{"[LibavMedia] av_find_best_stream: " + error_string(audio_index)};
+	audio_stream = ctx->streams[audio_index];
+	audio_decoder = open_decoder(audio_stream);
+
+	if (video_stream && scaled_width && scaled_height)
+	{
+		try
+		{
+			video_decoder = open_decoder(video_stream);
+		}
+		catch (const std::runtime_error &e)
+		{
+			// non-fatal error, we can continue without video
+			std::cerr << e.what() << '\n';
+		}
+	}
+
+	// don't demux streams we won't decode
+	for (const auto stream : std::span{ctx->streams, ctx->nb_streams})
+		if (stream != audio_stream && !(video_decoder && stream == video_stream))
+			stream->discard = AVDISCARD_ALL;
+
+	if (start_time_sec != 0)
+		seek(start_time_sec);
+}
+
+LibavMedia::LibavMedia(const std::string &url, const float start_time_sec)
+	: LibavMedia{url, 0, 0, start_time_sec}
+{
+}
+
+LibavMedia::Ptr<AVCodecContext, avcodec_free_context> LibavMedia::open_decoder(const AVStream *const stream)
+{
+	const auto codec = avcodec_find_decoder(stream->codecpar->codec_id);
+	if (!codec)
+		throw std::runtime_error{
+			std::string{"[LibavMedia] no decoder for codec "} + avcodec_get_name(stream->codecpar->codec_id)};
+
+	Ptr<AVCodecContext, avcodec_free_context> decoder{avcodec_alloc_context3(codec)};
+	if (!decoder)
+		throw std::bad_alloc{};
+	if (const auto err = avcodec_parameters_to_context(decoder.get(), stream->codecpar); err < 0)
+		throw std::runtime_error{"[LibavMedia] avcodec_parameters_to_context: " + error_string(err)};
+	decoder->pkt_timebase = stream->time_base;
+	if (const auto err = avcodec_open2(decoder.get(), codec, nullptr); err < 0)
+		throw std::runtime_error{"[LibavMedia] avcodec_open2: " + error_string(err)};
+	return decoder;
+}
+
+LibavMedia::Ptr<AVPacket, av_packet_free> LibavMedia::next_packet(const AVStream *const stream)
+{
+	auto &queue = stream == audio_stream ? audio_packets : video_packets;
+	if (queue.size())
+	{
+		auto packet = std::move(queue.front());
+		queue.pop_front();
+		return packet;
+	}
+
+	while (!demuxer_eof)
+	{
+		Ptr<AVPacket, av_packet_free> packet{av_packet_alloc()};
+		if (!packet)
+			throw std::bad_alloc{};
+
+		if (const auto err = av_read_frame(format.get(), packet.get()); err < 0)
+		{
+			// treat read errors like the end of the media, as ffmpeg exiting does for FfmpegPopenMedia
+			if (err != AVERROR_EOF)
+				std::cerr << "[LibavMedia] av_read_frame: " << error_string(err) << '\n';
+			demuxer_eof = true;
+			break;
+		}
+
+		if (packet->stream_index == stream->index)
+			return packet;
+		if (packet->stream_index == audio_stream->index)
+			audio_packets.emplace_back(std::move(packet));
+		else if (video_decoder && packet->stream_index == video_stream->index)
+			video_packets.emplace_back(std::move(packet));
+	}
+
+	return {};
+}
+
+bool LibavMedia::decode_frame(
+	AVCodecContext *const decoder, const AVStream *const stream, AVFrame *const frame, bool &flushed)
+{
+	while (true)
+	{
+		const auto err = avcodec_receive_frame(decoder, frame);
+		if (!err)
+			return true;
+		if (err == AVERROR_EOF || (err == AVERROR(EAGAIN) && flushed))
+			return false;
+		if (err != AVERROR(EAGAIN))
+			throw std::runtime_error{"[LibavMedia] avcodec_receive_frame: " + error_string(err)};
+
+		// a null packet drains the decoder at the end of the media
+		const auto packet = next_packet(stream);
+		flushed = !packet;
+		switch (const auto sent = avcodec_send_packet(decoder, packet.get()))
+		{
+		case 0:
+		case AVERROR_EOF:
+			break;
+		case AVERROR_INVALIDDATA:
+			// skip the corrupt packet, like the ffmpeg cli does
+			std::cerr << "[LibavMedia] avcodec_send_packet: " << error_string(sent) << '\n';
+			break;
+		default:
+			throw std::runtime_error{"[LibavMedia] avcodec_send_packet: " + error_string(sent)};
+		}
+	}
+}
+
+bool LibavMedia::skip_audio_before_seek()
+{
+	const auto frame = audio_frame.get();
+	if (audio_skip_until == AV_NOPTS_VALUE || frame->best_effort_timestamp == AV_NOPTS_VALUE)
+	{
+		audio_skip_until = AV_NOPTS_VALUE;
+		return false;
+	}
+
+	const auto skip = av_rescale_q(
+		audio_skip_until - frame->best_effort_timestamp, audio_stream->time_base, {1, frame->sample_rate});
+	if (skip >= frame->nb_samples)
+		// the whole frame is before the seek target
+		return true;
+	audio_skip_until = AV_NOPTS_VALUE;
+	if (skip <= 0)
+		return false;
+
+	// move the start of the frame's data forward to the seek target
+	const auto sample_format = (AVSampleFormat)frame->format;
+	const auto planar = av_sample_fmt_is_planar(sample_format);
+	const auto channels = frame->ch_layout.nb_channels;
+	const auto bytes = skip * av_get_bytes_per_sample(sample_format) * (planar ? 1 : channels);
+	for (int i = 0; i < (planar ? channels : 1); ++i)
+		frame->extended_data[i] += bytes;
+	frame->nb_samples -= skip;
+	return false;
+}
+
+void LibavMedia::init_resampler()
+{
+	const auto frame = audio_frame.get();
+
+	// output what audio_sample_rate() and audio_channels() report
+	auto out_layout = ordered_layout(audio_stream->codecpar->ch_layout);
+	auto in_layout = ordered_layout(frame->ch_layout);
+
+	SwrContext *swr{};
+	auto err = swr_alloc_set_opts2(
+		&swr,
+		&out_layout,
+		AV_SAMPLE_FMT_FLT,
+		audio_sample_rate(),
+		&in_layout,
+		(AVSampleFormat)frame->format,
+		frame->sample_rate,
+		0,
+		nullptr);
+	av_channel_layout_uninit(&out_layout);
+	av_channel_layout_uninit(&in_layout);
+	resampler.reset(swr);
+	if (err < 0 || (err = swr_init(swr)) < 0)
+		throw std::runtime_error{"[LibavMedia] swr_init: " + error_string(err)};
+}
+
+bool LibavMedia::resampler_accepts_frame() const
+{
+	const auto frame = audio_frame.get();
+	int64_t format{}, rate{};
+	AVChannelLayout layout{};
+	av_opt_get_int(resampler.get(), "in_sample_fmt", 0, &format);
+	av_opt_get_int(resampler.get(), "in_sample_rate", 0, &rate);
+	av_opt_get_chlayout(resampler.get(), "in_chlayout", 0, &layout);
+	auto frame_layout = ordered_layout(frame->ch_layout);
+	const auto accepts =
+		format == frame->format && rate == frame->sample_rate && !av_channel_layout_compare(&layout, &frame_layout);
+	av_channel_layout_uninit(&layout);
+	av_channel_layout_uninit(&frame_layout);
+	return accepts;
+}
+
+size_t LibavMedia::read_audio_samples(float *const buf, const int samples)
+{
+	const auto channels = audio_channels();
+	const auto frames = samples / channels;
+	const auto out = [&](const int done) { return (uint8_t *)(buf + done * channels); };
+
+	int done{};
+	if (resampler)
+	{
+		// first output what the resampler kept from the last frame; a non-null input with no samples doesn't flush it
+		const uint8_t *const no_input[1]{};
+		uint8_t *dst = out(done);
+		done += std::max(0, swr_convert(resampler.get(), &dst, frames, (const uint8_t **)no_input, 0));
+	}
+
+	while (done < frames)
+	{
+		if (!audio_frame_pending)
+		{
+			if (!decode_frame(audio_decoder.get(), audio_stream, audio_frame.get(), audio_flushed))
+			{
+				// end of the media: output whatever the resampler is still holding
+				if (resampler)
+				{
+					uint8_t *dst = out(done);
+					done += std::max(0, swr_convert(resampler.get(), &dst, frames - done, nullptr, 0));
+				}
+				break;
+			}
+			if (skip_audio_before_seek())
+				continue;
+		}
+		audio_frame_pending = false;
+
+		if (resampler && !resampler_accepts_frame())
+		{
+			// the format, rate or layout changed mid-stream (e.g. chained ogg, adts with sbr): flush the old
+			// resampler first, keeping the frame for the next call if its output fills the caller's buffer
+			uint8_t *dst = out(done);
+			const auto room = frames - done;
+			const auto flushed = std::max(0, swr_convert(resampler.get(), &dst, room, nullptr, 0));
+			done += flushed;
+			if (flushed == room)
+			{
+				audio_frame_pending = true;
+				break;
+			}
+			resampler.reset();
+		}
+		if (!resampler)
+			init_resampler();
+
+		// convert straight into the caller's buffer; what doesn't fit stays in the resampler
+		uint8_t *dst = out(done);
+		const auto converted = swr_convert(
+			resampler.get(),
+			&dst,
+			frames - done,
+			(const uint8_t **)audio_frame->extended_data,
+			audio_frame->nb_samples);
+		if (converted < 0)
+			throw std::runtime_error{"[LibavMedia] swr_convert: " + error_string(converted)};
+		done += converted;
+	}
+
+	return done * channels;
+}
+
+bool LibavMedia::read_video_frame(std::vector<std::byte> &buf)
+{
+	if (!video_decoder)
+		throw std::logic_error{"[LibavMedia::read_video_frame] no video stream available!"};
+
+	const auto frame = video_frame.get();
+	do
+		if (!decode_frame(video_decoder.get(), video_stream, frame, video_flushed))
+			return false;
+	while (video_skip_until != AV_NOPTS_VALUE && frame->best_effort_timestamp != AV_NOPTS_VALUE &&
+		   frame->best_effort_timestamp < video_skip_until);
+	video_skip_until = AV_NOPTS_VALUE;
+
+	scaler.reset(sws_getCachedContext(
+		scaler.release(),
+		frame->width,
+		frame->height,
+		(AVPixelFormat)frame->format,
+		scaled_width,
+		scaled_height,
+		AV_PIX_FMT_RGBA,
+		SWS_BILINEAR,
+		nullptr,
+		nullptr,
+		nullptr));
+	if (!scaler)
+		throw std::runtime_error{"[LibavMedia::read_video_frame] sws_getCachedContext failed"};
+
+	buf.resize(4 * scaled_width * scaled_height);
+	uint8_t *const dst[4]{(uint8_t *)buf.data()};
+	const int dst_stride[4]{(int)(4 * scaled_width)};
+	sws_scale(scaler.get(), frame->data, frame->linesize, 0, frame->height, dst, dst_stride);
+	return true;
+}
+
+void LibavMedia::seek_source(const double seconds)
+{
+	// `seconds` from the start of each stream, in its own time base
+	const auto stream_target = [&](const AVStream *const stream)
+	{
+		auto target =
+			av_rescale_q(std::llround(seconds * AV_TIME_BASE), AVRational{1, AV_TIME_BASE}, stream->time_base);
+		if (stream->start_time != AV_NOPTS_VALUE)
+			target += stream->start_time;
+		return target;
+	};
+	const auto target = stream_target(audio_stream);
+
+	// land on the last keyframe at or before the target, then decode up to it
+	if (const auto err = avformat_seek_file(format.get(), audio_stream->index, INT64_MIN, target, target, 0); err < 0)
+		throw std::runtime_error{"[LibavMedia::seek_source] avformat_seek_file: " + error_string(err)};
+
+	audio_packets.clear();
+	video_packets.clear();
+	demuxer_eof = audio_flushed = video_flushed = false;
+
+	avcodec_flush_buffers(audio_decoder.get());
+	resampler.reset();
+	audio_frame_pending = false;
+	audio_skip_until = target;
+
+	if (video_decoder)
+	{
+		avcodec_flush_buffers(video_decoder.get());
+		video_skip_until = stream_target(video_stream);
+	}
+}
+
+int LibavMedia::video_framerate() const
+{
+	if (!video_stream)
+		return 0;
+	const auto rate = av_guess_frame_rate(format.get(), video_stream, nullptr);
+	return rate.den ? std::lround(av_q2d(rate)) : 0;
+}
+
+std::string LibavMedia::tag(const char *const key) const
+{
+	// container tags first (mp3, mp4, ...), then stream tags (ogg, opus, ...)
+	for (const auto metadata : {format->metadata, audio_stream->metadata})
+		if (const auto entry = av_dict_get(metadata, key, nullptr, 0))
+			return entry->value;
+	return {};
+}
+
+} // namespace avz
+
+#endif
@@ -0,0 +1,480 @@
+#include "util.hpp"
+#include <avz/media/FfmpegPopenMedia.hpp>
+#include <avz/media/FfprobeMetadata.hpp>
+#include <avz/media/MappedPcmMedia.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string_view>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace avz
+{
+
+namespace
+{
+
+// wav files are little-endian, like every platform we build for; memcpy since header fields aren't aligned
+template <typename T>
+T read_le(const std::byte *const p)
+{
+	T value;
+	std::memcpy(&value, p, sizeof(T));
+	return value;
+}
+
+std::string_view chunk_id(const std::byte *const p)
+{
+	return {(const char *)p, 4};
+}
+
+constexpr uint16_t wave_format_ieee_float = 3, wave_format_extensible = 0xFFFE;
+
+#ifdef _WIN32
+
+std::pair<const std::byte *, size_t> map_file(const std::filesystem::path &path)
+{
+	const auto file = CreateFileW(
+		path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		throw std::runtime_error{"[MappedPcmMedia] CreateFile: error " + std::to_string(GetLastError())};
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size))
+	{
+		const auto error = GetLastError();
+		CloseHandle(file);
+		throw std::runtime_error{"[MappedPcmMedia] GetFileSizeEx: error " + std::to_string(error)};
+	}
+	if (!size.QuadPart)
+	{
+		// empty files can't be mapped
+		CloseHandle(file);
+		return {};
+	}
+
+	const auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	const auto error = GetLastError();
+	CloseHandle(file);
+	if (!mapping)
+		throw std::runtime_error{"[MappedPcmMedia] CreateFileMapping: error " + std::to_string(error)};
+
+	// the view keeps the mapping alive
+	const auto view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	const auto view_error = GetLastError();
+	CloseHandle(mapping);
+	if (!view)
+		throw std::runtime_error{"[MappedPcmMedia] MapViewOfFile: error " + std::to_string(view_error)};
+	return {(const std::byte *)view, (size_t)size.QuadPart};
+}
+
+void unmap_file(const std::byte *const data, size_t)
+{
+	if (data)
+		UnmapViewOfFile(data);
+}
+
+#else
+
+std::pair<const std::byte *, size_t> map_file(const std::filesystem::path &path)
+{
+	const auto fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd == -1)
+		throw std::runtime_error{"[MappedPcmMedia] open: " + path.string() + ": " + strerror(errno)};
+
+	struct stat st;
+	if (fstat(fd, &st) == -1)
+	{
+		const auto error = errno;
+		close(fd);
+		throw std::runtime_error{std::string{"[MappedPcmMedia] fstat: "} + strerror(error)};
+	}
+	if (!st.st_size)
+	{
+		// empty files can't be mapped
+		close(fd);
+		return {};
+	}
+
+	const auto data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	const auto error = errno;
+	// the mapping keeps the file open
+	close(fd);
+	if (data == MAP_FAILED)
+		throw std::runtime_error{std::string{"[MappedPcmMedia] mmap: "} + strerror(error)};
+
+	// audio is mostly read front to back, let the kernel read ahead aggressively
+	madvise(data, st.st_size, MADV_SEQUENTIAL);
+	return {(const std::byte *)data, (size_t)st.st_size};
+}
+
+void unmap_file(const std::byte *const data, const size_t size)
+{
+	if (data)
+		munmap((void *)data, size);
+}
+
+#endif
+
+// sample data starts at a multiple of 4 bytes, so the mapped samples are aligned
+constexpr size_t wav_header_size = 80;
+
+void write_wav_header(
+	std::ostream &out, const int sample_rate, const int channels, const uint64_t data_bytes, const uint64_t file_bytes)
+{
+	// plain riff can only describe 4 GiB, rf64 moves the sizes into the ds64 chunk
+	const bool rf64 = file_bytes - 8 > UINT32_MAX;
+
+	std::byte header[wav_header_size]{};
+	size_t offset{};
+	const auto id = [&](const char *const s)
+	{
+		std::memcpy(header + offset, s, 4);
+		offset += 4;
+	};
+	const auto put = [&](const auto value)
+	{
+		std::memcpy(header + offset, &value, sizeof(value));
+		offset += sizeof(value);
+	};
+
+	id(rf64 ? "RF64" : "RIFF");
+	put(rf64 ? UINT32_MAX : (uint32_t)(file_bytes - 8));
+	id("WAVE");
+
+	// a JUNK chunk reserves room for ds64
+	id(rf64 ? "ds64" : "JUNK");
+	put((uint32_t)28);
+	put((uint64_t)(file_bytes - 8));
+	put(data_bytes);
+	put((uint64_t)(data_bytes / (sizeof(float) * channels)));
+	put((uint32_t)0);
+
+	id("fmt ");
+	put((uint32_t)16);
+	put(wave_format_ieee_float);
+	put((uint16_t)channels);
+	put((uint32_t)sample_rate);
+	put((uint32_t)(sample_rate * channels * sizeof(float)));
+	put((uint16_t)(channels * sizeof(float)));
+	put((uint16_t)32);
+
+	id("data");
+	put(rf64 ? UINT32_MAX : (uint32_t)data_bytes);
+
+	out.seekp(0);
+	out.write((const char *)header, sizeof(header));
+}
+
+void write_chunk(std::ostream &out, const char *const id, const std::span<const std::byte> body)
+{
+	const uint32_t size = body.size();
+	out.write(id, 4);
+	out.write((const char *)&size, sizeof(size));
+	out.write((const char *)body.data(), size);
+	if (size & 1)
+		out.put(0);
+}
+
+void write_info_chunk(std::ostream &out, const std::string &title, const std::string &artist)
+{
+	std::vector<std::byte> info;
+	const auto append = [&](const char *const id, const std::string &value)
+	{
+		if (value.empty())
+			return;
+		// null-terminated, padded to an even size
+		const uint32_t size = value.size() + 1;
+		const auto start = info.size();
+		info.resize(start + 8 + size + (size & 1));
+		std::memcpy(info.data() + start, id, 4);
+		std::memcpy(info.data() + start + 4, &size, 4);
+		std::memcpy(info.data() + start + 8, value.data(), value.size());
+	};
+	append("INAM", title);
+	append("IART", artist);
+	if (info.empty())
+		return;
+
+	info.insert(info.begin(), {std::byte{'I'}, std::byte{'N'}, std::byte{'F'}, std::byte{'O'}});
+	write_chunk(out, "LIST", info);
+}
+
+void decode_to_wav(const std::filesystem::path &source, const std::filesystem::path &target)
+{
+	const FfprobeMetadata metadata{source.string()};
+	if (!metadata.hasAudioStream())
+		throw std::runtime_error{"[MappedPcmMedia::cache] no audio stream in " + source.string()};
+	const auto sample_rate = metadata.getAudioSampleRate();
+	const auto channels = metadata.getAudioChannels();
+
+	// written next to the target and renamed into place once complete, so an interrupted decode, or another
+	// process decoding the same file, never leaves a truncated cache file behind
+	auto partial = target;
+	partial += '.' + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + ".part";
+
+	std::ofstream out{partial, std::ios::binary};
+	if (!out)
+		throw std::runtime_error{"[MappedPcmMedia::cache] can't write " + partial.string()};
+	out.write(std::string(wav_header_size, '\0').data(), wav_header_size);
+
+	// the same decode FfmpegPopenMedia runs, written to a file instead of read by the player
+	const auto command{"ffmpeg -v warning -i \"" + source.string() + "\" -c:a pcm_f32le -f f32le -"};
+	const auto pipe = util::popen_utf8(command, POPEN_R_MODE);
+	if (!pipe)
+	{
+		out.close();
+		std::filesystem::remove(partial);
+		throw std::runtime_error{std::string{"[MappedPcmMedia::cache] popen: "} + strerror(errno)};
+	}
+
+	uint64_t data_bytes{};
+	char buf[1 << 16];
+	while (const auto bytes = fread(buf, 1, sizeof(buf), pipe))
+	{
+		out.write(buf, bytes);
+		data_bytes += bytes;
+	}
+
+	if (const auto status = pclose(pipe); status != 0 || !out)
+	{
+		out.close();
+		std::filesystem::remove(partial);
+		throw std::runtime_error{
+			"[MappedPcmMedia::cache] decoding " + source.string() + " failed: ffmpeg returned " +
+			std::to_string(status)};
+	}
+
+	if (data_bytes & 1)
+		out.put(0);
+	write_info_chunk(out, metadata.getTitle(), metadata.getArtist());
+	if (const auto pic = FfmpegPopenMedia::getAttachedPicture(source.string()))
+		write_chunk(out, "apic", *pic);
+
+	const uint64_t file_bytes = out.tellp();
+	write_wav_header(out, sample_rate, channels, data_bytes, file_bytes);
+	out.close();
+	if (!out)
+	{
+		std::filesystem::remove(partial);
+		throw std::runtime_error{"[MappedPcmMedia::cache] can't write " + partial.string()};
+	}
+
+	std::filesystem::rename(partial, target);
+}
+
+} // namespace
+
+MappedPcmMedia::MappedPcmMedia(const std::filesystem::path &path)
+	: Media{path.string()}
+{
+	map(path);
+	try
+	{
+		parse_wav();
+	}
+	catch (...)
+	{
+		unmap_file(mapping, mapping_size);
+		throw;
+	}
+}
+
+MappedPcmMedia::MappedPcmMedia(const std::filesystem::path &path, const int sample_rate, const int channels)
+	: Media{path.string()},
+	  sample_rate{sample_rate},
+	  channels{channels}
+{
+	if (sample_rate <= 0 || channels <= 0)
+		throw std::invalid_argument{"[MappedPcmMedia] sample_rate and channels must be > 0"};
+	map(path);
+	// mappings are page-aligned; drop a trailing partial frame
+	samples = {(const float *)mapping, mapping_size / sizeof(float) / channels * channels};
+}
+
+MappedPcmMedia::~MappedPcmMedia()
+{
+	unmap_file(mapping, mapping_size);
+}
+
+void MappedPcmMedia::map(const std::filesystem::path &path)
+{
+	std::tie(mapping, mapping_size) = map_file(path);
+}
+
+void MappedPcmMedia::parse_wav()
+{
+	const auto error = [&](const std::string &msg)
+	{
+		return std::runtime_error{"[MappedPcmMedia] " + url + ": " + msg};
+	};
+
+	if (mapping_size < 12 || (chunk_id(mapping) != "RIFF" && chunk_id(mapping) != "RF64") ||
+		chunk_id(mapping + 8) != "WAVE")
+		throw error("not a WAV file");
+	const bool rf64 = chunk_id(mapping) == "RF64";
+
+	uint64_t rf64_data_size{};
+	const std::byte *data{};
+	uint64_t data_size{};
+
+	for (size_t offset = 12; offset + 8 <= mapping_size;)
+	{
+		const auto id = chunk_id(mapping + offset);
+		uint64_t size = read_le<uint32_t>(mapping + offset + 4);
+		const auto body = mapping + offset + 8;
+		const auto available = mapping_size - offset - 8;
+
+		if (id == "data")
+		{
+			if (rf64 && size == UINT32_MAX)
+				size = rf64_data_size;
+			// tolerate truncated files, e.g. an interrupted recording
+			size = std::min(size, available);
+			data = body;
+			data_size = size;
+		}
+		else if (size > available)
+			break;
+		else if (id == "ds64" && size >= 16)
+			rf64_data_size = read_le<uint64_t>(body + 8);
+		else if (id == "fmt " && size >= 16)
+		{
+			auto format = read_le<uint16_t>(body);
+			channels = read_le<uint16_t>(body + 2);
+			sample_rate = read_le<uint32_t>(body + 4);
+			const auto bits = read_le<uint16_t>(body + 14);
+			// the format of WAVE_FORMAT_EXTENSIBLE is the start of its subformat guid
+			if (format == wave_format_extensible && size >= 26)
+				format = read_le<uint16_t>(body + 24);
+			if (format != wave_format_ieee_float || bits != 32)
+				throw error(
+					"samples are not 32-bit float (format " + std::to_string(format) + ", " + std::to_string(bits) +
+					" bits), open it through MappedPcmMedia::cache instead");
+		}
+		else if (id == "LIST" && size >= 4 && chunk_id(body) == "INFO")
+		{
+			for (size_t info = 4; info + 8 <= size;)
+			{
+				const auto info_id = chunk_id(body + info);
+				const auto info_size = std::min<size_t>(read_le<uint32_t>(body + info + 4), size - info - 8);
+				const auto value = (const char *)body + info + 8;
+				std::string text{value, strnlen(value, info_size)};
+				if (info_id == "INAM")
+					_title = std::move(text);
+				else if (info_id == "IART")
+					_artist = std::move(text);
+				info += 8 + info_size + (info_size & 1);
+			}
+		}
+		else if (id == "apic")
+			_attached_pic.emplace(body, body + size);
+
+		offset += 8 + size + (size & 1);
+	}
+
+	if (sample_rate <= 0 || channels <= 0)
+		throw error("no valid fmt chunk");
+	if (!data)
+		throw error("no data chunk");
+
+	const auto count = data_size / sizeof(float) / channels * channels;
+	if ((uintptr_t)data % alignof(float))
+	{
+		// chunks are only aligned to 2 bytes; files written by `cache` never get here
+		aligned_copy.resize(count);
+		std::memcpy(aligned_copy.data(), data, count * sizeof(float));
+		samples = aligned_copy;
+	}
+	else
+		samples = {(const float *)data, count};
+}
+
+std::filesystem::path MappedPcmMedia::default_cache_dir()
+{
+#ifdef _WIN32
+	if (const auto dir = _wgetenv(L"LOCALAPPDATA"); dir && *dir)
+		return std::filesystem::path{dir} / "avz";
+#else
+	if (const auto dir = getenv("XDG_CACHE_HOME"); dir && *dir)
+		return std::filesystem::path{dir} / "avz";
+	if (const auto home = getenv("HOME"); home && *home)
+		return std::filesystem::path{home} / ".cache" / "avz";
+#endif
+	return std::filesystem::temp_directory_path() / "avz";
+}
+
+std::filesystem::path MappedPcmMedia::cache(const std::filesystem::path &path, const std::filesystem::path &cache_dir)
+{
+	std::error_code ec;
+	if (!std::filesystem::is_regular_file(path, ec))
+		throw std::invalid_argument{"[MappedPcmMedia::cache] not a local file: " + path.string()};
+
+	const auto source = std::filesystem::canonical(path);
+	const auto key_string = source.string() + '|' + std::to_string(std::filesystem::file_size(source)) + '|' +
+							std::to_string(std::filesystem::last_write_time(source).time_since_epoch().count());
+
+	// fnv-1a, which unlike std::hash gives the same key in every build
+	uint64_t key = 14695981039346656037ull;
+	for (const auto c : key_string)
+	{
+		key ^= (unsigned char)c;
+		key *= 1099511628211ull;
+	}
+
+	char name[24];
+	snprintf(name, sizeof(name), "%016llx.wav", (unsigned long long)key);
+	const auto cached = cache_dir / name;
+	if (std::filesystem::exists(cached))
+		return cached;
+
+	std::filesystem::create_directories(cache_dir);
+	decode_to_wav(source, cached);
+	return cached;
+}
+
+size_t MappedPcmMedia::read_audio_samples(float *const buf, const int samples)
+{
+	const auto count = std::min((size_t)samples, this->samples.size() - position);
+	std::copy_n(this->samples.begin() + position, count, buf);
+	position += count;
+	return count;
+}
+
+bool MappedPcmMedia::read_video_frame(std::vector<std::byte> &)
+{
+	throw std::logic_error{"[MappedPcmMedia::read_video_frame] no video stream available!"};
+}
+
+std::optional<std::span<const float>> MappedPcmMedia::read_audio(const int frames)
+{
+	const size_t count = frames * channels;
+	if (position + count > samples.size())
+		return {};
+	return samples.subspan(position, count);
+}
+
+void MappedPcmMedia::consume_audio(const int frames)
+{
+	position = std::min(position + frames * channels, samples.size());
+}
+
+void MappedPcmMedia::seek_source(const double seconds)
+{
+	position = std::min((size_t)std::llround(seconds * sample_rate) * channels, samples.size());
+}
+
+} // namespace avz
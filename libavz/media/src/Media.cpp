@@ -1,5 +1,8 @@
 #include <avz/media/Media.hpp>
 
+#include <algorithm>
+#include <stdexcept>
+
 namespace avz
 {
 
@@ -10,23 +13,48 @@ Media::Media(const std::string &url)
 
 std::optional<std::span<const float>> Media::read_audio(const int frames)
 {
-	const auto samples{frames * audio_channels()};
-	while (_audio_buffer.size() < samples)
+	const size_t samples = frames * audio_channels();
+
+	if (!_audio_buffer || _audio_buffer->capacity() < samples)
+	{
+		// room for a whole window of lookahead on top of the requested window
+		auto buffer = std::make_unique<AudioRingBuffer>(2 * samples);
+		if (_audio_buffer)
+		{
+			const auto buffered = _audio_buffer->read_region();
+			std::ranges::copy(buffered, buffer->write_region().begin());
+			buffer->commit(buffered.size());
+		}
+		_audio_buffer = std::move(buffer);
+	}
+
+	// decode straight into the free space of the ring buffer
+	while (_audio_buffer->size() < samples)
 	{
-		float buf[samples];
-		const auto samples_read{read_audio_samples(buf, samples)};
+		const auto region{_audio_buffer->write_region()};
+		const auto samples_read{read_audio_samples(region.data(), samples - _audio_buffer->size())};
 		if (!samples_read)
 			return {};
-		_audio_buffer.insert(_audio_buffer.end(), buf, buf + samples_read);
+		_audio_buffer->commit(samples_read);
 	}
-	return {{_audio_buffer.data(), samples}};
+	return _audio_buffer->read_region().first(samples);
 }
 
 void Media::consume_audio(const int frames)
 {
-	const auto begin{_audio_buffer.begin()};
-	const auto samples{frames * audio_channels()};
-	_audio_buffer.erase(begin, begin + samples);
+	if (!_audio_buffer)
+		return;
+	const size_t samples = frames * audio_channels();
+	_audio_buffer->consume(std::min(samples, _audio_buffer->size()));
+}
+
+void Media::seek(const double seconds)
+{
+	if (seconds < 0)
+		throw std::invalid_argument{"[Media::seek] seconds must be >= 0"};
+	seek_source(seconds);
+	if (_audio_buffer)
+		_audio_buffer->clear();
 }
 
 } // namespace avz